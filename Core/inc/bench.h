@@ -0,0 +1,75 @@
+/*!
+    \file    bench.h
+    \brief   the header file of the benchmark firmware builds
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+/* cycle statistics of one measurement series */
+typedef struct {
+    uint32_t count;                                                    /*!< samples */
+    uint32_t min;                                                      /*!< smallest sample */
+    uint32_t max;                                                      /*!< largest sample */
+    uint64_t sum;                                                      /*!< sum of samples */
+    uint64_t sum_sq;                                                   /*!< sum of squared samples */
+} bench_stat_struct;
+
+/* clear a statistics series */
+void bench_stat_reset(bench_stat_struct *stat);
+/* add a sample in cycles */
+void bench_stat_add(bench_stat_struct *stat, uint32_t cycles);
+/* print min/mean/max/stddev/jitter in cycles and nanoseconds */
+void bench_stat_print(const char *name, const bench_stat_struct *stat);
+/* run the benchmarks selected at build time, make BENCH=<name> */
+void bench_run(void);
+
+/* interrupt latency and jitter benchmark, make BENCH=irq */
+void bench_irq_run(void);
+/* SysTick entry probe, first statement of SysTick_Handler in the irq benchmark build */
+void bench_irq_systick_probe(void);
+
+/* flash/SRAM code placement benchmark, make BENCH=fastcode */
+void bench_fastcode_run(void);
+
+/* hardware versus software CRC throughput benchmark, make BENCH=crc */
+void bench_crc_run(void);
+
+/* CPU versus DMA memory copy benchmark per SRAM bank pair, make BENCH=memcpy */
+void bench_memcpy_run(void);
+
+/* ENET Rx ring depth against drop rate and latency, make BENCH=enet */
+void bench_enet_run(void);
+
+#endif /* BENCH_H */
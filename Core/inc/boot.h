@@ -0,0 +1,55 @@
+/*!
+    \file    boot.h
+    \brief   the header file of the boot phase timestamps
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef BOOT_H
+#define BOOT_H
+
+#include <stdint.h>
+
+/* DWT->CYCCNT at the end of each boot phase, written by Reset_Handler.
+   The member order is fixed by the BOOT_STAMP indexes in startup_gd32f450_470.S */
+typedef struct {
+    uint32_t reset;                                                    /*!< cycle counter started */
+    uint32_t clock;                                                    /*!< SystemInit returned, core clock raised */
+    uint32_t copy;                                                     /*!< .fastcode, .data and .tcmram copied */
+    uint32_t zero;                                                     /*!< .bss and .tcmram_bss cleared */
+    uint32_t main;                                                     /*!< static constructors done, main() entered */
+} boot_time_struct;
+
+/* get the boot phase timestamps of the last reset */
+const boot_time_struct *boot_time_get(void);
+/* print the boot phase durations and the reset source */
+void boot_time_print(void);
+
+#endif /* BOOT_H */
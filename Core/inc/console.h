@@ -0,0 +1,69 @@
+/*!
+    \file    console.h
+    \brief   the header file of the console on EVAL_COM0
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "serial.h"
+#include <stdint.h>
+
+/* serial port behind printf and scanf */
+#define CONSOLE_PORT                     SERIAL_USART0
+
+/* console ring size in bytes, power of two */
+#ifndef CONSOLE_BUFFER_SIZE
+#define CONSOLE_BUFFER_SIZE              2048U
+#endif
+
+/* console receive DMA buffer size in bytes */
+#ifndef CONSOLE_RX_BUFFER_SIZE
+#define CONSOLE_RX_BUFFER_SIZE           256U
+#endif
+
+/* open EVAL_COM0 with a DMA transmit ring and stream mode reception */
+void console_init(void);
+/* select the full ring policy */
+void console_policy_set(serial_policy_enum policy);
+/* queue bytes for transmission, callable from any context */
+uint32_t console_write(const void *data, uint32_t len);
+/* bytes console_write() can accept right now */
+uint32_t console_free(void);
+/* wait until everything queued has left the USART, thread mode only */
+void console_flush(void);
+/* read the counters */
+void console_stat_get(serial_stat_struct *stat);
+/* copy received bytes, returns the count */
+uint32_t console_read(uint8_t *data, uint32_t len);
+
+#endif /* CONSOLE_H */
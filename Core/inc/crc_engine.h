@@ -0,0 +1,86 @@
+/*!
+    \file    crc_engine.h
+    \brief   the header file of the CRC unit service
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef CRC_ENGINE_H
+#define CRC_ENGINE_H
+
+#include "gd32f4xx.h"
+#include <stdint.h>
+
+/* result conventions, all polynomial 0x04C11DB7 with initial value 0xFFFFFFFF */
+typedef enum {
+    CRC_ENGINE_WORD = 0,                                               /*!< the unit's own order: little endian words, last word zero padded, same as crc_block_data_calculate() */
+    CRC_ENGINE_MPEG2,                                                  /*!< CRC-32/MPEG-2 over the byte stream, no reflection, no final XOR */
+    CRC_ENGINE_ZLIB                                                    /*!< CRC-32 of zlib, Ethernet and PNG, reflected with final XOR */
+} crc_engine_mode_enum;
+
+/* streaming context, one per running checksum */
+typedef struct {
+    crc_engine_mode_enum mode;                                         /*!< result convention */
+    uint32_t state;                                                    /*!< CRC_DATA value after the bytes fed so far */
+    uint32_t pending;                                                  /*!< CRC_ENGINE_WORD: bytes of the unfinished word */
+    uint32_t pending_len;                                              /*!< CRC_ENGINE_WORD: 0..3 */
+} crc_engine_ctx_struct;
+
+/* completion of crc_engine_update_async(), called from the DMA interrupt */
+typedef void (*crc_engine_callback)(void *arg, crc_engine_ctx_struct *ctx);
+
+/* service counters */
+typedef struct {
+    uint32_t hw_bytes;                                                 /*!< bytes fed by the CPU to the unit */
+    uint32_t dma_bytes;                                                /*!< bytes fed by the DMA */
+    uint32_t soft_bytes;                                               /*!< bytes computed in software while the unit was busy */
+    uint32_t async_jobs;                                               /*!< DMA jobs completed */
+    uint32_t dma_errors;                                               /*!< DMA jobs finished on the CPU after a transfer error */
+} crc_engine_stat_struct;
+
+/* enable the CRC unit and take a memory to memory DMA channel */
+void crc_engine_init(void);
+/* start a checksum */
+void crc_engine_start(crc_engine_ctx_struct *ctx, crc_engine_mode_enum mode);
+/* add bytes on the CPU, any length and alignment, callable from any context */
+void crc_engine_update(crc_engine_ctx_struct *ctx, const void *data, uint32_t len);
+/* add bytes in the background by DMA, CRC_ENGINE_WORD only */
+ErrStatus crc_engine_update_async(crc_engine_ctx_struct *ctx, const void *data, uint32_t len,
+                                  crc_engine_callback callback, void *arg);
+/* finish the checksum and return it in the mode's convention */
+uint32_t crc_engine_final(crc_engine_ctx_struct *ctx);
+/* one shot checksum on the CPU */
+uint32_t crc_engine_calculate(crc_engine_mode_enum mode, const void *data, uint32_t len);
+/* check whether a DMA job owns the unit */
+uint32_t crc_engine_busy(void);
+/* read the counters */
+void crc_engine_stat_get(crc_engine_stat_struct *stat);
+
+#endif /* CRC_ENGINE_H */
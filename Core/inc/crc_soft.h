@@ -0,0 +1,70 @@
+/*!
+    \file    crc_soft.h
+    \brief   the header file of the table driven software CRC library
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef CRC_SOFT_H
+#define CRC_SOFT_H
+
+/* plain C99 without device headers, builds for the target and natively on a
+   little endian host. crc_soft_init() must run once before any other call */
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* initial values */
+#define CRC_SOFT_ZLIB_INIT               0x00000000U                   /*!< zlib style, the complement is handled inside */
+#define CRC_SOFT_MPEG2_INIT              0xFFFFFFFFU                   /*!< register value, same as the CRC unit after reset */
+#define CRC_SOFT_CCITT_INIT              0xFFFFU                       /*!< CRC-16/CCITT-FALSE */
+#define CRC_SOFT_MODBUS_INIT             0xFFFFU                       /*!< CRC-16/MODBUS */
+
+/* build the lookup tables */
+void crc_soft_init(void);
+
+/* CRC-32 of zlib and Ethernet, one table lookup per byte; crc is the previous result */
+uint32_t crc_soft_zlib_bytewise(uint32_t crc, const void *data, size_t len);
+/* CRC-32 of zlib and Ethernet, slicing-by-4 */
+uint32_t crc_soft_zlib_slice4(uint32_t crc, const void *data, size_t len);
+/* CRC-32 of zlib and Ethernet, slicing-by-8 */
+uint32_t crc_soft_zlib_slice8(uint32_t crc, const void *data, size_t len);
+
+/* CRC-32/MPEG-2 over a byte stream, slicing-by-8; crc is the register value */
+uint32_t crc_soft_mpeg2(uint32_t crc, const void *data, size_t len);
+/* the CRC unit's own order: little endian words fed to CRC_DATA, slicing-by-8 */
+uint32_t crc_soft_word(uint32_t crc, const void *data, size_t words);
+
+/* CRC-16/CCITT-FALSE, polynomial 0x1021, not reflected */
+uint16_t crc_soft_ccitt(uint16_t crc, const void *data, size_t len);
+/* CRC-16/MODBUS, polynomial 0x8005 reflected */
+uint16_t crc_soft_modbus(uint16_t crc, const void *data, size_t len);
+
+#endif /* CRC_SOFT_H */
@@ -0,0 +1,101 @@
+/*!
+    \file    dlog.h
+    \brief   the header file of the deferred binary logger
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef DLOG_H
+#define DLOG_H
+
+#include <stdint.h>
+
+/* deferred log ring size in bytes, power of two */
+#ifndef DLOG_BUFFER_SIZE
+#define DLOG_BUFFER_SIZE                 1024U
+#endif
+
+/* argument words per record */
+#define DLOG_MAX_ARGS                    8U
+
+/* record layout, little endian words:
+   word 0  bits 0-7 sync 0x00, bits 8-15 argument count, bits 16-31 sequence number
+   word 1  format string id, its offset in the .dlog_fmt ELF section
+   word 2  DWT->CYCCNT
+   word 3+ arguments
+   printf text never contains 0x00, so scripts/dlog_decode.py can split a mixed stream */
+#define DLOG_SYNC                        0x00U
+
+/* log counters */
+typedef struct {
+    uint32_t records;                                                  /*!< records queued */
+    uint32_t dropped;                                                  /*!< records lost because the ring was full */
+} dlog_stat_struct;
+
+/*!
+    \brief    log a message with up to DLOG_MAX_ARGS 32-bit arguments
+    \note      the format string is stored only in the ELF, the record carries its id.
+                Arguments are integers, characters, pointers, DLOG_FLOAT() values and
+                %s strings that live in flash, scripts/dlog_decode.py reads them from the ELF
+*/
+#define DLOG(fmt, ...)                                                                    \
+    do {                                                                                  \
+        static const char dlog_fmt_[] __attribute__((section(".dlog_fmt"), used)) = fmt;  \
+        dlog_write((uint32_t)dlog_fmt_, DLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__);          \
+    } while(0)
+
+/* number of macro arguments, 0 to 8 */
+#define DLOG_NARGS(...)                  DLOG_NARGS_(0, ##__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define DLOG_NARGS_(z, a1, a2, a3, a4, a5, a6, a7, a8, n, ...) n
+
+/* pass a float through its bit pattern, printed by %f, %e and %g */
+#define DLOG_FLOAT(x)                    dlog_float_bits(x)
+
+static inline uint32_t dlog_float_bits(float value)
+{
+    union {
+        float f;
+        uint32_t u;
+    } bits;
+
+    bits.f = value;
+    return bits.u;
+}
+
+/* initialize the log ring */
+void dlog_init(void);
+/* queue one record, use the DLOG() macro */
+void dlog_write(uint32_t id, uint32_t nargs, ...);
+/* move queued records to the console, returns bytes moved */
+uint32_t dlog_drain(void);
+/* read the counters */
+void dlog_stat_get(dlog_stat_struct *stat);
+
+#endif /* DLOG_H */
@@ -0,0 +1,107 @@
+/*!
+    \file    dma_copy.h
+    \brief   the header file of the asynchronous DMA memory copy and fill engine
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef DMA_COPY_H
+#define DMA_COPY_H
+
+#include "gd32f4xx.h"
+#include <stdint.h>
+
+/* CPU/DMA crossover used until dma_copy_init() has measured it */
+#ifndef DMA_COPY_CROSSOVER_DEFAULT
+#define DMA_COPY_CROSSOVER_DEFAULT       256U
+#endif
+/* smallest request the DMA takes, the CPU aligns up to 15 bytes at each end */
+#define DMA_COPY_MIN                     32U
+
+/* request state */
+typedef enum {
+    DMA_COPY_IDLE = 0,                                                 /*!< never submitted */
+    DMA_COPY_QUEUED,                                                   /*!< waiting for the channel */
+    DMA_COPY_RUNNING,                                                  /*!< owned by the DMA */
+    DMA_COPY_DONE                                                      /*!< finished, the request can be reused */
+} dma_copy_status_enum;
+
+struct dma_copy_req_struct;
+
+/* completion, called from the DMA interrupt or, for requests done on the CPU, from the submitter */
+typedef void (*dma_copy_callback)(void *arg, struct dma_copy_req_struct *req);
+
+/* copy or fill request, zeroed before first use, owned by the engine while queued or running */
+typedef struct dma_copy_req_struct {
+    struct dma_copy_req_struct *next;                                  /*!< queue link */
+    uint8_t *dst;                                                      /*!< destination, SRAM */
+    const uint8_t *src;                                                /*!< source, SRAM or flash, NULL for a fill */
+    uint32_t len;                                                      /*!< byte count */
+    uint32_t value;                                                    /*!< fill byte repeated in every byte lane */
+    dma_copy_callback callback;                                        /*!< completion, NULL to poll */
+    void *arg;                                                         /*!< callback argument */
+    uint32_t pos;                                                      /*!< DMA progress, bytes from dst */
+    uint32_t end;                                                      /*!< end of the part moved by DMA */
+    uint32_t chunk;                                                    /*!< bytes of the running transfer */
+    volatile uint32_t status;                                          /*!< dma_copy_status_enum */
+} dma_copy_req_struct;
+
+/* engine counters */
+typedef struct {
+    uint32_t cpu_jobs;                                                 /*!< requests done on the CPU */
+    uint32_t cpu_bytes;                                                /*!< bytes moved by the CPU, including DMA head and tail */
+    uint32_t dma_jobs;                                                 /*!< requests done by the DMA */
+    uint32_t dma_bytes;                                                /*!< bytes moved by the DMA */
+    uint32_t dma_errors;                                               /*!< transfer errors, finished on the CPU */
+    uint32_t queue_high_water;                                         /*!< most requests waiting at once */
+} dma_copy_stat_struct;
+
+/* take a memory to memory channel and measure the CPU/DMA crossover */
+void dma_copy_init(void);
+/* copy len bytes in the background, small requests complete on the CPU before returning */
+ErrStatus dma_copy_memcpy_async(dma_copy_req_struct *req, void *dst, const void *src, uint32_t len,
+                                dma_copy_callback callback, void *arg);
+/* fill len bytes in the background, small requests complete on the CPU before returning */
+ErrStatus dma_copy_memset_async(dma_copy_req_struct *req, void *dst, uint8_t value, uint32_t len,
+                                dma_copy_callback callback, void *arg);
+/* check whether a request has finished */
+uint32_t dma_copy_done(const dma_copy_req_struct *req);
+/* wait for a request, thread mode with interrupts enabled only */
+void dma_copy_wait(const dma_copy_req_struct *req);
+/* blocking copy that takes the DMA above the crossover when called from thread mode */
+void *dma_copy_memcpy(void *dst, const void *src, uint32_t len);
+/* override the crossover in bytes */
+void dma_copy_crossover_set(uint32_t bytes);
+/* current crossover in bytes */
+uint32_t dma_copy_crossover_get(void);
+/* read the counters */
+void dma_copy_stat_get(dma_copy_stat_struct *stat);
+
+#endif /* DMA_COPY_H */
@@ -0,0 +1,135 @@
+/*!
+    \file    dma_mgr.h
+    \brief   the header file of the DMA channel manager
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef DMA_MGR_H
+#define DMA_MGR_H
+
+#include "gd32f4xx.h"
+#include <stdint.h>
+
+/* flags passed to the completion callback, DMA_INT_FLAG_x of the channel */
+#define DMA_MGR_FLAGS                    (DMA_INT_FLAG_FEE | DMA_INT_FLAG_SDE | DMA_INT_FLAG_TAE | \
+                                          DMA_INT_FLAG_HTF | DMA_INT_FLAG_FTF)
+
+/* DMA requests, the routing table in dma_mgr.c lists the channels serving each */
+typedef enum {
+    DMA_MGR_MEMORY = 0,                                                /*!< memory to memory, any DMA1 channel */
+    DMA_MGR_USART0_TX,                                                 /*!< USART0 transmit */
+    DMA_MGR_USART0_RX,                                                 /*!< USART0 receive */
+    DMA_MGR_USART1_TX,                                                 /*!< USART1 transmit */
+    DMA_MGR_USART1_RX,                                                 /*!< USART1 receive */
+    DMA_MGR_USART2_TX,                                                 /*!< USART2 transmit */
+    DMA_MGR_USART2_RX,                                                 /*!< USART2 receive */
+    DMA_MGR_UART3_TX,                                                  /*!< UART3 transmit */
+    DMA_MGR_UART3_RX,                                                  /*!< UART3 receive */
+    DMA_MGR_UART4_TX,                                                  /*!< UART4 transmit */
+    DMA_MGR_UART4_RX,                                                  /*!< UART4 receive */
+    DMA_MGR_USART5_TX,                                                 /*!< USART5 transmit */
+    DMA_MGR_USART5_RX,                                                 /*!< USART5 receive */
+    DMA_MGR_UART6_TX,                                                  /*!< UART6 transmit */
+    DMA_MGR_UART6_RX,                                                  /*!< UART6 receive */
+    DMA_MGR_UART7_TX,                                                  /*!< UART7 transmit */
+    DMA_MGR_UART7_RX,                                                  /*!< UART7 receive */
+    DMA_MGR_SPI0_TX,                                                   /*!< SPI0 transmit */
+    DMA_MGR_SPI0_RX,                                                   /*!< SPI0 receive */
+    DMA_MGR_SPI1_TX,                                                   /*!< SPI1/I2S1 transmit */
+    DMA_MGR_SPI1_RX,                                                   /*!< SPI1/I2S1 receive */
+    DMA_MGR_SPI2_TX,                                                   /*!< SPI2/I2S2 transmit */
+    DMA_MGR_SPI2_RX,                                                   /*!< SPI2/I2S2 receive */
+    DMA_MGR_SPI3_TX,                                                   /*!< SPI3 transmit */
+    DMA_MGR_SPI3_RX,                                                   /*!< SPI3 receive */
+    DMA_MGR_SPI4_TX,                                                   /*!< SPI4 transmit */
+    DMA_MGR_SPI4_RX,                                                   /*!< SPI4 receive */
+    DMA_MGR_SPI5_TX,                                                   /*!< SPI5 transmit */
+    DMA_MGR_SPI5_RX,                                                   /*!< SPI5 receive */
+    DMA_MGR_I2C0_TX,                                                   /*!< I2C0 transmit */
+    DMA_MGR_I2C0_RX,                                                   /*!< I2C0 receive */
+    DMA_MGR_I2C1_TX,                                                   /*!< I2C1 transmit */
+    DMA_MGR_I2C1_RX,                                                   /*!< I2C1 receive */
+    DMA_MGR_I2C2_TX,                                                   /*!< I2C2 transmit */
+    DMA_MGR_I2C2_RX,                                                   /*!< I2C2 receive */
+    DMA_MGR_ADC0,                                                      /*!< ADC0 regular data */
+    DMA_MGR_ADC1,                                                      /*!< ADC1 regular data */
+    DMA_MGR_ADC2,                                                      /*!< ADC2 regular data */
+    DMA_MGR_DAC0,                                                      /*!< DAC output 0 */
+    DMA_MGR_DAC1,                                                      /*!< DAC output 1 */
+    DMA_MGR_SDIO,                                                      /*!< SDIO data */
+    DMA_MGR_DCI,                                                       /*!< digital camera interface */
+    DMA_MGR_TIMER0_UP,                                                 /*!< TIMER0 update */
+    DMA_MGR_TIMER1_UP,                                                 /*!< TIMER1 update */
+    DMA_MGR_TIMER2_UP,                                                 /*!< TIMER2 update */
+    DMA_MGR_TIMER3_UP,                                                 /*!< TIMER3 update */
+    DMA_MGR_TIMER4_UP,                                                 /*!< TIMER4 update */
+    DMA_MGR_TIMER5_UP,                                                 /*!< TIMER5 update */
+    DMA_MGR_TIMER6_UP,                                                 /*!< TIMER6 update */
+    DMA_MGR_TIMER7_UP,                                                 /*!< TIMER7 update */
+    DMA_MGR_REQUEST_NUM
+} dma_mgr_request_enum;
+
+/* transfer event, called from the DMA interrupt with the flags already cleared */
+typedef void (*dma_mgr_callback)(void *arg, uint32_t flags);
+
+/* allocated channel */
+typedef struct {
+    uint32_t dma_periph;                                               /*!< DMA0 or DMA1 */
+    dma_channel_enum channel;                                          /*!< DMA_CHx(x=0..7) */
+    dma_subperipheral_enum subperi;                                    /*!< request multiplexer setting */
+    dma_mgr_request_enum request;                                      /*!< request served, DMA_MGR_REQUEST_NUM when not allocated */
+} dma_mgr_channel_struct;
+
+/* per-channel counters, kept across allocations */
+typedef struct {
+    uint32_t allocs;                                                   /*!< times the channel was handed out */
+    uint32_t conflicts;                                                /*!< allocations that failed because the channel was taken */
+    uint32_t irqs;                                                     /*!< interrupts dispatched */
+    uint32_t transfers;                                                /*!< full transfer finish events */
+    uint32_t half_transfers;                                           /*!< half transfer finish events */
+    uint32_t errors;                                                   /*!< transfer access and single data mode errors */
+    uint32_t fifo_errors;                                              /*!< FIFO error and exception events */
+    uint32_t unclaimed;                                                /*!< interrupts of a channel nobody owns */
+} dma_mgr_stat_struct;
+
+/* take a free channel serving the request and route its interrupt to the callback */
+ErrStatus dma_mgr_alloc(dma_mgr_request_enum request, dma_mgr_callback callback, void *arg,
+                        uint8_t irq_priority, dma_mgr_channel_struct *ch);
+/* stop the channel and give it back */
+void dma_mgr_free(dma_mgr_channel_struct *ch);
+/* request owning a channel, DMA_MGR_REQUEST_NUM when free */
+dma_mgr_request_enum dma_mgr_owner_get(uint32_t dma_periph, dma_channel_enum channel);
+/* read the counters of a channel */
+void dma_mgr_stat_get(uint32_t dma_periph, dma_channel_enum channel, dma_mgr_stat_struct *stat);
+/* DMA channel interrupt, called from every DMAx_Channely_IRQHandler */
+void dma_mgr_irq(uint32_t dma_periph, dma_channel_enum channel);
+
+#endif /* DMA_MGR_H */
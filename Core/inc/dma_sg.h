@@ -0,0 +1,98 @@
+/*!
+    \file    dma_sg.h
+    \brief   the header file of the interrupt driven DMA scatter-gather
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef DMA_SG_H
+#define DMA_SG_H
+
+#include "gd32f4xx.h"
+#include "dma_mgr.h"
+#include <stdint.h>
+
+/* segment of a scatter-gather list */
+typedef struct dma_sg_desc_struct {
+    struct dma_sg_desc_struct *next;                                   /*!< next segment, NULL ends the list */
+    void *addr;                                                        /*!< memory side of the segment, SRAM or flash, not TCMRAM */
+    uint32_t count;                                                    /*!< items, 1..65535 */
+} dma_sg_desc_struct;
+
+/* list completion, called from the DMA interrupt */
+typedef void (*dma_sg_callback)(void *arg, dma_sg_desc_struct *list, ErrStatus status);
+
+/* channel description */
+typedef struct {
+    dma_mgr_request_enum request;                                      /*!< DMA request of the peripheral, e.g. DMA_MGR_SPI0_TX */
+    uint32_t periph_addr;                                              /*!< peripheral data register */
+    uint32_t periph_width;                                             /*!< DMA_PERIPH_WIDTH_x, also the item size in memory */
+    uint32_t direction;                                                /*!< DMA_MEMORY_TO_PERIPH or DMA_PERIPH_TO_MEMORY */
+    uint32_t priority;                                                 /*!< DMA_PRIORITY_x */
+    uint8_t irq_priority;                                              /*!< NVIC priority of the DMA interrupt */
+} dma_sg_config_struct;
+
+/* counters */
+typedef struct {
+    uint32_t lists;                                                    /*!< lists completed */
+    uint32_t segments;                                                 /*!< segments completed */
+    uint32_t switched;                                                 /*!< segments entered through the switch-buffer slot, no gap */
+    uint32_t restarts;                                                 /*!< segments entered by restarting the channel */
+    uint32_t errors;                                                   /*!< lists ended by a transfer access error */
+} dma_sg_stat_struct;
+
+/* scatter-gather channel */
+typedef struct {
+    dma_sg_config_struct config;                                       /*!< channel description */
+    dma_mgr_channel_struct dma;                                        /*!< allocated channel */
+    uint32_t width;                                                    /*!< bytes per item */
+    dma_sg_desc_struct *list;                                          /*!< running list */
+    dma_sg_desc_struct *active;                                        /*!< segment the DMA is on */
+    dma_sg_desc_struct *loaded;                                        /*!< segment waiting in the other switch-buffer slot, NULL in single buffer mode */
+    dma_sg_callback callback;                                          /*!< list completion */
+    void *arg;                                                         /*!< callback argument */
+    volatile uint32_t busy;                                            /*!< a list is running */
+    dma_sg_stat_struct stat;                                           /*!< counters */
+} dma_sg_struct;
+
+/* take a channel for the peripheral */
+ErrStatus dma_sg_init(dma_sg_struct *sg, const dma_sg_config_struct *config);
+/* stop and give the channel back */
+void dma_sg_deinit(dma_sg_struct *sg);
+/* start transferring a list, the caller enables the peripheral DMA request */
+ErrStatus dma_sg_start(dma_sg_struct *sg, dma_sg_desc_struct *list, dma_sg_callback callback, void *arg);
+/* check whether a list is running */
+uint32_t dma_sg_busy(const dma_sg_struct *sg);
+/* stop the running list without calling its completion */
+void dma_sg_abort(dma_sg_struct *sg);
+/* read the counters */
+void dma_sg_stat_get(const dma_sg_struct *sg, dma_sg_stat_struct *stat);
+
+#endif /* DMA_SG_H */
@@ -0,0 +1,80 @@
+/*!
+    \file    enet_poll.h
+    \brief   ENET receive with coalesced interrupts and budgeted polling
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef ENET_POLL_H
+#define ENET_POLL_H
+
+#include "gd32f4xx.h"
+#include <stdint.h>
+
+/* frame consumer, called from the poll pass in thread mode with the frame loaned from the
+   Rx ring, enet_rxframe_segments_get() lists the pieces of a frame over several descriptors.
+   The handler owns the frame and gives it back exactly once, with enet_rxframe_return(),
+   or with enet_rxframe_swap() to keep the first buffer, before it returns. A swap refused
+   for a TCMRAM buffer leaves the frame loaned, return it instead */
+typedef void (*enet_poll_handler)(void *arg, enet_rxframe_struct *frame);
+
+/* receive engine parameters */
+typedef struct {
+    uint32_t delay;                                                    /*!< RS watchdog delay in 256 HCLK units (0 - 255), 0 interrupts per frame */
+    uint32_t budget;                                                   /*!< frames handled per poll pass */
+    uint8_t irq_priority;                                              /*!< ENET interrupt preemption priority */
+    enet_poll_handler handler;                                         /*!< frame consumer */
+    void *arg;                                                         /*!< handler argument */
+} enet_poll_parameter_struct;
+
+/* receive counters */
+typedef struct {
+    uint32_t irqs;                                                     /*!< receive interrupts taken */
+    uint32_t polls;                                                    /*!< poll passes */
+    uint32_t frames;                                                   /*!< frames delivered */
+    uint32_t frames_per_poll_max;                                      /*!< most frames delivered by one pass */
+    uint32_t budget_exhausted;                                         /*!< passes that used the whole budget and stayed in polling mode */
+    uint32_t latency_max;                                              /*!< longest interrupt to poll pass, cycles */
+    uint64_t latency_total;                                            /*!< sum of interrupt to poll pass cycles, one sample per interrupt */
+    uint32_t rx_missed;                                                /*!< frames dropped by the MAC, no descriptor or Rx FIFO full */
+} enet_poll_stat_struct;
+
+/* initialize the parameter struct with default values */
+void enet_poll_struct_para_init(enet_poll_parameter_struct *para);
+/* start interrupt driven reception on an initialized and enabled ENET */
+void enet_poll_init(const enet_poll_parameter_struct *para);
+/* stop reception, frames stay in the ring */
+void enet_poll_stop(void);
+/* ENET interrupt: receive status */
+void enet_poll_irq(void);
+/* read the counters */
+void enet_poll_stat_get(enet_poll_stat_struct *stat);
+
+#endif /* ENET_POLL_H */
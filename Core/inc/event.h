@@ -0,0 +1,98 @@
+/*!
+    \file    event.h
+    \brief   the header file of the run-to-completion event scheduler
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef EVENT_H
+#define EVENT_H
+
+#include <stdint.h>
+
+/* number of event priorities, 0 is the highest */
+#define EVENT_PRIORITIES                 4U
+/* depth of each priority queue, must be a power of two */
+#define EVENT_QUEUE_SIZE                 16U
+
+/* event handler function */
+typedef void (*event_handler)(uint32_t param);
+
+/* event handler descriptor with its execution statistics */
+typedef struct event_handler_struct {
+    const char *name;                                                  /*!< name shown in reports */
+    event_handler handler;                                             /*!< handler function */
+    struct event_handler_struct *next;                                 /*!< report list link */
+    uint32_t count;                                                    /*!< number of runs */
+    uint64_t cycles_total;                                             /*!< total execution cycles */
+    uint32_t cycles_max;                                               /*!< longest execution in cycles */
+} event_handler_struct;
+
+/* deferred work item, coalesced while pending */
+typedef struct event_work_struct {
+    event_handler_struct *handler;                                     /*!< handler run for the work */
+    uint32_t param;                                                    /*!< handler parameter */
+    struct event_work_struct *next;                                    /*!< work list link */
+    uint32_t pending;                                                  /*!< queued but not yet run */
+} event_work_struct;
+
+/* per-priority queue statistics */
+typedef struct {
+    uint32_t posted;                                                   /*!< events accepted */
+    uint32_t dropped;                                                  /*!< events rejected on a full queue */
+    uint32_t high_water;                                               /*!< deepest queue fill seen */
+} event_queue_stat_struct;
+
+/* idle hook, called with interrupts masked when nothing is ready */
+typedef void (*event_idle_hook)(void);
+
+/* define a handler descriptor */
+#define EVENT_HANDLER_DEFINE(var, fn)    event_handler_struct var = {#fn, (fn), 0, 0U, 0U, 0U}
+
+/* post an event, safe from interrupt context */
+int event_post(event_handler_struct *handler, uint32_t param, uint32_t priority);
+/* initialize a deferred work item */
+void event_work_init(event_work_struct *work, event_handler_struct *handler);
+/* queue a deferred work item, safe from interrupt context */
+void event_work_submit(event_work_struct *work, uint32_t param);
+/* run the highest priority ready event or work item */
+uint32_t event_dispatch(void);
+/* check whether events or work items are ready */
+int event_pending(void);
+/* install the idle hook */
+void event_idle_hook_set(event_idle_hook hook);
+/* sleep through the idle hook if nothing is ready */
+void event_idle(void);
+/* get the statistics of a priority queue */
+void event_queue_stat_get(uint32_t priority, event_queue_stat_struct *stat);
+/* print handler and queue statistics */
+void event_stats_print(void);
+
+#endif /* EVENT_H */
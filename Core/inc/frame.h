@@ -0,0 +1,108 @@
+/*!
+    \file    frame.h
+    \brief   the header file of the COBS framed transport
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef FRAME_H
+#define FRAME_H
+
+#include "serial.h"
+#include <stdint.h>
+
+/* wire format, all fields little endian, the whole frame is COBS encoded and
+   followed by one 0x00 delimiter:
+     seq    u16  sender sequence number, +1 per frame
+     type   u8   application message type
+     flags  u8   reserved, 0
+     data   payload, 0..n bytes
+     crc    u32  CRC unit (CRC-32/MPEG-2) over the header word, the payload as
+                 little endian words with the last one zero padded, then the
+                 payload length as one more word */
+#define FRAME_HEADER_SIZE                4U
+#define FRAME_CRC_SIZE                   4U
+#define FRAME_OVERHEAD                   (FRAME_HEADER_SIZE + FRAME_CRC_SIZE)
+
+/* worst case bytes on the wire for a payload of len bytes */
+#define FRAME_WIRE_SIZE(len)             ((len) + FRAME_OVERHEAD + (((len) + FRAME_OVERHEAD) / 254U) + 2U)
+
+/* frame consumer, called from the USART/DMA interrupt, payload is valid until return */
+typedef void (*frame_callback)(void *arg, uint8_t type, uint16_t seq, const uint8_t *payload, uint32_t len);
+
+/* link parameters */
+typedef struct {
+    serial_port_enum port;                                             /*!< serial port carrying the frames */
+    uint8_t *rx_buffer;                                                /*!< decoded frame storage, header and CRC included */
+    uint32_t rx_size;                                                  /*!< rx_buffer size, largest payload + FRAME_OVERHEAD */
+    frame_callback callback;                                           /*!< frame consumer */
+    void *arg;                                                         /*!< callback argument */
+} frame_parameter_struct;
+
+/* link counters */
+typedef struct {
+    uint32_t tx_frames;                                                /*!< frames queued */
+    uint32_t tx_dropped;                                               /*!< frames dropped by a full transmit ring */
+    uint32_t rx_frames;                                                /*!< good frames delivered */
+    uint32_t rx_bytes;                                                 /*!< payload bytes delivered */
+    uint32_t crc_errors;                                               /*!< frames with a bad CRC */
+    uint32_t cobs_errors;                                              /*!< malformed or runt frames */
+    uint32_t overlong;                                                 /*!< frames larger than rx_buffer */
+    uint32_t lost;                                                     /*!< frames missing according to the sequence number */
+} frame_stat_struct;
+
+/* link instance */
+typedef struct {
+    frame_parameter_struct para;                                       /*!< configuration */
+    uint32_t rx_len;                                                   /*!< decoded bytes of the current frame */
+    uint8_t rx_code;                                                   /*!< COBS code of the current block */
+    uint8_t rx_remaining;                                              /*!< bytes left in the current block */
+    uint8_t rx_discard;                                                /*!< skip to the next delimiter */
+    uint8_t rx_synced;                                                 /*!< a frame was received, rx_seq is valid */
+    uint16_t rx_seq;                                                   /*!< last received sequence number */
+    uint16_t tx_seq;                                                   /*!< next sequence number to send */
+    frame_stat_struct stat;                                            /*!< counters */
+} frame_struct;
+
+/* initialize the parameter struct with default values */
+void frame_struct_para_init(frame_parameter_struct *para);
+/* open the serial port with frame reception and reset the link */
+ErrStatus frame_open(frame_struct *frame, const frame_parameter_struct *para, const serial_parameter_struct *serial_para);
+/* encode a frame straight into the transmit ring, callable from any context */
+ErrStatus frame_send(frame_struct *frame, uint8_t type, const void *payload, uint32_t len);
+/* feed received bytes to the decoder */
+void frame_receive(frame_struct *frame, const uint8_t *data, uint32_t len);
+/* usart_rx callback, installed by frame_open() */
+void frame_rx_handler(void *arg, const uint8_t *data0, uint32_t len0,
+                      const uint8_t *data1, uint32_t len1, uint32_t flags);
+/* read the counters */
+void frame_stat_get(frame_struct *frame, frame_stat_struct *stat);
+
+#endif /* FRAME_H */
@@ -56,5 +56,55 @@ void DebugMon_Handler(void);
 void PendSV_Handler(void);
 /* this function handles SysTick exception */
 void SysTick_Handler(void);
+/* this function handles DMA0 channel 0 interrupt */
+void DMA0_Channel0_IRQHandler(void);
+/* this function handles DMA0 channel 1 interrupt */
+void DMA0_Channel1_IRQHandler(void);
+/* this function handles DMA0 channel 2 interrupt */
+void DMA0_Channel2_IRQHandler(void);
+/* this function handles DMA0 channel 3 interrupt */
+void DMA0_Channel3_IRQHandler(void);
+/* this function handles DMA0 channel 4 interrupt */
+void DMA0_Channel4_IRQHandler(void);
+/* this function handles DMA0 channel 5 interrupt */
+void DMA0_Channel5_IRQHandler(void);
+/* this function handles DMA0 channel 6 interrupt */
+void DMA0_Channel6_IRQHandler(void);
+/* this function handles DMA0 channel 7 interrupt */
+void DMA0_Channel7_IRQHandler(void);
+/* this function handles DMA1 channel 0 interrupt */
+void DMA1_Channel0_IRQHandler(void);
+/* this function handles DMA1 channel 1 interrupt */
+void DMA1_Channel1_IRQHandler(void);
+/* this function handles DMA1 channel 2 interrupt */
+void DMA1_Channel2_IRQHandler(void);
+/* this function handles DMA1 channel 3 interrupt */
+void DMA1_Channel3_IRQHandler(void);
+/* this function handles DMA1 channel 4 interrupt */
+void DMA1_Channel4_IRQHandler(void);
+/* this function handles DMA1 channel 5 interrupt */
+void DMA1_Channel5_IRQHandler(void);
+/* this function handles DMA1 channel 6 interrupt */
+void DMA1_Channel6_IRQHandler(void);
+/* this function handles DMA1 channel 7 interrupt */
+void DMA1_Channel7_IRQHandler(void);
+/* this function handles USART0 interrupt */
+void USART0_IRQHandler(void);
+/* this function handles USART1 interrupt */
+void USART1_IRQHandler(void);
+/* this function handles USART2 interrupt */
+void USART2_IRQHandler(void);
+/* this function handles UART3 interrupt */
+void UART3_IRQHandler(void);
+/* this function handles UART4 interrupt */
+void UART4_IRQHandler(void);
+/* this function handles USART5 interrupt */
+void USART5_IRQHandler(void);
+/* this function handles UART6 interrupt */
+void UART6_IRQHandler(void);
+/* this function handles UART7 interrupt */
+void UART7_IRQHandler(void);
+/* this function handles ENET interrupt */
+void ENET_IRQHandler(void);
 
 #endif /* GD32F4XX_IT_H */
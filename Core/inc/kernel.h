@@ -0,0 +1,179 @@
+/*!
+    \file    kernel.h
+    \brief   the header file of the preemptive micro-kernel
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include <stdint.h>
+#include "soft_timer.h"
+
+/* number of task priorities, 0 is the highest, the last one is reserved for the idle task */
+#define KERNEL_PRIORITIES                32U
+#define KERNEL_IDLE_PRIORITY             (KERNEL_PRIORITIES - 1U)
+/* raw NVIC priority (0..15) of the highest interrupt allowed to call the kernel,
+   interrupts above it are never masked by kernel critical sections */
+#define KERNEL_SYSCALL_PRIORITY          4U
+/* idle task stack size in words */
+#define KERNEL_IDLE_STACK_WORDS          128U
+
+/* timeouts in ticks */
+#define KERNEL_NO_WAIT                   0U
+#define KERNEL_WAIT_FOREVER              0xFFFFFFFFU
+
+/* return codes */
+#define KERNEL_OK                        0
+#define KERNEL_ERROR_TIMEOUT             (-1)
+#define KERNEL_ERROR_PARAM               (-2)
+
+/* task states */
+typedef enum {
+    KERNEL_TASK_READY = 0,                                             /*!< in a ready list */
+    KERNEL_TASK_BLOCKED,                                               /*!< waiting on an object or a delay */
+    KERNEL_TASK_DEAD                                                   /*!< returned from its entry */
+} kernel_task_state_enum;
+
+/* task entry */
+typedef void (*kernel_task_entry)(void *arg);
+
+/* doubly linked list node and list head */
+typedef struct kernel_list_struct {
+    struct kernel_list_struct *next;
+    struct kernel_list_struct *prev;
+} kernel_list_struct;
+
+struct kernel_mutex_struct;
+
+/* task control block, owned by the caller */
+typedef struct kernel_task_struct {
+    uint32_t *sp;                                                      /*!< saved stack pointer, must stay first */
+    kernel_list_struct node;                                           /*!< ready or wait list link */
+    kernel_list_struct *wait_list;                                     /*!< list the task is blocked on */
+    struct kernel_mutex_struct *wait_mutex;                            /*!< mutex the task is blocked on */
+    struct kernel_mutex_struct *held;                                  /*!< mutexes owned by the task */
+    struct kernel_task_struct *next_task;                              /*!< list of all tasks */
+    soft_timer_struct timeout;                                         /*!< delay and wait timeout */
+    const char *name;                                                  /*!< name shown in reports */
+    uint32_t *stack;                                                   /*!< lowest stack word */
+    uint32_t stack_words;                                              /*!< stack size in words */
+    uint32_t switches;                                                 /*!< times switched in */
+    int32_t wait_result;                                               /*!< KERNEL_OK or KERNEL_ERROR_TIMEOUT */
+    uint8_t priority;                                                  /*!< effective priority */
+    uint8_t base_priority;                                             /*!< priority without inheritance */
+    uint8_t state;                                                     /*!< kernel_task_state_enum */
+} kernel_task_struct;
+
+/* counting semaphore */
+typedef struct {
+    uint32_t count;                                                    /*!< available units */
+    uint32_t max;                                                      /*!< upper bound of count */
+    kernel_list_struct waiters;                                        /*!< tasks blocked in take */
+} kernel_sem_struct;
+
+/* mutex with priority inheritance, not recursive */
+typedef struct kernel_mutex_struct {
+    kernel_task_struct *owner;                                         /*!< owning task or NULL */
+    struct kernel_mutex_struct *next_held;                             /*!< owner's held list link */
+    kernel_list_struct waiters;                                        /*!< tasks blocked in lock */
+} kernel_mutex_struct;
+
+/* fixed-size message queue over caller storage */
+typedef struct {
+    uint8_t *buffer;                                                   /*!< msg_count * msg_size bytes */
+    uint32_t msg_size;                                                 /*!< bytes per message */
+    uint32_t msg_count;                                                /*!< queue capacity */
+    uint32_t head;                                                     /*!< next write slot */
+    uint32_t used;                                                     /*!< messages queued */
+    kernel_list_struct senders;                                        /*!< tasks blocked in send */
+    kernel_list_struct receivers;                                      /*!< tasks blocked in receive */
+} kernel_queue_struct;
+
+/* context switch timing in core cycles */
+typedef struct {
+    uint32_t count;                                                    /*!< switches measured */
+    uint32_t last;                                                     /*!< last switch */
+    uint32_t min;                                                      /*!< fastest switch */
+    uint32_t max;                                                      /*!< slowest switch */
+} kernel_switch_stat_struct;
+
+/* idle hook, runs in the idle task */
+typedef void (*kernel_idle_hook)(void);
+
+/* create a task, may be called before or after kernel_start() */
+int kernel_task_create(kernel_task_struct *task, const char *name, kernel_task_entry entry, void *arg,
+                       uint32_t priority, uint32_t *stack, uint32_t stack_words);
+/* start scheduling, does not return */
+void kernel_start(void);
+/* get the running task */
+kernel_task_struct *kernel_task_self(void);
+/* let other ready tasks of the same priority run */
+void kernel_yield(void);
+/* block the running task for a number of ticks */
+void kernel_delay(uint32_t ticks);
+/* install the idle hook */
+void kernel_idle_hook_set(kernel_idle_hook hook);
+
+/* initialize a semaphore */
+void kernel_sem_init(kernel_sem_struct *sem, uint32_t count, uint32_t max);
+/* take a semaphore unit */
+int kernel_sem_take(kernel_sem_struct *sem, uint32_t timeout);
+/* give a semaphore unit, safe from interrupt context */
+int kernel_sem_give(kernel_sem_struct *sem);
+
+/* initialize a mutex */
+void kernel_mutex_init(kernel_mutex_struct *mutex);
+/* lock a mutex, boosting its owner to the caller's priority while waiting */
+int kernel_mutex_lock(kernel_mutex_struct *mutex, uint32_t timeout);
+/* unlock a mutex owned by the caller */
+int kernel_mutex_unlock(kernel_mutex_struct *mutex);
+
+/* initialize a message queue */
+void kernel_queue_init(kernel_queue_struct *queue, void *buffer, uint32_t msg_size, uint32_t msg_count);
+/* copy a message into a queue, interrupt context must use KERNEL_NO_WAIT */
+int kernel_queue_send(kernel_queue_struct *queue, const void *msg, uint32_t timeout);
+/* copy a message out of a queue */
+int kernel_queue_receive(kernel_queue_struct *queue, void *msg, uint32_t timeout);
+
+/* get the context switch timing */
+void kernel_switch_stat_get(kernel_switch_stat_struct *stat);
+/* get the unused stack of a task in words */
+uint32_t kernel_task_stack_free(const kernel_task_struct *task);
+/* print context switch and task statistics */
+void kernel_stats_print(void);
+
+/* context switch, entered from PendSV_Handler */
+void kernel_pendsv(void);
+/* first task start, entered from SVC_Handler */
+void kernel_svc(void);
+
+#endif /* KERNEL_H */
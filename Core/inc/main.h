@@ -36,7 +36,7 @@ OF SUCH DAMAGE.
 #define __MAIN_H
 
 /* led spark function */
-void led_spark(void);
+void led_spark(void *arg);
 
 #endif /* __MAIN_H */
 
@@ -0,0 +1,120 @@
+/*!
+    \file    profile.h
+    \brief   the header file of the DWT cycle counter profiler
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include "serial.h"
+#include <stdint.h>
+
+/* set to 0 to compile all profiling macros out */
+#ifndef PROFILE_ENABLE
+#define PROFILE_ENABLE                   1
+#endif
+
+/* log2 histogram buckets, bucket n counts samples of 2^n to 2^(n+1)-1 cycles */
+#define PROFILE_HIST_BUCKETS             32U
+/* deepest region nesting, including regions entered from interrupts */
+#define PROFILE_MAX_DEPTH                16U
+
+/* binary dump format */
+#define PROFILE_DUMP_MAGIC               0x31465250U                   /*!< "PRF1" little-endian */
+#define PROFILE_DUMP_VERSION             1U
+
+/* profiled region, define with PROFILE_REGION_DEFINE */
+typedef struct profile_region_struct {
+    const char *name;                                                  /*!< name shown in reports */
+    struct profile_region_struct *next;                                /*!< registered region list */
+    uint32_t count;                                                    /*!< completed samples */
+    uint32_t min;                                                      /*!< shortest inclusive sample */
+    uint32_t max;                                                      /*!< longest inclusive sample */
+    uint64_t total;                                                    /*!< inclusive cycles */
+    uint64_t self;                                                     /*!< cycles not spent in nested regions */
+    uint32_t hist[PROFILE_HIST_BUCKETS];                               /*!< log2 histogram of inclusive cycles */
+} profile_region_struct;
+
+/* scope guard used by PROFILE_SCOPE */
+typedef struct {
+    profile_region_struct *region;
+} profile_scope_struct;
+
+/* begin a region */
+void profile_begin(profile_region_struct *region);
+/* end the innermost region */
+void profile_end(profile_region_struct *region);
+/* measure the begin/end overhead and clear all regions */
+void profile_init(void);
+/* clear the statistics of all regions */
+void profile_reset(void);
+/* write all regions as a binary dump to a serial port */
+ErrStatus profile_dump(serial_port_enum port);
+
+/* scope guard helpers */
+static inline profile_scope_struct profile_scope_enter(profile_region_struct *region)
+{
+    profile_scope_struct scope = {region};
+
+    profile_begin(region);
+    return scope;
+}
+
+static inline void profile_scope_exit(profile_scope_struct *scope)
+{
+    profile_end(scope->region);
+}
+
+#define PROFILE_CONCAT_(a, b)            a##b
+#define PROFILE_CONCAT(a, b)             PROFILE_CONCAT_(a, b)
+
+#if PROFILE_ENABLE
+/* define a region */
+#define PROFILE_REGION_DEFINE(var, name) profile_region_struct var = {(name), 0, 0U, 0xFFFFFFFFU, 0U, 0U, 0U, {0U}}
+/* declare a region defined in another file */
+#define PROFILE_REGION_EXTERN(var)       extern profile_region_struct var
+/* begin and end a region explicitly, ends must nest inside begins */
+#define PROFILE_BEGIN(var)               profile_begin(&(var))
+#define PROFILE_END(var)                 profile_end(&(var))
+/* profile from here to the end of the enclosing block */
+#define PROFILE_SCOPE(var)                                                                   \
+    profile_scope_struct PROFILE_CONCAT(profile_scope_, __LINE__)                           \
+        __attribute__((cleanup(profile_scope_exit), unused)) = profile_scope_enter(&(var))
+#else
+#define PROFILE_REGION_DEFINE(var, name) extern int PROFILE_CONCAT(profile_unused_, __LINE__)
+#define PROFILE_REGION_EXTERN(var)       extern int PROFILE_CONCAT(profile_unused_, __LINE__)
+#define PROFILE_BEGIN(var)               do { } while(0)
+#define PROFILE_END(var)                 do { } while(0)
+#define PROFILE_SCOPE(var)               do { } while(0)
+#endif /* PROFILE_ENABLE */
+
+#endif /* PROFILE_H */
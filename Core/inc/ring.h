@@ -0,0 +1,89 @@
+/*!
+    \file    ring.h
+    \brief   the header file of the lock-free multi-producer byte ring
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef RING_H
+#define RING_H
+
+#include "gd32f4xx.h"
+#include <stdint.h>
+
+/* byte ring written by any number of tasks and interrupts, read by one consumer.
+   Producers reserve space with LDREX/STREX, fill it and publish. Data becomes
+   readable when the last open reservation is published, so a preempted writer
+   holds back later writers but never exposes a half written record */
+typedef struct {
+    uint8_t *buffer;                                                   /*!< storage */
+    uint32_t mask;                                                     /*!< size - 1, size is a power of two */
+    volatile uint32_t head;                                            /*!< next byte to reserve */
+    volatile uint32_t commit;                                          /*!< bytes before this index are readable */
+    volatile uint32_t tail;                                            /*!< next byte to read */
+    volatile uint32_t writers;                                         /*!< open reservations */
+} ring_struct;
+
+/*!
+    \brief    add to a counter shared between tasks and interrupts
+    \param[in]  counter: counter
+    \param[in]  value: amount to add
+    \param[out] none
+    \retval     none
+*/
+static inline void ring_atomic_add(volatile uint32_t *counter, uint32_t value)
+{
+    uint32_t old;
+
+    do {
+        old = __LDREXW(counter);
+    } while(0U != __STREXW(old + value, counter));
+}
+
+/* initialize a ring on a power of two sized buffer */
+void ring_init(ring_struct *ring, uint8_t *buffer, uint32_t size);
+/* reserve len bytes, returns 0 and the write index or -1 when full */
+int ring_reserve(ring_struct *ring, uint32_t len, uint32_t *pos);
+/* copy data into a reserved area */
+void ring_put(ring_struct *ring, uint32_t pos, const void *data, uint32_t len);
+/* close a reservation, also required after ring_reserve() failed */
+void ring_publish(ring_struct *ring);
+/* reserve, copy and publish, returns len or 0 when full */
+uint32_t ring_write(ring_struct *ring, const void *data, uint32_t len);
+/* get the contiguous readable block at the tail */
+uint32_t ring_peek(ring_struct *ring, uint8_t **data);
+/* release len bytes at the tail, consumer only */
+void ring_consume(ring_struct *ring, uint32_t len);
+/* bytes published but not consumed */
+uint32_t ring_readable(ring_struct *ring);
+/* bytes that can still be reserved */
+uint32_t ring_free(ring_struct *ring);
+
+#endif /* RING_H */
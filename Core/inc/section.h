@@ -0,0 +1,75 @@
+/*!
+    \file    section.h
+    \brief   memory placement attributes for the linker script output sections
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef SECTION_H
+#define SECTION_H
+
+#include <stdint.h>
+
+/* TCMRAM, 64KB at 0x10000000, zero wait state and CPU only.
+   It is not connected to the DMA controllers or ENET, so buffers handed to a
+   DMA master must stay in the main SRAM. The main stack (MSP) sits at its top,
+   local variables of main() and of interrupt handlers are not DMA capable either */
+#define SECTION_TCM_BASE                 0x10000000U
+#define SECTION_TCM_SIZE                 0x00010000U
+
+/* initialized data in TCMRAM, copied from flash at reset */
+#define __TCM_DATA                       __attribute__((section(".tcmram")))
+/* zero initialized data in TCMRAM, cleared at reset */
+#define __TCM_BSS                        __attribute__((section(".tcmram_bss")))
+/* stack array in TCMRAM, 8 byte aligned as required by AAPCS for task stacks */
+#define __TCM_STACK                      __attribute__((section(".tcmram_bss"), aligned(8)))
+
+/* code in SRAM, copied from flash at reset. TCMRAM sits on the data bus only
+   and cannot hold code, SRAM0 is fetched over the system bus without wait
+   states but shares it with DMA. Calls between flash and SRAM go through
+   linker generated long branch veneers */
+#define __FASTCODE                       __attribute__((section(".fastcode"), noinline))
+/* code placed at the start of flash, inside the zero wait state area */
+#define __FLASH_NOWAIT                   __attribute__((section(".text.nowait")))
+
+/* data in SRAM that Reset_Handler neither copies nor zeroes, it keeps its
+   content across a watchdog or software reset and is random after power on */
+#define __NOINIT                         __attribute__((section(".noinit")))
+
+/* ENET descriptor rings and buffers in SRAM2, 64KB at 0x20020000. The bank is
+   a bus matrix slave of its own, so the ENET DMA does not stall the CPU on
+   SRAM0 and the DMA controllers keep SRAM1. Neither copied nor zeroed at reset,
+   enet_descriptors_region_init() writes what it uses */
+#define __ENET_RAM                       __attribute__((section(".enetram"), aligned(4)))
+
+/* nonzero when the address is in TCMRAM and therefore not reachable by DMA */
+#define SECTION_IN_TCM(addr)             ((uint32_t)((uintptr_t)(addr) - SECTION_TCM_BASE) < SECTION_TCM_SIZE)
+
+#endif /* SECTION_H */
@@ -0,0 +1,133 @@
+/*!
+    \file    serial.h
+    \brief   the header file of the multi-port serial driver
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef SERIAL_H
+#define SERIAL_H
+
+#include "gd32f4xx.h"
+#include "dma_mgr.h"
+#include "usart_rx.h"
+#include <stdint.h>
+
+/* serial ports, index of the port table in serial.c */
+typedef enum {
+    SERIAL_USART0 = 0,                                                 /*!< USART0, APB2 */
+    SERIAL_USART1,                                                     /*!< USART1, APB1 */
+    SERIAL_USART2,                                                     /*!< USART2, APB1 */
+    SERIAL_UART3,                                                      /*!< UART3, APB1 */
+    SERIAL_UART4,                                                      /*!< UART4, APB1 */
+    SERIAL_USART5,                                                     /*!< USART5, APB2 */
+    SERIAL_UART6,                                                      /*!< UART6, APB1 */
+    SERIAL_UART7,                                                      /*!< UART7, APB1 */
+    SERIAL_PORT_NUM
+} serial_port_enum;
+
+/* what serial_write() does when the transmit ring is full */
+typedef enum {
+    SERIAL_POLICY_DROP = 0,                                            /*!< discard the new data */
+    SERIAL_POLICY_BLOCK,                                               /*!< wait for the DMA in thread mode, drop in handlers or when only open reservations hold the ring */
+    SERIAL_POLICY_OVERWRITE                                            /*!< discard the oldest unsent data */
+} serial_policy_enum;
+
+/* port configuration, serial_struct_para_init() fills the default pins of the port */
+typedef struct {
+    uint32_t baudrate;                                                 /*!< bits per second */
+    uint32_t parity;                                                   /*!< USART_PM_NONE, USART_PM_EVEN or USART_PM_ODD */
+    uint32_t stop_bits;                                                /*!< USART_STB_1BIT, USART_STB_0_5BIT, USART_STB_2BIT or USART_STB_1_5BIT */
+    uint32_t tx_gpio;                                                  /*!< GPIOx of the TX pin */
+    uint32_t tx_pin;                                                   /*!< GPIO_PIN_x of the TX pin */
+    uint32_t rx_gpio;                                                  /*!< GPIOx of the RX pin */
+    uint32_t rx_pin;                                                   /*!< GPIO_PIN_x of the RX pin */
+    uint32_t af;                                                       /*!< GPIO_AF_x of both pins */
+    uint8_t *tx_buffer;                                                /*!< transmit ring in SRAM, NULL for receive only */
+    uint32_t tx_size;                                                  /*!< transmit ring size in bytes, power of two */
+    uint8_t *rx_buffer;                                                /*!< circular receive buffer in SRAM, NULL for transmit only */
+    uint32_t rx_size;                                                  /*!< receive buffer size in bytes, even */
+    uint32_t rx_timeout_bits;                                          /*!< frame gap in bit times, 0 for IDLE (USART0/1/2/5 only) */
+    usart_rx_callback rx_callback;                                     /*!< frame consumer, NULL for serial_read() */
+    void *rx_arg;                                                      /*!< callback argument */
+    serial_policy_enum policy;                                         /*!< full transmit ring policy */
+    uint8_t irq_priority;                                              /*!< preemption priority of the USART and DMA interrupts */
+} serial_parameter_struct;
+
+/* per-port counters */
+typedef struct {
+    uint32_t tx_bytes;                                                 /*!< bytes accepted for transmission */
+    uint32_t tx_dropped;                                               /*!< bytes discarded because the ring was full */
+    uint32_t tx_overwritten;                                           /*!< old bytes discarded by SERIAL_POLICY_OVERWRITE */
+    uint32_t tx_blocked;                                               /*!< writes that had to wait */
+    uint32_t tx_transfers;                                             /*!< DMA transfers completed */
+    uint32_t tx_high_water;                                            /*!< largest ring fill level in bytes */
+    uint32_t rx_bytes;                                                 /*!< bytes received */
+    uint32_t rx_frames;                                                /*!< frames delivered to the callback */
+    uint32_t rx_overruns;                                              /*!< USART overrun errors */
+    uint32_t rx_framing_errors;                                        /*!< USART framing errors */
+    uint32_t rx_noise_errors;                                          /*!< USART noise errors */
+    uint32_t rx_overflows;                                             /*!< unread data overwritten by the DMA */
+} serial_stat_struct;
+
+/* initialize the parameter struct with 115200 8N1 and the default pins of the port */
+void serial_struct_para_init(serial_port_enum port, serial_parameter_struct *para);
+/* configure the pins, the USART and its DMA channels and start the port */
+ErrStatus serial_open(serial_port_enum port, const serial_parameter_struct *para);
+/* stop the port and release its DMA channels */
+void serial_close(serial_port_enum port);
+/* program the exact divider, returns the baud rate achieved or 0 when out of range */
+uint32_t serial_baudrate_set(serial_port_enum port, uint32_t baudrate);
+/* select the full ring policy */
+void serial_policy_set(serial_port_enum port, serial_policy_enum policy);
+/* queue bytes for transmission, callable from any context */
+uint32_t serial_write(serial_port_enum port, const void *data, uint32_t len);
+/* reserve transmit ring space following the port policy, for writers that build data in place */
+ErrStatus serial_write_begin(serial_port_enum port, uint32_t len, uint32_t *pos);
+/* copy bytes into a reservation, returns the following write index */
+uint32_t serial_write_put(serial_port_enum port, uint32_t pos, const void *data, uint32_t len);
+/* publish a reservation and start the DMA */
+void serial_write_end(serial_port_enum port, uint32_t len);
+/* bytes serial_write() can accept right now */
+uint32_t serial_free(serial_port_enum port);
+/* wait until everything queued has left the USART, thread mode only */
+void serial_flush(serial_port_enum port);
+/* copy received bytes, returns the count */
+uint32_t serial_read(serial_port_enum port, uint8_t *data, uint32_t len);
+/* bytes waiting for serial_read() */
+uint32_t serial_available(serial_port_enum port);
+/* read the counters */
+void serial_stat_get(serial_port_enum port, serial_stat_struct *stat);
+/* peripheral base of the port, USARTx or UARTx */
+uint32_t serial_usart_get(serial_port_enum port);
+/* USART interrupt of the port, called from USARTx_IRQHandler */
+void serial_usart_irq(serial_port_enum port);
+
+#endif /* SERIAL_H */
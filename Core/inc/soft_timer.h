@@ -0,0 +1,88 @@
+/*!
+    \file    soft_timer.h
+    \brief   the header file of the hierarchical software timer wheel
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef SOFT_TIMER_H
+#define SOFT_TIMER_H
+
+#include <stdint.h>
+
+/* wheel geometry: SOFT_TIMER_LEVELS levels of 2^SOFT_TIMER_SLOT_BITS slots each */
+#define SOFT_TIMER_SLOT_BITS             6U
+#define SOFT_TIMER_SLOTS                 (1U << SOFT_TIMER_SLOT_BITS)
+#define SOFT_TIMER_SLOT_MASK             (SOFT_TIMER_SLOTS - 1U)
+#define SOFT_TIMER_LEVELS                4U
+/* longest timeout held by the wheel, longer timeouts are re-cascaded */
+#define SOFT_TIMER_MAX_TIMEOUT           ((1UL << (SOFT_TIMER_SLOT_BITS * SOFT_TIMER_LEVELS)) - 1U)
+
+/* timer flags */
+#define SOFT_TIMER_FLAG_ISR              0x00U                         /*!< callback runs in SysTick_Handler */
+#define SOFT_TIMER_FLAG_DEFERRED         0x01U                         /*!< callback runs from soft_timer_dispatch() */
+
+/* timer callback */
+typedef void (*soft_timer_callback)(void *arg);
+
+/* doubly linked list node */
+typedef struct soft_timer_node_struct {
+    struct soft_timer_node_struct *next;
+    struct soft_timer_node_struct *prev;
+} soft_timer_node_struct;
+
+/* software timer, owned by the caller */
+typedef struct soft_timer_struct {
+    soft_timer_node_struct node;                                       /*!< wheel slot link, must stay first */
+    struct soft_timer_struct *pending_next;                            /*!< deferred dispatch link */
+    struct soft_timer_struct *pending_prev;                            /*!< deferred dispatch back link, O(1) cancel */
+    uint64_t expire;                                                   /*!< absolute expiry tick */
+    uint32_t period;                                                   /*!< reload in ticks, 0 for one-shot */
+    uint32_t flags;                                                    /*!< SOFT_TIMER_FLAG_xxx and state bits */
+    soft_timer_callback callback;                                      /*!< expiry callback */
+    void *arg;                                                         /*!< callback argument */
+} soft_timer_struct;
+
+/* initialize a timer */
+void soft_timer_init(soft_timer_struct *timer, soft_timer_callback callback, void *arg, uint32_t flags);
+/* start or restart a timer */
+void soft_timer_start(soft_timer_struct *timer, uint32_t timeout, uint32_t period);
+/* stop a timer and cancel any deferred callback */
+void soft_timer_stop(soft_timer_struct *timer);
+/* check whether a timer is running */
+int soft_timer_active(const soft_timer_struct *timer);
+/* advance the wheel to the current tick, called from SysTick_Handler */
+void soft_timer_process(uint64_t now);
+/* run deferred callbacks, called from the main loop */
+uint32_t soft_timer_dispatch(void);
+/* ticks the core may sleep before the wheel has work to do */
+uint32_t soft_timer_idle_ticks(void);
+
+#endif /* SOFT_TIMER_H */
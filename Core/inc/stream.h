@@ -0,0 +1,126 @@
+/*!
+    \file    stream.h
+    \brief   the header file of the double-buffered DMA streaming pipeline
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "gd32f4xx.h"
+#include "dma_mgr.h"
+#include <stdint.h>
+
+/* most buffers in one stream, two are always loaded in the DMA */
+#define STREAM_BUFFERS_MAX               8U
+
+/* what a stage does with a buffer */
+typedef enum {
+    STREAM_PASS = 0,                                                   /*!< hand the buffer to the next stage */
+    STREAM_HOLD,                                                       /*!< keep it, stream_forward() or stream_release() follows later */
+    STREAM_DROP                                                        /*!< release it, later stages do not see it */
+} stream_verdict_enum;
+
+struct stream_struct;
+struct stream_stage_struct;
+
+/* filled buffer travelling down the stage chain */
+typedef struct {
+    struct stream_struct *stream;                                      /*!< owning stream */
+    void *data;                                                        /*!< first item */
+    uint32_t count;                                                    /*!< valid items, a stage may shrink it in place */
+    uint32_t seq;                                                      /*!< fill sequence number, gaps are overruns */
+    struct stream_stage_struct *stage;                                 /*!< stage running or holding it, NULL when free */
+} stream_buf_struct;
+
+/* stage processing, called from the DMA interrupt or from the context of stream_forward() */
+typedef stream_verdict_enum (*stream_process)(void *arg, stream_buf_struct *buf);
+
+/* processing stage, linked in the order the buffers visit them */
+typedef struct stream_stage_struct {
+    struct stream_stage_struct *next;                                  /*!< next stage */
+    stream_process process;                                            /*!< processing function */
+    void *arg;                                                         /*!< process argument */
+    uint32_t buffers;                                                  /*!< buffers seen */
+} stream_stage_struct;
+
+/* source description */
+typedef struct {
+    dma_mgr_request_enum request;                                      /*!< DMA request of the source, e.g. DMA_MGR_ADC0 */
+    uint32_t periph_addr;                                              /*!< peripheral data register */
+    uint32_t periph_width;                                             /*!< DMA_PERIPH_WIDTH_x, also the item size in memory */
+    uint32_t priority;                                                 /*!< DMA_PRIORITY_x */
+    uint8_t irq_priority;                                              /*!< NVIC priority of the DMA interrupt */
+    uint32_t items;                                                    /*!< items per buffer, 1..65535 */
+    void *const *buffers;                                              /*!< buffers in SRAM, not TCMRAM */
+    uint32_t buffer_num;                                               /*!< 2..STREAM_BUFFERS_MAX */
+    uint32_t stop_on_overrun;                                          /*!< 1 to stop instead of losing a buffer */
+} stream_config_struct;
+
+/* stream counters */
+typedef struct {
+    uint32_t buffers;                                                  /*!< buffers handed to the chain */
+    uint32_t overruns;                                                 /*!< buffers refilled because no free buffer was left */
+    uint32_t dropped;                                                  /*!< buffers ended early with STREAM_DROP */
+    uint32_t errors;                                                   /*!< transfer access errors, the stream stops */
+    uint32_t fifo_errors;                                              /*!< FIFO and single data mode exceptions */
+    uint32_t held_max;                                                 /*!< most buffers in the chain at once */
+} stream_stat_struct;
+
+/* stream state */
+typedef struct stream_struct {
+    stream_config_struct config;                                       /*!< source description */
+    dma_mgr_channel_struct dma;                                        /*!< channel while running */
+    stream_stage_struct *stages;                                       /*!< first stage */
+    stream_buf_struct buf[STREAM_BUFFERS_MAX];                         /*!< buffer descriptors */
+    uint32_t slot[2];                                                  /*!< buffer loaded as memory 0 and memory 1 */
+    volatile uint32_t free;                                            /*!< bit mask of free buffers */
+    volatile uint32_t running;                                         /*!< DMA channel running */
+    uint32_t seq;                                                      /*!< next fill sequence number */
+    stream_stat_struct stat;                                           /*!< counters */
+} stream_struct;
+
+/* initialize a stream from its source description */
+ErrStatus stream_init(stream_struct *stream, const stream_config_struct *config);
+/* append a stage to the chain, before stream_start() */
+void stream_stage_add(stream_struct *stream, stream_stage_struct *stage, stream_process process, void *arg);
+/* take the DMA channel and start filling, the caller then enables the peripheral DMA request */
+ErrStatus stream_start(stream_struct *stream);
+/* stop filling and give the channel back */
+void stream_stop(stream_struct *stream);
+/* pass a held buffer on to the stage after the holder */
+void stream_forward(stream_buf_struct *buf);
+/* give a held buffer back to the stream */
+void stream_release(stream_buf_struct *buf);
+/* read the counters */
+void stream_stat_get(const stream_struct *stream, stream_stat_struct *stat);
+
+#endif /* STREAM_H */
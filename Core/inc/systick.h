@@ -37,11 +37,55 @@ OF SUCH DAMAGE.
 
 #include <stdint.h>
 
+/* tick frequency in Hz */
+#define SYSTICK_TICK_HZ                  1000U
+
+/* compute the absolute tick of a deadline timeout ticks from now */
+static inline uint64_t systick_deadline_get(uint64_t now, uint32_t timeout)
+{
+    return now + timeout;
+}
+
+/* check whether a deadline has been reached, safe across counter wraparound */
+static inline int systick_deadline_reached(uint64_t now, uint64_t deadline)
+{
+    return (int64_t)(now - deadline) >= 0;
+}
+
+/* ticks left until a deadline, 0 once reached and saturated to 32 bits */
+static inline uint32_t systick_deadline_remaining(uint64_t now, uint64_t deadline)
+{
+    int64_t remaining = (int64_t)(deadline - now);
+
+    if(remaining <= 0) {
+        return 0U;
+    }
+    return (remaining > (int64_t)0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)remaining;
+}
+
+/* cycles elapsed between two cycle counter samples, safe across wraparound */
+static inline uint32_t systick_cycle_elapsed(uint32_t start, uint32_t end)
+{
+    return end - start;
+}
+
 /* configure systick */
 void systick_config(void);
+/* advance the tick counter, called from SysTick_Handler */
+void systick_tick_increment(void);
+/* get the 64-bit monotonic tick counter */
+uint64_t systick_tick_get(void);
+/* get a monotonic timestamp in microseconds */
+uint64_t systick_us_get(void);
+/* get the DWT cycle counter */
+uint32_t systick_cycle_get(void);
+/* sleep for up to ticks with the periodic tick suppressed */
+void systick_sleep(uint32_t ticks);
+/* sleep until the deadline tick is reached */
+void systick_sleep_until(uint64_t deadline);
 /* delay a time in milliseconds */
 void delay_1ms(uint32_t count);
-/* delay decrement */
-void delay_decrement(void);
+/* busy wait a time in microseconds on the cycle counter */
+void delay_1us(uint32_t count);
 
 #endif /* SYS_TICK_H */
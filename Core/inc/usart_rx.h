@@ -0,0 +1,98 @@
+/*!
+    \file    usart_rx.h
+    \brief   the header file of the circular DMA USART receive engine
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#ifndef USART_RX_H
+#define USART_RX_H
+
+#include "gd32f4xx.h"
+#include <stdint.h>
+
+/* callback flag: the buffer filled halfway without a line break, more of the frame follows */
+#define USART_RX_FRAME_PARTIAL           0x01U
+
+/* frame consumer, called from interrupt context with the frame still in the DMA buffer.
+   A frame that wraps around the buffer end arrives as two segments, data1 is NULL
+   otherwise. The bytes are released when the callback returns */
+typedef void (*usart_rx_callback)(void *arg, const uint8_t *data0, uint32_t len0,
+                                  const uint8_t *data1, uint32_t len1, uint32_t flags);
+
+/* receive engine parameters */
+typedef struct {
+    uint32_t usart_periph;                                             /*!< USARTx or UARTx */
+    uint32_t dma_periph;                                               /*!< DMA0 or DMA1 */
+    dma_channel_enum dma_channel;                                      /*!< channel serving USARTx_RX */
+    dma_subperipheral_enum dma_subperi;                                /*!< request multiplexer setting */
+    uint8_t *buffer;                                                   /*!< circular DMA buffer, in SRAM */
+    uint32_t size;                                                     /*!< buffer size in bytes, even */
+    uint32_t timeout_bits;                                             /*!< end of frame after this many idle bit times, 0 for IDLE */
+    usart_rx_callback callback;                                        /*!< frame consumer, NULL for usart_rx_read() */
+    void *arg;                                                         /*!< callback argument */
+} usart_rx_parameter_struct;
+
+/* receive counters */
+typedef struct {
+    uint32_t frames;                                                   /*!< frames delivered */
+    uint32_t bytes;                                                    /*!< bytes received */
+    uint32_t overruns;                                                 /*!< USART overrun errors */
+    uint32_t framing_errors;                                           /*!< USART framing errors */
+    uint32_t noise_errors;                                             /*!< USART noise errors */
+    uint32_t overflows;                                                /*!< unread data overwritten by the DMA */
+} usart_rx_stat_struct;
+
+/* receive engine instance */
+typedef struct {
+    usart_rx_parameter_struct para;                                    /*!< configuration */
+    volatile uint32_t tail;                                            /*!< first unconsumed buffer index */
+    uint32_t last_pos;                                                 /*!< DMA write index at the last update */
+    usart_rx_stat_struct stat;                                         /*!< counters */
+} usart_rx_struct;
+
+/* initialize the parameter struct with default values */
+void usart_rx_struct_para_init(usart_rx_parameter_struct *para);
+/* start circular DMA reception on an already configured USART */
+void usart_rx_init(usart_rx_struct *rx, const usart_rx_parameter_struct *para);
+/* stop reception */
+void usart_rx_stop(usart_rx_struct *rx);
+/* USART interrupt: IDLE, receiver timeout and error flags */
+void usart_rx_usart_irq(usart_rx_struct *rx);
+/* DMA half and full transfer interrupt */
+void usart_rx_dma_irq(usart_rx_struct *rx);
+/* bytes waiting in stream mode */
+uint32_t usart_rx_available(usart_rx_struct *rx);
+/* copy received bytes out in stream mode, returns the count */
+uint32_t usart_rx_read(usart_rx_struct *rx, uint8_t *data, uint32_t len);
+/* read the counters */
+void usart_rx_stat_get(usart_rx_struct *rx, usart_rx_stat_struct *stat);
+
+#endif /* USART_RX_H */
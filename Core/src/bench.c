@@ -0,0 +1,158 @@
+/*!
+    \file    bench.c
+    \brief   common helpers of the benchmark firmware builds
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "bench.h"
+#include "systick.h"
+#include <stdio.h>
+
+#ifdef BENCH
+
+/*!
+    \brief    integer square root
+    \param[in]  value: radicand
+    \param[out] none
+    \retval     floor(sqrt(value))
+*/
+static uint32_t bench_isqrt(uint64_t value)
+{
+    uint64_t root = 0U;
+    uint64_t bit = 1ULL << 62;
+
+    while(bit > value) {
+        bit >>= 2;
+    }
+    while(0U != bit) {
+        if(value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+
+    return (uint32_t)root;
+}
+
+/*!
+    \brief    clear a statistics series
+    \param[in]  stat: series
+    \param[out] none
+    \retval     none
+*/
+void bench_stat_reset(bench_stat_struct *stat)
+{
+    stat->count = 0U;
+    stat->min = 0xFFFFFFFFU;
+    stat->max = 0U;
+    stat->sum = 0U;
+    stat->sum_sq = 0U;
+}
+
+/*!
+    \brief    add a sample in cycles
+    \param[in]  stat: series
+    \param[in]  cycles: sample
+    \param[out] none
+    \retval     none
+*/
+void bench_stat_add(bench_stat_struct *stat, uint32_t cycles)
+{
+    stat->count++;
+    stat->sum += cycles;
+    stat->sum_sq += (uint64_t)cycles * cycles;
+    if(cycles < stat->min) {
+        stat->min = cycles;
+    }
+    if(cycles > stat->max) {
+        stat->max = cycles;
+    }
+}
+
+/*!
+    \brief    print min/mean/max/stddev/jitter in cycles and nanoseconds
+    \param[in]  name: series name
+    \param[in]  stat: series
+    \param[out] none
+    \retval     none
+*/
+void bench_stat_print(const char *name, const bench_stat_struct *stat)
+{
+    uint32_t mean, stddev, mhz;
+
+    if(0U == stat->count) {
+        printf("\r\n%-28s no samples", name);
+        return;
+    }
+    mean = (uint32_t)(stat->sum / stat->count);
+    stddev = bench_isqrt(stat->sum_sq / stat->count - (uint64_t)mean * mean);
+    mhz = SystemCoreClock / 1000000U;
+
+    printf("\r\n%-28s n=%-6lu min %5lu  mean %5lu  max %5lu  sd %4lu  jitter %5lu cyc  (%lu..%lu ns)",
+           name, (unsigned long)stat->count, (unsigned long)stat->min, (unsigned long)mean,
+           (unsigned long)stat->max, (unsigned long)stddev, (unsigned long)(stat->max - stat->min),
+           (unsigned long)(stat->min * 1000U / mhz), (unsigned long)(stat->max * 1000U / mhz));
+}
+
+/*!
+    \brief    run the benchmarks selected at build time, make BENCH=<name>
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void bench_run(void)
+{
+    printf("\r\n\r\nbenchmark build, core clock %lu Hz", (unsigned long)SystemCoreClock);
+
+#ifdef BENCH_IRQ
+    bench_irq_run();
+#endif /* BENCH_IRQ */
+#ifdef BENCH_FASTCODE
+    bench_fastcode_run();
+#endif /* BENCH_FASTCODE */
+#ifdef BENCH_CRC
+    bench_crc_run();
+#endif /* BENCH_CRC */
+#ifdef BENCH_MEMCPY
+    bench_memcpy_run();
+#endif /* BENCH_MEMCPY */
+#ifdef BENCH_ENET
+    bench_enet_run();
+#endif /* BENCH_ENET */
+
+    printf("\r\nbenchmark done\r\n");
+}
+
+#endif /* BENCH */
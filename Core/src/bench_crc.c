@@ -0,0 +1,245 @@
+/*!
+    \file    bench_crc.c
+    \brief   hardware versus software CRC throughput benchmark
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "bench.h"
+#include "crc_engine.h"
+#include "crc_soft.h"
+#include <stdio.h>
+
+#ifdef BENCH_CRC
+
+#define BENCH_CRC_MAX_BLOCK              16384U
+#define BENCH_CRC_RUNS                   20U
+
+typedef uint32_t (*bench_crc_func)(const uint8_t *data, uint32_t len);
+
+/* word aligned so the DMA reads whole words */
+static uint32_t crc_block[BENCH_CRC_MAX_BLOCK / 4U];
+static const uint32_t crc_sizes[] = {16U, 64U, 256U, 1024U, 4096U, 16384U};
+/* set when crc_engine_update_async() refused a job, the DMA row is not timed */
+static uint32_t crc_dma_failed = 0U;
+
+/*!
+    \brief    CRC unit fed by the CPU, unit order
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     checksum
+*/
+static uint32_t bench_crc_hw_word(const uint8_t *data, uint32_t len)
+{
+    return crc_engine_calculate(CRC_ENGINE_WORD, data, len);
+}
+
+/*!
+    \brief    CRC unit fed by the CPU through RBIT, zlib convention
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     checksum
+*/
+static uint32_t bench_crc_hw_zlib(const uint8_t *data, uint32_t len)
+{
+    return crc_engine_calculate(CRC_ENGINE_ZLIB, data, len);
+}
+
+/*!
+    \brief    CRC unit fed by DMA, waits for the job
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     checksum, 0 with crc_dma_failed set when no job was started
+*/
+static uint32_t bench_crc_hw_dma(const uint8_t *data, uint32_t len)
+{
+    crc_engine_ctx_struct ctx;
+
+    crc_engine_start(&ctx, CRC_ENGINE_WORD);
+    if(SUCCESS != crc_engine_update_async(&ctx, data, len, NULL, NULL)) {
+        crc_dma_failed = 1U;
+        return 0U;
+    }
+    while(0U != crc_engine_busy()) {
+    }
+
+    return crc_engine_final(&ctx);
+}
+
+/*!
+    \brief    software zlib CRC-32, one lookup per byte
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     checksum
+*/
+static uint32_t bench_crc_bytewise(const uint8_t *data, uint32_t len)
+{
+    return crc_soft_zlib_bytewise(CRC_SOFT_ZLIB_INIT, data, len);
+}
+
+/*!
+    \brief    software zlib CRC-32, slicing-by-4
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     checksum
+*/
+static uint32_t bench_crc_slice4(const uint8_t *data, uint32_t len)
+{
+    return crc_soft_zlib_slice4(CRC_SOFT_ZLIB_INIT, data, len);
+}
+
+/*!
+    \brief    software zlib CRC-32, slicing-by-8
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     checksum
+*/
+static uint32_t bench_crc_slice8(const uint8_t *data, uint32_t len)
+{
+    return crc_soft_zlib_slice8(CRC_SOFT_ZLIB_INIT, data, len);
+}
+
+/*!
+    \brief    software unit order CRC, slicing-by-8
+    \param[in]  data: bytes
+    \param[in]  len: byte count, a multiple of 4
+    \param[out] none
+    \retval     checksum
+*/
+static uint32_t bench_crc_soft_word(const uint8_t *data, uint32_t len)
+{
+    return crc_soft_word(CRC_SOFT_MPEG2_INIT, data, len / 4U);
+}
+
+/*!
+    \brief    software CRC-16/CCITT-FALSE
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     checksum
+*/
+static uint32_t bench_crc_ccitt(const uint8_t *data, uint32_t len)
+{
+    return crc_soft_ccitt(CRC_SOFT_CCITT_INIT, data, len);
+}
+
+/*!
+    \brief    software CRC-16/MODBUS
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     checksum
+*/
+static uint32_t bench_crc_modbus(const uint8_t *data, uint32_t len)
+{
+    return crc_soft_modbus(CRC_SOFT_MODBUS_INIT, data, len);
+}
+
+/*!
+    \brief    time one implementation over every block size
+    \param[in]  name: implementation name
+    \param[in]  func: implementation
+    \param[out] none
+    \retval     none
+*/
+static void bench_crc(const char *name, bench_crc_func func)
+{
+    bench_stat_struct stat;
+    uint32_t s, i, start, len, check = 0U;
+
+    printf("\r\n%-20s", name);
+    for(s = 0U; s < sizeof(crc_sizes) / sizeof(crc_sizes[0]); s++) {
+        len = crc_sizes[s];
+        bench_stat_reset(&stat);
+        for(i = 0U; i < BENCH_CRC_RUNS; i++) {
+            start = DWT->CYCCNT;
+            check ^= func((const uint8_t *)crc_block, len);
+            bench_stat_add(&stat, DWT->CYCCNT - start);
+        }
+        /* bytes per cycle x100 from the best run */
+        printf(" %6lu.%02lu", (unsigned long)(len / stat.min),
+               (unsigned long)((len * 100U / stat.min) % 100U));
+    }
+    printf("  (check %08lx)", (unsigned long)check);
+}
+
+/*!
+    \brief    CRC throughput benchmark, make BENCH=crc
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void bench_crc_run(void)
+{
+    uint32_t i, s, dma;
+
+    for(i = 0U; i < BENCH_CRC_MAX_BLOCK / 4U; i++) {
+        crc_block[i] = i * 2654435761U;
+    }
+    crc_engine_init();
+
+    /* cross check the conventions before timing them, the DMA only when it took the job */
+    crc_dma_failed = 0U;
+    dma = bench_crc_hw_dma((const uint8_t *)crc_block, 1024U);
+    if((crc_engine_calculate(CRC_ENGINE_ZLIB, crc_block, 1001U) != crc_soft_zlib_slice8(0U, crc_block, 1001U)) ||
+       (crc_engine_calculate(CRC_ENGINE_MPEG2, crc_block, 1001U) != crc_soft_mpeg2(CRC_SOFT_MPEG2_INIT, crc_block, 1001U)) ||
+       ((0U == crc_dma_failed) && (dma != bench_crc_soft_word((const uint8_t *)crc_block, 1024U)))) {
+        printf("\r\nCRC mismatch between the unit and the software tables");
+    }
+
+    printf("\r\nCRC throughput, bytes per cycle\r\n%-20s", "block size");
+    for(s = 0U; s < sizeof(crc_sizes) / sizeof(crc_sizes[0]); s++) {
+        printf(" %9lu", (unsigned long)crc_sizes[s]);
+    }
+    bench_crc("unit, CPU polled", bench_crc_hw_word);
+    bench_crc("unit, CPU zlib RBIT", bench_crc_hw_zlib);
+    if(0U == crc_dma_failed) {
+        bench_crc("unit, DMA", bench_crc_hw_dma);
+    }
+    /* no memory to memory channel was free, or a run was refused */
+    if(0U != crc_dma_failed) {
+        printf("\r\n%-20s unavailable", "unit, DMA");
+    }
+    bench_crc("zlib bytewise", bench_crc_bytewise);
+    bench_crc("zlib slicing-by-4", bench_crc_slice4);
+    bench_crc("zlib slicing-by-8", bench_crc_slice8);
+    bench_crc("unit order by-8", bench_crc_soft_word);
+    bench_crc("CRC-16/CCITT", bench_crc_ccitt);
+    bench_crc("CRC-16/MODBUS", bench_crc_modbus);
+}
+
+#endif /* BENCH_CRC */
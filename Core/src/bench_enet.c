@@ -0,0 +1,302 @@
+/*!
+    \file    bench_enet.c
+    \brief   ENET descriptor ring depth benchmark, make BENCH=enet
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "bench.h"
+#include "section.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef BENCH_ENET
+
+/* ring depths swept, the Rx region is sized for the largest */
+static const uint32_t bench_enet_depth[] = {4U, 8U, 16U, 28U};
+#define BENCH_ENET_DEPTHS                (sizeof(bench_enet_depth) / sizeof(bench_enet_depth[0]))
+#define BENCH_ENET_DEPTH_MAX             28U
+/* one whole frame per Rx descriptor, the consumer reads it from frame.buffer */
+#define BENCH_ENET_RXBUF_SIZE            ENET_MAX_FRAME_SIZE
+#define BENCH_ENET_TXDESC_NUM            8U
+
+#define BENCH_ENET_HEADER                14U
+#define BENCH_ENET_FRAME                 128U
+#define BENCH_ENET_PAYLOAD               (BENCH_ENET_FRAME - BENCH_ENET_HEADER)
+/* local experimental ethertype */
+#define BENCH_ENET_ETHERTYPE             0x88B5U
+/* frames sent back to back at wire speed, then the consumer drains the ring */
+#define BENCH_ENET_BURST                 32U
+#define BENCH_ENET_BURSTS                8U
+/* frames handed to the TxDMA ahead of the wire, keeps the send stamp close to the wire */
+#define BENCH_ENET_TX_AHEAD              2U
+/* simulated protocol work per received frame, about twice the wire time of a frame */
+#define BENCH_ENET_WORK                  4000U
+
+/* descriptor rings and Rx buffers in SRAM2, Tx frames are sent zero-copy from bench_enet_payload */
+static uint8_t bench_enet_rxram[ENET_DESC_REGION_SIZE(BENCH_ENET_DEPTH_MAX, BENCH_ENET_RXBUF_SIZE)] __ENET_RAM;
+static uint8_t bench_enet_txram[ENET_DESC_REGION_SIZE(BENCH_ENET_TXDESC_NUM, 0U)] __ENET_RAM;
+
+/* broadcast from a locally administered address */
+static uint8_t bench_enet_header[BENCH_ENET_HEADER] = {
+    0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU,
+    0x02U, 0x00U, 0x00U, 0x00U, 0x00U, 0x01U,
+    (uint8_t)(BENCH_ENET_ETHERTYPE >> 8), (uint8_t)BENCH_ENET_ETHERTYPE
+};
+/* payload of every frame in a burst: sequence number, send time, filler */
+static uint32_t bench_enet_payload[BENCH_ENET_BURST][(BENCH_ENET_PAYLOAD + 3U) / 4U];
+
+static uint32_t bench_enet_sent;
+static volatile uint32_t bench_enet_done;
+static volatile uint32_t bench_enet_tx_errors;
+
+/*!
+    \brief    RMII pins, clocks and reference clock of the GD32450I-EVAL with the DP83848
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_enet_gpio_config(void)
+{
+    rcu_periph_clock_enable(RCU_GPIOA);
+    rcu_periph_clock_enable(RCU_GPIOB);
+    rcu_periph_clock_enable(RCU_GPIOC);
+    rcu_periph_clock_enable(RCU_GPIOG);
+    rcu_periph_clock_enable(RCU_SYSCFG);
+
+    /* PA8 CKOUT0, 50MHz RMII reference clock for the PHY */
+    gpio_af_set(GPIOA, GPIO_AF_0, GPIO_PIN_8);
+    gpio_mode_set(GPIOA, GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_PIN_8);
+    gpio_output_options_set(GPIOA, GPIO_OTYPE_PP, GPIO_OSPEED_MAX, GPIO_PIN_8);
+    rcu_ckout0_config(RCU_CKOUT0SRC_PLLP, RCU_CKOUT0_DIV4);
+
+    syscfg_enet_phy_interface_config(SYSCFG_ENET_PHY_RMII);
+
+    /* PA1 REF_CLK, PA2 MDIO, PA7 CRS_DV */
+    gpio_af_set(GPIOA, GPIO_AF_11, GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_7);
+    gpio_mode_set(GPIOA, GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_7);
+    gpio_output_options_set(GPIOA, GPIO_OTYPE_PP, GPIO_OSPEED_MAX, GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_7);
+    /* PB11 TX_EN */
+    gpio_af_set(GPIOB, GPIO_AF_11, GPIO_PIN_11);
+    gpio_mode_set(GPIOB, GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_PIN_11);
+    gpio_output_options_set(GPIOB, GPIO_OTYPE_PP, GPIO_OSPEED_MAX, GPIO_PIN_11);
+    /* PC1 MDC, PC4 RXD0, PC5 RXD1 */
+    gpio_af_set(GPIOC, GPIO_AF_11, GPIO_PIN_1 | GPIO_PIN_4 | GPIO_PIN_5);
+    gpio_mode_set(GPIOC, GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_PIN_1 | GPIO_PIN_4 | GPIO_PIN_5);
+    gpio_output_options_set(GPIOC, GPIO_OTYPE_PP, GPIO_OSPEED_MAX, GPIO_PIN_1 | GPIO_PIN_4 | GPIO_PIN_5);
+    /* PG13 TXD0, PG14 TXD1 */
+    gpio_af_set(GPIOG, GPIO_AF_11, GPIO_PIN_13 | GPIO_PIN_14);
+    gpio_mode_set(GPIOG, GPIO_MODE_AF, GPIO_PUPD_NONE, GPIO_PIN_13 | GPIO_PIN_14);
+    gpio_output_options_set(GPIOG, GPIO_OTYPE_PP, GPIO_OSPEED_MAX, GPIO_PIN_13 | GPIO_PIN_14);
+
+    rcu_periph_clock_enable(RCU_ENET);
+    rcu_periph_clock_enable(RCU_ENETTX);
+    rcu_periph_clock_enable(RCU_ENETRX);
+}
+
+/*!
+    \brief    Tx completion, called from enet_txframe_reclaim()
+    \param[in]  arg: unused
+    \param[in]  status: SUCCESS when the frame left the MAC
+    \param[out] none
+    \retval     none
+*/
+static void bench_enet_tx_done(void *arg, ErrStatus status)
+{
+    (void)arg;
+    if(SUCCESS != status) {
+        bench_enet_tx_errors++;
+    }
+    bench_enet_done++;
+}
+
+/*!
+    \brief    the sender side: reclaim finished frames and keep the wire busy until the burst is out
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_enet_feed(void)
+{
+    enet_txseg_struct seg[2];
+    uint32_t *payload;
+
+    (void)enet_txframe_reclaim();
+    while((bench_enet_sent < BENCH_ENET_BURST) && ((bench_enet_sent - bench_enet_done) < BENCH_ENET_TX_AHEAD)) {
+        payload = bench_enet_payload[bench_enet_sent];
+        payload[0] = bench_enet_sent;
+        payload[1] = DWT->CYCCNT;
+        seg[0].buffer = bench_enet_header;
+        seg[0].length = BENCH_ENET_HEADER;
+        seg[1].buffer = (const uint8_t *)payload;
+        seg[1].length = BENCH_ENET_PAYLOAD;
+        if(SUCCESS != enet_frame_transmit_segments(seg, 2U, bench_enet_tx_done, NULL)) {
+            break;
+        }
+        bench_enet_sent++;
+    }
+}
+
+/*!
+    \brief    busy for a number of cycles while the sender keeps going
+    \param[in]  cycles: core cycles
+    \param[out] none
+    \retval     none
+*/
+static void bench_enet_work(uint32_t cycles)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    while((DWT->CYCCNT - start) < cycles) {
+        bench_enet_feed();
+    }
+}
+
+/*!
+    \brief    send one burst and consume the looped back frames
+    \param[in]  none
+    \param[out] latency: send to receive cycles of every frame are added
+    \retval     frames received
+*/
+static uint32_t bench_enet_burst(bench_stat_struct *latency)
+{
+    enet_rxframe_struct frame;
+    uint32_t received = 0U, done = 0U, idle, now, seq, stamp;
+    uint32_t timeout = SystemCoreClock / 1000U;
+
+    bench_enet_sent = 0U;
+    bench_enet_done = 0U;
+    idle = DWT->CYCCNT;
+    for(;;) {
+        bench_enet_feed();
+        now = DWT->CYCCNT;
+        if(SUCCESS == enet_rxframe_loan(&frame)) {
+            if((frame.length >= BENCH_ENET_FRAME) &&
+                    (0 == memcmp(frame.buffer, bench_enet_header, BENCH_ENET_HEADER))) {
+                memcpy(&seq, frame.buffer + BENCH_ENET_HEADER, sizeof(seq));
+                memcpy(&stamp, frame.buffer + BENCH_ENET_HEADER + 4U, sizeof(stamp));
+                if(seq < BENCH_ENET_BURST) {
+                    bench_stat_add(latency, now - stamp);
+                    received++;
+                }
+            }
+            bench_enet_work(BENCH_ENET_WORK);
+            enet_rxframe_return(&frame);
+            idle = DWT->CYCCNT;
+        } else if(done != bench_enet_done) {
+            done = bench_enet_done;
+            idle = now;
+        } else if((BENCH_ENET_BURST == done) && ((now - idle) > timeout)) {
+            /* everything sent and nothing received for a millisecond */
+            break;
+        } else if((now - idle) > (100U * timeout)) {
+            /* the TxDMA is stuck, no link or no reference clock */
+            break;
+        }
+    }
+
+    return received;
+}
+
+/*!
+    \brief    ENET ring depth benchmark, make BENCH=enet
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note      the MAC loops its transmitter back to its receiver at 100M, so
+                the PHY only supplies the reference clock. Bursts of frames
+                arrive faster than the consumer handles them, the Rx ring
+                absorbs the burst: a deeper ring drops less and queues longer.
+                The GD32450I-EVAL takes the 50MHz RMII clock from CKOUT0 =
+                PLLP / 4, which needs the 200MHz system clock of system_gd32f4xx.c
+*/
+void bench_enet_run(void)
+{
+    bench_stat_struct latency;
+    uint32_t d, b, depth, received, fifo_drop, dma_drop, fifo_total, dma_total;
+
+    printf("\r\nENET ring depth, bursts of %lu frames of %lu bytes, %lu cycles per frame consumer",
+           (unsigned long)BENCH_ENET_BURST, (unsigned long)BENCH_ENET_FRAME, (unsigned long)BENCH_ENET_WORK);
+    if(200000000U != SystemCoreClock) {
+        printf("\r\nCKOUT0 cannot make the 50MHz RMII clock at this core clock, skipped");
+        return;
+    }
+
+    for(b = 0U; b < BENCH_ENET_BURST; b++) {
+        for(d = 2U; d < ((BENCH_ENET_PAYLOAD + 3U) / 4U); d++) {
+            bench_enet_payload[b][d] = b * 0x01010101U + d;
+        }
+    }
+
+    bench_enet_gpio_config();
+    enet_deinit();
+    if((SUCCESS != enet_software_reset()) ||
+            (SUCCESS != enet_init(ENET_100M_FULLDUPLEX, ENET_NO_AUTOCHECKSUM, ENET_BROADCAST_FRAMES_PASS))) {
+        printf("\r\nENET or PHY does not respond, skipped");
+        return;
+    }
+    ENET_MAC_CFG |= ENET_MAC_CFG_LBM;
+
+    for(d = 0U; d < BENCH_ENET_DEPTHS; d++) {
+        enet_disable();
+        depth = enet_descriptors_region_init(ENET_DMA_RX, bench_enet_rxram,
+                                             ENET_DESC_REGION_SIZE(bench_enet_depth[d], BENCH_ENET_RXBUF_SIZE),
+                                             BENCH_ENET_RXBUF_SIZE);
+        (void)enet_descriptors_region_init(ENET_DMA_TX, bench_enet_txram, sizeof(bench_enet_txram), 0U);
+        /* the missed frame counters clear on read */
+        enet_missed_frame_counter_get(&fifo_drop, &dma_drop);
+        enet_enable();
+
+        bench_stat_reset(&latency);
+        bench_enet_tx_errors = 0U;
+        received = 0U;
+        fifo_total = 0U;
+        dma_total = 0U;
+        for(b = 0U; b < BENCH_ENET_BURSTS; b++) {
+            received += bench_enet_burst(&latency);
+            enet_missed_frame_counter_get(&fifo_drop, &dma_drop);
+            fifo_total += fifo_drop;
+            dma_total += dma_drop;
+        }
+
+        printf("\r\ndepth %2lu: sent %lu, received %lu, dropped %lu (%lu%%), no descriptor %lu, fifo overflow %lu, tx errors %lu",
+               (unsigned long)depth, (unsigned long)(BENCH_ENET_BURST * BENCH_ENET_BURSTS), (unsigned long)received,
+               (unsigned long)(BENCH_ENET_BURST * BENCH_ENET_BURSTS - received),
+               (unsigned long)((BENCH_ENET_BURST * BENCH_ENET_BURSTS - received) * 100U / (BENCH_ENET_BURST * BENCH_ENET_BURSTS)),
+               (unsigned long)dma_total, (unsigned long)fifo_total, (unsigned long)bench_enet_tx_errors);
+        bench_stat_print("latency", &latency);
+    }
+
+    enet_disable();
+    ENET_MAC_CFG &= ~ENET_MAC_CFG_LBM;
+}
+
+#endif /* BENCH_ENET */
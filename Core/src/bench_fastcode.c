@@ -0,0 +1,124 @@
+/*!
+    \file    bench_fastcode.c
+    \brief   cycle counts of the same kernel run from each code placement
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "bench.h"
+#include "section.h"
+#include <stdio.h>
+
+#ifdef BENCH_FASTCODE
+
+#define BENCH_FIR_TAPS                   32U
+#define BENCH_FIR_SAMPLES                256U
+#define BENCH_FASTCODE_RUNS              100U
+
+/* code behind the zero wait state flash area, see .slowcode in gd32f4xx_flash.ld */
+#define __FLASH_WAITSTATE                __attribute__((section(".slowcode"), noinline))
+
+/* the same q15 FIR filter, instantiated once per placement */
+#define BENCH_FIR_DEFINE(name, placement)                                                 \
+    placement static int32_t name(const int16_t *x, const int16_t *h, int16_t *y)        \
+    {                                                                                     \
+        uint32_t n, k;                                                                    \
+        int32_t acc, sum = 0;                                                             \
+        for(n = 0U; n < BENCH_FIR_SAMPLES - BENCH_FIR_TAPS; n++) {                       \
+            acc = 0;                                                                      \
+            for(k = 0U; k < BENCH_FIR_TAPS; k++) {                                        \
+                acc += (int32_t)x[n + k] * h[k];                                          \
+            }                                                                             \
+            y[n] = (int16_t)(acc >> 15);                                                  \
+            sum += y[n];                                                                  \
+        }                                                                                 \
+        return sum;                                                                       \
+    }
+
+BENCH_FIR_DEFINE(fir_flash_nowait, __FLASH_NOWAIT)
+BENCH_FIR_DEFINE(fir_flash_waitstate, __FLASH_WAITSTATE)
+BENCH_FIR_DEFINE(fir_sram, __FASTCODE)
+
+typedef int32_t (*bench_fir_func)(const int16_t *x, const int16_t *h, int16_t *y);
+
+static int16_t fir_input[BENCH_FIR_SAMPLES];
+static int16_t fir_coeff[BENCH_FIR_TAPS];
+static int16_t fir_output[BENCH_FIR_SAMPLES];
+
+/*!
+    \brief    time one placement of the FIR kernel
+    \param[in]  name: placement name
+    \param[in]  func: kernel instance
+    \param[out] none
+    \retval     none
+*/
+static void bench_fir(const char *name, bench_fir_func func)
+{
+    bench_stat_struct stat;
+    uint32_t i, start;
+    int32_t check = 0;
+
+    bench_stat_reset(&stat);
+    for(i = 0U; i < BENCH_FASTCODE_RUNS; i++) {
+        start = DWT->CYCCNT;
+        check = func(fir_input, fir_coeff, fir_output);
+        bench_stat_add(&stat, DWT->CYCCNT - start);
+    }
+
+    bench_stat_print(name, &stat);
+    printf("  @0x%08lx check %ld", (unsigned long)(uintptr_t)func, (long)check);
+}
+
+/*!
+    \brief    code placement benchmark, make BENCH=fastcode
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void bench_fastcode_run(void)
+{
+    uint32_t i;
+
+    for(i = 0U; i < BENCH_FIR_SAMPLES; i++) {
+        fir_input[i] = (int16_t)((i * 2654435761U) >> 17);
+    }
+    for(i = 0U; i < BENCH_FIR_TAPS; i++) {
+        fir_coeff[i] = (int16_t)(1024 - (int32_t)(i * 64U));
+    }
+
+    printf("\r\ncode placement, %lu tap FIR over %lu samples",
+           (unsigned long)BENCH_FIR_TAPS, (unsigned long)BENCH_FIR_SAMPLES);
+    bench_fir("flash, zero wait state", fir_flash_nowait);
+    bench_fir("flash, wait state area", fir_flash_waitstate);
+    bench_fir("SRAM (.fastcode)", fir_sram);
+}
+
+#endif /* BENCH_FASTCODE */
@@ -0,0 +1,358 @@
+/*!
+    \file    bench_irq.c
+    \brief   interrupt entry latency, tail-chaining and jitter benchmark
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "bench.h"
+#include "systick.h"
+#include <stdio.h>
+
+#ifdef BENCH_IRQ
+
+/* samples per series */
+#define BENCH_IRQ_SAMPLES                1000U
+
+/* otherwise unused vectors triggered through NVIC->STIR */
+#define BENCH_IRQ_A                      TLI_IRQn
+#define BENCH_IRQ_B                      TLI_ER_IRQn
+#define BENCH_IRQ_HIGH                   IPA_IRQn
+/* EXTI line raised by software */
+#define BENCH_IRQ_EXTI_LINE              EXTI_1
+#define BENCH_IRQ_EXTI                   EXTI1_IRQn
+/* basic timer whose update event is timed */
+#define BENCH_IRQ_TIMER                  TIMER6
+#define BENCH_IRQ_TIMER_IRQ              TIMER6_IRQn
+#define BENCH_IRQ_TIMER_CLK              RCU_TIMER6
+#define BENCH_IRQ_TIMER_PERIOD           4999U
+
+typedef enum {
+    BENCH_MODE_OFF = 0,
+    BENCH_MODE_ENTRY,                                                  /*!< A only */
+    BENCH_MODE_TAIL_CHAIN,                                             /*!< A then B back to back */
+    BENCH_MODE_PREEMPT                                                 /*!< A raises HIGH */
+} bench_mode_enum;
+
+static volatile uint32_t bench_mode = BENCH_MODE_OFF;
+static volatile uint32_t t_trigger, t_entry_a, t_exit_a, t_entry_b, t_entry_high;
+static volatile uint32_t timer_ticks;
+static volatile uint32_t bench_done;
+/* cycles between two back to back DWT->CYCCNT reads, removed from every sample */
+static uint32_t read_overhead;
+
+static bench_stat_struct systick_stat;
+static volatile uint32_t systick_probe = 0U;
+
+/*!
+    \brief    this function handles the TLI interrupt, benchmark vector A
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void TLI_IRQHandler(void)
+{
+    t_entry_a = DWT->CYCCNT;
+
+    if(BENCH_MODE_PREEMPT == bench_mode) {
+        t_trigger = DWT->CYCCNT;
+        NVIC->STIR = BENCH_IRQ_HIGH;
+        __DSB();
+        __ISB();
+    }
+
+    t_exit_a = DWT->CYCCNT;
+    bench_done = 1U;
+}
+
+/*!
+    \brief    this function handles the TLI error interrupt, benchmark vector B
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void TLI_ER_IRQHandler(void)
+{
+    t_entry_b = DWT->CYCCNT;
+    bench_done = 2U;
+}
+
+/*!
+    \brief    this function handles the IPA interrupt, high priority benchmark vector
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void IPA_IRQHandler(void)
+{
+    t_entry_high = DWT->CYCCNT;
+}
+
+/*!
+    \brief    this function handles EXTI line 1, raised by software
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void EXTI1_IRQHandler(void)
+{
+    t_entry_a = DWT->CYCCNT;
+    exti_interrupt_flag_clear(BENCH_IRQ_EXTI_LINE);
+    exti_software_interrupt_disable(BENCH_IRQ_EXTI_LINE);
+    bench_done = 1U;
+}
+
+/*!
+    \brief    this function handles the TIMER6 update interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void TIMER6_IRQHandler(void)
+{
+    /* the counter restarted at the update event, it now holds the entry delay */
+    timer_ticks = TIMER_CNT(BENCH_IRQ_TIMER);
+    timer_interrupt_flag_clear(BENCH_IRQ_TIMER, TIMER_INT_FLAG_UP);
+    bench_done = 1U;
+}
+
+/*!
+    \brief    SysTick entry probe, first statement of SysTick_Handler in the irq benchmark build
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void bench_irq_systick_probe(void)
+{
+    /* the counter reloaded when the exception was raised */
+    uint32_t cycles = SysTick->LOAD - SysTick->VAL;
+
+    if(0U != systick_probe) {
+        bench_stat_add(&systick_stat, cycles);
+    }
+}
+
+/*!
+    \brief    wait for the benchmark handler with a bounded spin
+    \param[in]  value: bench_done value to wait for
+    \param[out] none
+    \retval     none
+*/
+static void bench_wait(uint32_t value)
+{
+    uint32_t spin = 100000U;
+
+    while((value != bench_done) && (0U != --spin)) {
+    }
+}
+
+static inline uint32_t bench_sub(uint32_t cycles)
+{
+    return (cycles > read_overhead) ? cycles - read_overhead : 0U;
+}
+
+/*!
+    \brief    entry latency of a software triggered NVIC interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_stir(void)
+{
+    bench_stat_struct entry, tail, preempt;
+    uint32_t i;
+
+    bench_stat_reset(&entry);
+    bench_stat_reset(&tail);
+    bench_stat_reset(&preempt);
+
+    /* entry latency from the STIR write */
+    bench_mode = BENCH_MODE_ENTRY;
+    for(i = 0U; i < BENCH_IRQ_SAMPLES; i++) {
+        bench_done = 0U;
+        t_trigger = DWT->CYCCNT;
+        NVIC->STIR = BENCH_IRQ_A;
+        bench_wait(1U);
+        bench_stat_add(&entry, bench_sub(t_entry_a - t_trigger));
+    }
+
+    /* A and B pended together at the same priority, B is tail-chained behind A */
+    bench_mode = BENCH_MODE_TAIL_CHAIN;
+    for(i = 0U; i < BENCH_IRQ_SAMPLES; i++) {
+        bench_done = 0U;
+        __disable_irq();
+        NVIC->STIR = BENCH_IRQ_A;
+        NVIC->STIR = BENCH_IRQ_B;
+        __DSB();
+        __enable_irq();
+        bench_wait(2U);
+        bench_stat_add(&tail, bench_sub(t_entry_b - t_exit_a));
+    }
+
+    /* A raises a higher preemption priority vector from inside its handler */
+    bench_mode = BENCH_MODE_PREEMPT;
+    for(i = 0U; i < BENCH_IRQ_SAMPLES; i++) {
+        bench_done = 0U;
+        NVIC->STIR = BENCH_IRQ_A;
+        bench_wait(1U);
+        bench_stat_add(&preempt, bench_sub(t_entry_high - t_trigger));
+    }
+    bench_mode = BENCH_MODE_OFF;
+
+    bench_stat_print("NVIC STIR entry", &entry);
+    bench_stat_print("tail-chain A->B", &tail);
+    bench_stat_print("nested preemption", &preempt);
+}
+
+/*!
+    \brief    entry latency of an EXTI software interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_exti(void)
+{
+    bench_stat_struct entry;
+    uint32_t i;
+
+    bench_stat_reset(&entry);
+    exti_init(BENCH_IRQ_EXTI_LINE, EXTI_INTERRUPT, EXTI_TRIG_NONE);
+    exti_interrupt_flag_clear(BENCH_IRQ_EXTI_LINE);
+
+    for(i = 0U; i < BENCH_IRQ_SAMPLES; i++) {
+        bench_done = 0U;
+        t_trigger = DWT->CYCCNT;
+        exti_software_interrupt_enable(BENCH_IRQ_EXTI_LINE);
+        bench_wait(1U);
+        bench_stat_add(&entry, bench_sub(t_entry_a - t_trigger));
+    }
+    exti_interrupt_disable(BENCH_IRQ_EXTI_LINE);
+
+    bench_stat_print("EXTI software interrupt", &entry);
+}
+
+/*!
+    \brief    entry latency of a timer update interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_timer(void)
+{
+    timer_parameter_struct timer_initpara;
+    bench_stat_struct entry;
+    uint32_t timer_clk, i;
+
+    bench_stat_reset(&entry);
+
+    /* APB1 timers run at twice the APB1 clock unless APB1 is undivided */
+    timer_clk = rcu_clock_freq_get(CK_APB1);
+    if(RCU_APB1_CKAHB_DIV1 != (RCU_CFG0 & RCU_CFG0_APB1PSC)) {
+        timer_clk *= 2U;
+    }
+
+    rcu_periph_clock_enable(BENCH_IRQ_TIMER_CLK);
+    timer_deinit(BENCH_IRQ_TIMER);
+    timer_struct_para_init(&timer_initpara);
+    timer_initpara.prescaler = 0U;
+    timer_initpara.period = BENCH_IRQ_TIMER_PERIOD;
+    timer_init(BENCH_IRQ_TIMER, &timer_initpara);
+    timer_interrupt_flag_clear(BENCH_IRQ_TIMER, TIMER_INT_FLAG_UP);
+    timer_interrupt_enable(BENCH_IRQ_TIMER, TIMER_INT_UP);
+    timer_enable(BENCH_IRQ_TIMER);
+
+    for(i = 0U; i < BENCH_IRQ_SAMPLES; i++) {
+        bench_done = 0U;
+        bench_wait(1U);
+        bench_stat_add(&entry, (uint32_t)(((uint64_t)timer_ticks * SystemCoreClock) / timer_clk));
+    }
+    timer_disable(BENCH_IRQ_TIMER);
+
+    printf("\r\ntimer clock %lu Hz, resolution %lu cycles", (unsigned long)timer_clk,
+           (unsigned long)(SystemCoreClock / timer_clk));
+    bench_stat_print("TIMER6 update", &entry);
+}
+
+/*!
+    \brief    entry latency of SysTick_Handler in gd32f4xx_it.c
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void bench_systick(void)
+{
+    bench_stat_reset(&systick_stat);
+    systick_probe = 1U;
+    delay_1ms(BENCH_IRQ_SAMPLES);
+    systick_probe = 0U;
+
+    bench_stat_print("SysTick_Handler (from WFI)", &systick_stat);
+}
+
+/*!
+    \brief    interrupt latency and jitter benchmark, make BENCH=irq
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note      the core clock is chosen at build time by the __SYSTEM_CLOCK_xxx defines in
+                system_gd32f4xx.c, rebuild with 168, 200 or 240 MHz selected to compare
+*/
+void bench_irq_run(void)
+{
+    uint32_t a, b;
+
+    a = DWT->CYCCNT;
+    b = DWT->CYCCNT;
+    read_overhead = b - a;
+
+    nvic_priority_group_set(NVIC_PRIGROUP_PRE2_SUB2);
+    nvic_irq_enable(BENCH_IRQ_A, 2U, 0U);
+    nvic_irq_enable(BENCH_IRQ_B, 2U, 1U);
+    nvic_irq_enable(BENCH_IRQ_HIGH, 1U, 0U);
+    nvic_irq_enable(BENCH_IRQ_EXTI, 2U, 0U);
+    nvic_irq_enable(BENCH_IRQ_TIMER_IRQ, 2U, 0U);
+
+    printf("\r\ninterrupt latency, priority group %lu, DWT read overhead %lu cycles removed",
+           (unsigned long)((SCB->AIRCR >> 8) & 0x7U), (unsigned long)read_overhead);
+
+    bench_stir();
+    bench_exti();
+    bench_timer();
+    bench_systick();
+
+    nvic_irq_disable(BENCH_IRQ_A);
+    nvic_irq_disable(BENCH_IRQ_B);
+    nvic_irq_disable(BENCH_IRQ_HIGH);
+    nvic_irq_disable(BENCH_IRQ_EXTI);
+    nvic_irq_disable(BENCH_IRQ_TIMER_IRQ);
+}
+
+#endif /* BENCH_IRQ */
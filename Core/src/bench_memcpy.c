@@ -0,0 +1,254 @@
+/*!
+    \file    bench_memcpy.c
+    \brief   CPU versus DMA memory copy throughput benchmark per SRAM bank pair
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "bench.h"
+#include "dma_copy.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef BENCH_MEMCPY
+
+#define BENCH_MEMCPY_SIZE                4096U
+/* bytes copied, leaves room for the misaligned sources inside the source window */
+#define BENCH_MEMCPY_LEN                 (BENCH_MEMCPY_SIZE - 16U)
+#define BENCH_MEMCPY_RUNS                8U
+/* every bank lends its top 2 x BENCH_MEMCPY_SIZE bytes: source window below, destination above */
+#define BENCH_MEMCPY_WINDOW              (2U * BENCH_MEMCPY_SIZE)
+
+/* SRAM banks of the GD32F470, each a separate slave of the bus matrix */
+typedef struct {
+    const char *name;                                                  /*!< bank name */
+    uint32_t base;                                                     /*!< first address */
+    uint32_t size;                                                     /*!< bytes */
+} bench_memcpy_bank_struct;
+
+static const bench_memcpy_bank_struct bench_memcpy_bank[] = {
+    {"SRAM0", 0x20000000U, 0x0001C000U},
+    {"SRAM1", 0x2001C000U, 0x00004000U},
+    {"SRAM2", 0x20020000U, 0x00010000U},
+    {"ADDSRAM", 0x20030000U, 0x00040000U}
+};
+#define BENCH_MEMCPY_BANKS               (sizeof(bench_memcpy_bank) / sizeof(bench_memcpy_bank[0]))
+
+/* end of the RAM used by the image, see gd32f4xx_flash.ld */
+extern uint8_t _heap_end[];
+
+/*!
+    \brief    source window of a bank
+    \param[in]  bank: bank index
+    \param[out] none
+    \retval     address, NULL when the image overlaps the window
+*/
+static uint8_t *bench_memcpy_src(uint32_t bank)
+{
+    uint32_t addr = bench_memcpy_bank[bank].base + bench_memcpy_bank[bank].size - BENCH_MEMCPY_WINDOW;
+
+    return (addr < (uint32_t)_heap_end) ? NULL : (uint8_t *)addr;
+}
+
+/*!
+    \brief    MB/s of len bytes in cycles
+    \param[in]  len: bytes
+    \param[in]  cycles: core cycles
+    \param[out] none
+    \retval     bytes per microsecond
+*/
+static uint32_t bench_memcpy_rate(uint32_t len, uint32_t cycles)
+{
+    return (uint32_t)(((uint64_t)len * (SystemCoreClock / 1000000U)) / cycles);
+}
+
+/*!
+    \brief    best of BENCH_MEMCPY_RUNS DMA copies, checked against the source
+    \param[in]  dst: destination
+    \param[in]  src: source
+    \param[in]  len: bytes
+    \param[out] none
+    \retval     MB/s, 0 on a mismatch
+*/
+static uint32_t bench_memcpy_dma(uint8_t *dst, const uint8_t *src, uint32_t len)
+{
+    dma_copy_req_struct req;
+    uint32_t i, start, cycles, best = 0xFFFFFFFFU;
+
+    memset(&req, 0, sizeof(req));
+    for(i = 0U; i < BENCH_MEMCPY_RUNS; i++) {
+        memset(dst, 0, len);
+        start = DWT->CYCCNT;
+        (void)dma_copy_memcpy_async(&req, dst, src, len, NULL, NULL);
+        dma_copy_wait(&req);
+        cycles = DWT->CYCCNT - start;
+        if(cycles < best) {
+            best = cycles;
+        }
+        if(0 != memcmp(dst, src, len)) {
+            return 0U;
+        }
+    }
+
+    return bench_memcpy_rate(len, best);
+}
+
+/*!
+    \brief    best of BENCH_MEMCPY_RUNS CPU copies
+    \param[in]  dst: destination
+    \param[in]  src: source
+    \param[in]  len: bytes
+    \param[out] none
+    \retval     MB/s
+*/
+static uint32_t bench_memcpy_cpu(uint8_t *dst, const uint8_t *src, uint32_t len)
+{
+    uint32_t i, start, cycles, best = 0xFFFFFFFFU;
+
+    for(i = 0U; i < BENCH_MEMCPY_RUNS; i++) {
+        start = DWT->CYCCNT;
+        memcpy(dst, src, len);
+        cycles = DWT->CYCCNT - start;
+        if(cycles < best) {
+            best = cycles;
+        }
+    }
+
+    return bench_memcpy_rate(len, best);
+}
+
+/*!
+    \brief    best of BENCH_MEMCPY_RUNS DMA fills
+    \param[in]  dst: destination
+    \param[in]  len: bytes
+    \param[out] none
+    \retval     MB/s
+*/
+static uint32_t bench_memset_dma(uint8_t *dst, uint32_t len)
+{
+    dma_copy_req_struct req;
+    uint32_t i, start, cycles, best = 0xFFFFFFFFU;
+
+    memset(&req, 0, sizeof(req));
+    for(i = 0U; i < BENCH_MEMCPY_RUNS; i++) {
+        start = DWT->CYCCNT;
+        (void)dma_copy_memset_async(&req, dst, (uint8_t)i, len, NULL, NULL);
+        dma_copy_wait(&req);
+        cycles = DWT->CYCCNT - start;
+        if(cycles < best) {
+            best = cycles;
+        }
+    }
+
+    return bench_memcpy_rate(len, best);
+}
+
+/*!
+    \brief    best of BENCH_MEMCPY_RUNS CPU fills
+    \param[in]  dst: destination
+    \param[in]  len: bytes
+    \param[out] none
+    \retval     MB/s
+*/
+static uint32_t bench_memset_cpu(uint8_t *dst, uint32_t len)
+{
+    uint32_t i, start, cycles, best = 0xFFFFFFFFU;
+
+    for(i = 0U; i < BENCH_MEMCPY_RUNS; i++) {
+        start = DWT->CYCCNT;
+        memset(dst, (int)i, len);
+        cycles = DWT->CYCCNT - start;
+        if(cycles < best) {
+            best = cycles;
+        }
+    }
+
+    return bench_memcpy_rate(len, best);
+}
+
+/*!
+    \brief    memory copy benchmark, make BENCH=memcpy
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note      the DMA columns differ in source alignment: 16 byte aligned runs
+                4 beat bursts on both sides, word aligned single word reads and
+                unaligned byte reads packed by the FIFO
+*/
+void bench_memcpy_run(void)
+{
+    uint32_t crossover, s, d, i;
+    uint8_t *src, *dst;
+
+    dma_copy_init();
+    crossover = dma_copy_crossover_get();
+    printf("\r\nmemory copy, %lu bytes, MB/s, measured crossover %lu bytes",
+           (unsigned long)BENCH_MEMCPY_LEN, (unsigned long)crossover);
+    dma_copy_crossover_set(0U);
+
+    printf("\r\n%-18s %8s %8s %8s %8s", "source -> dest", "CPU", "burst", "word", "byte");
+    for(s = 0U; s < BENCH_MEMCPY_BANKS; s++) {
+        src = bench_memcpy_src(s);
+        if(NULL == src) {
+            printf("\r\n%-8s in use by the image, skipped", bench_memcpy_bank[s].name);
+            continue;
+        }
+        for(i = 0U; i < BENCH_MEMCPY_SIZE; i++) {
+            src[i] = (uint8_t)(i * 131U + s);
+        }
+        for(d = 0U; d < BENCH_MEMCPY_BANKS; d++) {
+            if(NULL == bench_memcpy_src(d)) {
+                continue;
+            }
+            dst = bench_memcpy_src(d) + BENCH_MEMCPY_SIZE;
+            printf("\r\n%-8s-> %-8s %8lu %8lu %8lu %8lu", bench_memcpy_bank[s].name, bench_memcpy_bank[d].name,
+                   (unsigned long)bench_memcpy_cpu(dst, src, BENCH_MEMCPY_LEN),
+                   (unsigned long)bench_memcpy_dma(dst, src, BENCH_MEMCPY_LEN),
+                   (unsigned long)bench_memcpy_dma(dst, src + 4U, BENCH_MEMCPY_LEN),
+                   (unsigned long)bench_memcpy_dma(dst, src + 1U, BENCH_MEMCPY_LEN));
+        }
+    }
+
+    printf("\r\n%-18s %8s %8s", "fill", "CPU", "DMA");
+    for(d = 0U; d < BENCH_MEMCPY_BANKS; d++) {
+        if(NULL == bench_memcpy_src(d)) {
+            continue;
+        }
+        dst = bench_memcpy_src(d) + BENCH_MEMCPY_SIZE;
+        printf("\r\n%-18s %8lu %8lu", bench_memcpy_bank[d].name,
+               (unsigned long)bench_memset_cpu(dst, BENCH_MEMCPY_LEN),
+               (unsigned long)bench_memset_dma(dst, BENCH_MEMCPY_LEN));
+    }
+
+    dma_copy_crossover_set(crossover);
+}
+
+#endif /* BENCH_MEMCPY */
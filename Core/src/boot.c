@@ -0,0 +1,96 @@
+/*!
+    \file    boot.c
+    \brief   boot phase timestamps taken by Reset_Handler
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "boot.h"
+#include "section.h"
+#include <stdio.h>
+
+/* written by Reset_Handler before .bss is cleared, hence not zero initialized */
+__NOINIT boot_time_struct boot_time;
+
+/*!
+    \brief    get the boot phase timestamps of the last reset
+    \param[in]  none
+    \param[out] none
+    \retval     DWT->CYCCNT value at the end of each phase
+*/
+const boot_time_struct *boot_time_get(void)
+{
+    return &boot_time;
+}
+
+/*!
+    \brief    print one boot phase
+    \param[in]  name: phase name
+    \param[in]  cycles: phase duration in core cycles
+    \param[in]  clock: core clock during the phase in Hz
+    \param[out] none
+    \retval     none
+*/
+static void boot_phase_print(const char *name, uint32_t cycles, uint32_t clock)
+{
+    printf("\r\n  %-24s %8lu cycles %6lu us", name, (unsigned long)cycles,
+           (unsigned long)(((uint64_t)cycles * 1000000U) / clock));
+}
+
+/*!
+    \brief    print the boot phase durations and the reset source
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note      call before systick_config(), which restarts DWT->CYCCNT
+*/
+void boot_time_print(void)
+{
+    uint32_t now = DWT->CYCCNT;
+
+    printf("\r\nreset source:%s%s%s%s%s%s%s",
+           (SET == rcu_flag_get(RCU_FLAG_PORRST)) ? " power" : "",
+           (SET == rcu_flag_get(RCU_FLAG_BORRST)) ? " brownout" : "",
+           (SET == rcu_flag_get(RCU_FLAG_EPRST)) ? " pin" : "",
+           (SET == rcu_flag_get(RCU_FLAG_SWRST)) ? " software" : "",
+           (SET == rcu_flag_get(RCU_FLAG_FWDGTRST)) ? " fwdgt" : "",
+           (SET == rcu_flag_get(RCU_FLAG_WWDGTRST)) ? " wwdgt" : "",
+           (SET == rcu_flag_get(RCU_FLAG_LPRST)) ? " low-power" : "");
+    rcu_all_reset_flag_clear();
+
+    /* Reset_Handler runs on IRC16M until SystemInit has switched the clock */
+    printf("\r\nboot phases:");
+    boot_phase_print("SystemInit", boot_time.clock - boot_time.reset, IRC16M_VALUE);
+    boot_phase_print("copy .fastcode/.data", boot_time.copy - boot_time.clock, SystemCoreClock);
+    boot_phase_print("zero .bss", boot_time.zero - boot_time.copy, SystemCoreClock);
+    boot_phase_print("static constructors", boot_time.main - boot_time.zero, SystemCoreClock);
+    boot_phase_print("main to first print", now - boot_time.main, SystemCoreClock);
+}
@@ -0,0 +1,165 @@
+/*!
+    \file    console.c
+    \brief   console on EVAL_COM0, a thin layer over the serial port driver
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "console.h"
+#include "gd32f450i_eval.h"
+
+/* the ring and the receive buffer are accessed by DMA, keep them in SRAM */
+static uint8_t console_buffer[CONSOLE_BUFFER_SIZE];
+static uint8_t console_rx_buffer[CONSOLE_RX_BUFFER_SIZE];
+
+/*!
+    \brief    open EVAL_COM0 with a DMA transmit ring and stream mode reception
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void console_init(void)
+{
+    serial_parameter_struct para;
+
+    serial_struct_para_init(CONSOLE_PORT, &para);
+    para.tx_gpio = EVAL_COM0_GPIO_PORT;
+    para.tx_pin = EVAL_COM0_TX_PIN;
+    para.rx_gpio = EVAL_COM0_GPIO_PORT;
+    para.rx_pin = EVAL_COM0_RX_PIN;
+    para.af = EVAL_COM0_AF;
+    para.tx_buffer = console_buffer;
+    para.tx_size = CONSOLE_BUFFER_SIZE;
+    /* stream mode reception for _read(), bytes wait in the DMA buffer */
+    para.rx_buffer = console_rx_buffer;
+    para.rx_size = CONSOLE_RX_BUFFER_SIZE;
+    serial_open(CONSOLE_PORT, &para);
+}
+
+/*!
+    \brief    select the full ring policy
+    \param[in]  policy: SERIAL_POLICY_DROP, SERIAL_POLICY_BLOCK or SERIAL_POLICY_OVERWRITE
+    \param[out] none
+    \retval     none
+*/
+void console_policy_set(serial_policy_enum policy)
+{
+    serial_policy_set(CONSOLE_PORT, policy);
+}
+
+/*!
+    \brief    queue bytes for transmission, callable from any context
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     bytes accepted, len or 0
+*/
+uint32_t console_write(const void *data, uint32_t len)
+{
+    return serial_write(CONSOLE_PORT, data, len);
+}
+
+/*!
+    \brief    bytes console_write() can accept right now
+    \param[in]  none
+    \param[out] none
+    \retval     free ring space in bytes
+*/
+uint32_t console_free(void)
+{
+    return serial_free(CONSOLE_PORT);
+}
+
+/*!
+    \brief    wait until everything queued has left the USART, thread mode only
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void console_flush(void)
+{
+    serial_flush(CONSOLE_PORT);
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  none
+    \param[out] stat: copy of the counters
+    \retval     none
+*/
+void console_stat_get(serial_stat_struct *stat)
+{
+    serial_stat_get(CONSOLE_PORT, stat);
+}
+
+/*!
+    \brief    copy received bytes
+    \param[in]  len: room in data
+    \param[out] data: destination
+    \retval     bytes copied, 0 when nothing is waiting
+*/
+uint32_t console_read(uint8_t *data, uint32_t len)
+{
+    return serial_read(CONSOLE_PORT, data, len);
+}
+
+/*!
+    \brief    bulk output hook of _write() in syscalls.c, printf lands here
+    \param[in]  ptr: characters
+    \param[in]  len: character count
+    \param[out] none
+    \retval     characters consumed
+*/
+int __io_write(char *ptr, int len)
+{
+    console_write(ptr, (uint32_t)len);
+
+    /* report everything as written, dropped output is counted and newlib must not retry */
+    return len;
+}
+
+/*!
+    \brief    bulk input hook of _read() in syscalls.c, scanf and getchar land here
+    \param[in]  len: room in ptr
+    \param[out] ptr: characters
+    \retval     characters read, at least one
+*/
+int __io_read(char *ptr, int len)
+{
+    uint32_t count;
+
+    /* block until something arrived, like a terminal read */
+    while(0U == (count = console_read((uint8_t *)ptr, (uint32_t)len))) {
+        __WFI();
+    }
+
+    return (int)count;
+}
@@ -0,0 +1,485 @@
+/*!
+    \file    crc_engine.c
+    \brief   CRC unit service with DMA feeding and byte granular input
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "crc_engine.h"
+#include "ring.h"
+#include "crc_soft.h"
+#include "dma_mgr.h"
+#include "section.h"
+#include <stddef.h>
+#include <string.h>
+
+#define CRC_ENGINE_POLY                  0x04C11DB7U
+#define CRC_ENGINE_INIT                  0xFFFFFFFFU
+/* below this many bytes a resumed context stays in software, seeding the unit takes 32 shift steps */
+#ifndef CRC_ENGINE_SEED_BYTES
+#define CRC_ENGINE_SEED_BYTES            64U
+#endif
+/* CHCNT is 16 bits, byte sized reads keep whole words per chunk */
+#define CRC_ENGINE_CHUNK_WORDS           0xFFFFU
+#define CRC_ENGINE_CHUNK_BYTES           0xFFFCU
+
+/* running DMA job */
+typedef struct {
+    crc_engine_ctx_struct *ctx;                                        /*!< context being updated */
+    const uint8_t *src;                                                /*!< next source byte */
+    uint32_t remaining;                                                /*!< bytes still to transfer */
+    uint32_t state;                                                    /*!< CRC_DATA value before the running transfer */
+    uint32_t chunk;                                                    /*!< bytes of the running transfer */
+    uint32_t aligned;                                                  /*!< word reads, else byte reads packed by the FIFO */
+    crc_engine_callback callback;                                      /*!< completion */
+    void *arg;                                                         /*!< callback argument */
+} crc_engine_job_struct;
+
+static volatile uint32_t crc_engine_owner = 0U;
+static crc_engine_job_struct crc_engine_job;
+/* memory to memory channel feeding CRC_DATA, request DMA_MGR_REQUEST_NUM until allocated */
+static dma_mgr_channel_struct crc_engine_dma = {DMA1, DMA_CH0, DMA_SUBPERI0, DMA_MGR_REQUEST_NUM};
+static crc_engine_stat_struct crc_engine_stat;
+
+/*!
+    \brief    take the CRC unit
+    \param[in]  none
+    \param[out] none
+    \retval     1 when taken, 0 when a DMA job or a preempted caller holds it
+*/
+static uint32_t crc_engine_claim(void)
+{
+    do {
+        if(0U != __LDREXW(&crc_engine_owner)) {
+            __CLREX();
+            return 0U;
+        }
+    } while(0U != __STREXW(1U, &crc_engine_owner));
+    __DMB();
+
+    return 1U;
+}
+
+/*!
+    \brief    give the CRC unit back
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void crc_engine_release(void)
+{
+    __DMB();
+    crc_engine_owner = 0U;
+}
+
+/*!
+    \brief    load an arbitrary state into the unit
+    \param[in]  state: CRC_DATA value to continue from
+    \param[out] none
+    \retval     none
+    \note      CRC_DATA only resets to 0xFFFFFFFF, so one word is fed that takes
+                the reset value to state: the shift of 32 bits is inverted on the CPU
+*/
+static void crc_engine_seed(uint32_t state)
+{
+    uint32_t i;
+
+    crc_data_register_reset();
+    if(CRC_ENGINE_INIT == state) {
+        return;
+    }
+    for(i = 0U; i < 32U; i++) {
+        if(0U != (state & 1U)) {
+            state = ((state ^ CRC_ENGINE_POLY) >> 1) | 0x80000000U;
+        } else {
+            state >>= 1;
+        }
+    }
+    CRC_DATA = state ^ CRC_ENGINE_INIT;
+}
+
+/*!
+    \brief    software equivalent of feeding bytes to the unit
+    \param[in]  mode: result convention
+    \param[in]  state: CRC_DATA value
+    \param[in]  data: bytes, a multiple of 4 in CRC_ENGINE_WORD mode
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     new CRC_DATA value
+    \note      zlib mode runs in the reflected domain, the unit holds the bit
+                reversed register and the library the complemented result
+*/
+static uint32_t crc_engine_soft(crc_engine_mode_enum mode, uint32_t state, const uint8_t *data, uint32_t len)
+{
+    if(CRC_ENGINE_WORD == mode) {
+        return crc_soft_word(state, data, len / 4U);
+    } else if(CRC_ENGINE_MPEG2 == mode) {
+        return crc_soft_mpeg2(state, data, len);
+    } else {
+        return __RBIT(~crc_soft_zlib_slice8(~__RBIT(state), data, len));
+    }
+}
+
+/*!
+    \brief    word as the mode feeds it to CRC_DATA
+    \param[in]  mode: result convention
+    \param[in]  data: 4 bytes, any alignment
+    \param[out] none
+    \retval     word to write
+*/
+static uint32_t crc_engine_word(crc_engine_mode_enum mode, const uint8_t *data)
+{
+    uint32_t word;
+
+    memcpy(&word, data, sizeof(word));
+    if(CRC_ENGINE_MPEG2 == mode) {
+        /* first byte first, most significant bit first */
+        word = __REV(word);
+    } else if(CRC_ENGINE_ZLIB == mode) {
+        /* first byte first, least significant bit first */
+        word = __RBIT(word);
+    }
+
+    return word;
+}
+
+/*!
+    \brief    DMA event of the feeding channel, chains chunks and completes the job
+    \param[in]  arg: unused
+    \param[in]  flags: DMA_INT_FLAG_x of the channel
+    \param[out] none
+    \retval     none
+*/
+static void crc_engine_dma_event(void *arg, uint32_t flags)
+{
+    crc_engine_job_struct *job = &crc_engine_job;
+    crc_engine_ctx_struct *ctx = job->ctx;
+
+    (void)arg;
+    if(NULL == ctx) {
+        return;
+    }
+    if(0U != (flags & DMA_INT_FLAG_TAE)) {
+        /* the channel has stopped part way into CRC_DATA, the CPU redoes the rest from
+           the state before the transfer */
+        crc_engine_stat.dma_errors++;
+        ring_atomic_add(&crc_engine_stat.soft_bytes, job->remaining);
+        ctx->state = crc_soft_word(job->state, job->src, job->remaining / 4U);
+        job->ctx = NULL;
+        crc_engine_release();
+        if(NULL != job->callback) {
+            job->callback(job->arg, ctx);
+        }
+        return;
+    }
+    if(0U == (flags & DMA_INT_FLAG_FTF)) {
+        return;
+    }
+    ring_atomic_add(&crc_engine_stat.dma_bytes, job->chunk);
+    job->src += job->chunk;
+    job->remaining -= job->chunk;
+
+    if(0U != job->remaining) {
+        if(job->chunk > job->remaining) {
+            job->chunk = job->remaining;
+        }
+        job->state = crc_data_register_read();
+        dma_periph_address_config(crc_engine_dma.dma_periph, crc_engine_dma.channel, (uint32_t)job->src);
+        dma_transfer_number_config(crc_engine_dma.dma_periph, crc_engine_dma.channel,
+                                   (0U != job->aligned) ? (job->chunk / 4U) : job->chunk);
+        dma_channel_enable(crc_engine_dma.dma_periph, crc_engine_dma.channel);
+        return;
+    }
+
+    ctx->state = crc_data_register_read();
+    job->ctx = NULL;
+    crc_engine_stat.async_jobs++;
+    crc_engine_release();
+    if(NULL != job->callback) {
+        job->callback(job->arg, ctx);
+    }
+}
+
+/*!
+    \brief    enable the CRC unit and take a memory to memory DMA channel
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note      safe to call again, the channel is kept. Without a free channel
+                crc_engine_update_async() fails and callers stay on the CPU
+*/
+void crc_engine_init(void)
+{
+    crc_soft_init();
+    rcu_periph_clock_enable(RCU_CRC);
+    if(DMA_MGR_REQUEST_NUM == crc_engine_dma.request) {
+        (void)dma_mgr_alloc(DMA_MGR_MEMORY, crc_engine_dma_event, NULL, 3U, &crc_engine_dma);
+    }
+}
+
+/*!
+    \brief    start a checksum
+    \param[in]  ctx: context
+    \param[in]  mode: CRC_ENGINE_WORD, CRC_ENGINE_MPEG2 or CRC_ENGINE_ZLIB
+    \param[out] none
+    \retval     none
+*/
+void crc_engine_start(crc_engine_ctx_struct *ctx, crc_engine_mode_enum mode)
+{
+    ctx->mode = mode;
+    ctx->state = CRC_ENGINE_INIT;
+    ctx->pending = 0U;
+    ctx->pending_len = 0U;
+}
+
+/*!
+    \brief    add bytes on the CPU, any length and alignment, callable from any context
+    \param[in]  ctx: context
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     none
+    \note      when a DMA job or a preempted caller owns the unit the same result is
+                computed in software, so interrupt handlers never wait for the unit
+*/
+void crc_engine_update(crc_engine_ctx_struct *ctx, const void *data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t n, i, words, hw = 0U;
+
+    if(CRC_ENGINE_WORD == ctx->mode) {
+        /* complete the word left open by the previous update */
+        if(0U != ctx->pending_len) {
+            n = 4U - ctx->pending_len;
+            if(n > len) {
+                n = len;
+            }
+            memcpy((uint8_t *)&ctx->pending + ctx->pending_len, p, n);
+            ctx->pending_len += n;
+            p += n;
+            len -= n;
+            if(4U == ctx->pending_len) {
+                ctx->state = crc_soft_word(ctx->state, &ctx->pending, 1U);
+                ctx->pending = 0U;
+                ctx->pending_len = 0U;
+            }
+        }
+        n = len & 3U;
+        if(0U != n) {
+            memcpy(&ctx->pending, &p[len - n], n);
+            ctx->pending_len = n;
+        }
+    }
+
+    /* reseeding costs about as much as CRC_ENGINE_SEED_BYTES in software */
+    words = len / 4U;
+    if((0U != words) && ((CRC_ENGINE_INIT == ctx->state) || ((4U * words) >= CRC_ENGINE_SEED_BYTES))) {
+        hw = crc_engine_claim();
+    }
+
+    if(0U != hw) {
+        crc_engine_seed(ctx->state);
+        for(i = 0U; i < words; i++) {
+            CRC_DATA = crc_engine_word(ctx->mode, &p[4U * i]);
+        }
+        ctx->state = crc_data_register_read();
+        crc_engine_release();
+        ring_atomic_add(&crc_engine_stat.hw_bytes, 4U * words);
+    } else if(0U != words) {
+        ctx->state = crc_engine_soft(ctx->mode, ctx->state, p, 4U * words);
+        ring_atomic_add(&crc_engine_stat.soft_bytes, 4U * words);
+    }
+
+    /* the stream modes take the last 1..3 bytes in software */
+    n = len & 3U;
+    if((CRC_ENGINE_WORD != ctx->mode) && (0U != n)) {
+        ctx->state = crc_engine_soft(ctx->mode, ctx->state, &p[len - n], n);
+        ring_atomic_add(&crc_engine_stat.soft_bytes, n);
+    }
+}
+
+/*!
+    \brief    add bytes in the background by DMA
+    \param[in]  ctx: context in CRC_ENGINE_WORD mode, untouched until the callback
+    \param[in]  data: bytes, any alignment, must stay valid until the callback
+    \param[in]  len: byte count
+    \param[in]  callback: completion, NULL to poll crc_engine_busy()
+    \param[in]  arg: callback argument
+    \param[out] none
+    \retval     SUCCESS, or ERROR when the unit is busy, no DMA channel was free at
+                crc_engine_init(), the data is in TCMRAM or the mode is not CRC_ENGINE_WORD
+    \note      the byte stream modes reorder bits inside each word, which the DMA
+                cannot do, they stay on the CPU. Word aligned data is read a word
+                at a time, anything else byte by byte and packed by the DMA FIFO.
+                After a transfer error the CPU finishes the job before the callback
+*/
+ErrStatus crc_engine_update_async(crc_engine_ctx_struct *ctx, const void *data, uint32_t len,
+                                  crc_engine_callback callback, void *arg)
+{
+    crc_engine_job_struct *job = &crc_engine_job;
+    dma_multi_data_parameter_struct dma_init_struct;
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t n;
+
+    if((CRC_ENGINE_WORD != ctx->mode) || (DMA_MGR_REQUEST_NUM == crc_engine_dma.request) ||
+       SECTION_IN_TCM(data) || (0U == crc_engine_claim())) {
+        return ERROR;
+    }
+    crc_engine_seed(ctx->state);
+
+    /* finish the open word on the CPU so the DMA starts on a word boundary of the stream */
+    if(0U != ctx->pending_len) {
+        n = 4U - ctx->pending_len;
+        if(n > len) {
+            n = len;
+        }
+        memcpy((uint8_t *)&ctx->pending + ctx->pending_len, p, n);
+        ctx->pending_len += n;
+        p += n;
+        len -= n;
+        if(4U == ctx->pending_len) {
+            CRC_DATA = ctx->pending;
+            ctx->pending = 0U;
+            ctx->pending_len = 0U;
+        }
+    }
+    n = len & 3U;
+    if(0U != n) {
+        memcpy(&ctx->pending, &p[len - n], n);
+        ctx->pending_len = n;
+    }
+    len -= n;
+
+    if(0U == len) {
+        ctx->state = crc_data_register_read();
+        crc_engine_release();
+        if(NULL != callback) {
+            callback(arg, ctx);
+        }
+        return SUCCESS;
+    }
+
+    job->ctx = ctx;
+    job->src = p;
+    job->remaining = len;
+    job->state = crc_data_register_read();
+    job->aligned = (0U == ((uint32_t)p & 3U)) ? 1U : 0U;
+    job->callback = callback;
+    job->arg = arg;
+    job->chunk = (0U != job->aligned) ? (4U * CRC_ENGINE_CHUNK_WORDS) : CRC_ENGINE_CHUNK_BYTES;
+    if(job->chunk > len) {
+        job->chunk = len;
+    }
+
+    /* memory to memory: the "peripheral" side is the source */
+    dma_init_struct.periph_addr = (uint32_t)p;
+    dma_init_struct.periph_width = (0U != job->aligned) ? DMA_PERIPH_WIDTH_32BIT : DMA_PERIPH_WIDTH_8BIT;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_ENABLE;
+    dma_init_struct.memory0_addr = (uint32_t)&CRC_DATA;
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_32BIT;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_DISABLE;
+    dma_init_struct.memory_burst_width = DMA_MEMORY_BURST_SINGLE;
+    dma_init_struct.periph_burst_width = DMA_PERIPH_BURST_SINGLE;
+    dma_init_struct.critical_value = DMA_FIFO_4_WORD;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_DISABLE;
+    dma_init_struct.direction = DMA_MEMORY_TO_MEMORY;
+    dma_init_struct.number = (0U != job->aligned) ? (job->chunk / 4U) : job->chunk;
+    dma_init_struct.priority = DMA_PRIORITY_LOW;
+    dma_multi_data_mode_init(crc_engine_dma.dma_periph, crc_engine_dma.channel, &dma_init_struct);
+    dma_interrupt_flag_clear(crc_engine_dma.dma_periph, crc_engine_dma.channel, DMA_MGR_FLAGS);
+    dma_interrupt_enable(crc_engine_dma.dma_periph, crc_engine_dma.channel, DMA_INT_FTF | DMA_INT_TAE);
+    dma_channel_enable(crc_engine_dma.dma_periph, crc_engine_dma.channel);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    finish the checksum and return it in the mode's convention
+    \param[in]  ctx: context
+    \param[out] none
+    \retval     checksum, the context can be started again
+*/
+uint32_t crc_engine_final(crc_engine_ctx_struct *ctx)
+{
+    uint32_t state;
+
+    /* the open word of CRC_ENGINE_WORD is zero padded, memcpy left the rest clear */
+    if(0U != ctx->pending_len) {
+        ctx->state = crc_soft_word(ctx->state, &ctx->pending, 1U);
+        ctx->pending = 0U;
+        ctx->pending_len = 0U;
+    }
+    state = ctx->state;
+    if(CRC_ENGINE_ZLIB == ctx->mode) {
+        state = ~__RBIT(state);
+    }
+
+    return state;
+}
+
+/*!
+    \brief    one shot checksum on the CPU
+    \param[in]  mode: CRC_ENGINE_WORD, CRC_ENGINE_MPEG2 or CRC_ENGINE_ZLIB
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     checksum
+*/
+uint32_t crc_engine_calculate(crc_engine_mode_enum mode, const void *data, uint32_t len)
+{
+    crc_engine_ctx_struct ctx;
+
+    crc_engine_start(&ctx, mode);
+    crc_engine_update(&ctx, data, len);
+
+    return crc_engine_final(&ctx);
+}
+
+/*!
+    \brief    check whether a DMA job owns the unit
+    \param[in]  none
+    \param[out] none
+    \retval     1 while a job runs
+*/
+uint32_t crc_engine_busy(void)
+{
+    return (NULL != crc_engine_job.ctx) ? 1U : 0U;
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  none
+    \param[out] stat: copy of the counters
+    \retval     none
+*/
+void crc_engine_stat_get(crc_engine_stat_struct *stat)
+{
+    *stat = crc_engine_stat;
+}
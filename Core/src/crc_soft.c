@@ -0,0 +1,308 @@
+/*!
+    \file    crc_soft.c
+    \brief   table driven software CRC library
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "crc_soft.h"
+#include <string.h>
+
+#define CRC_SOFT_POLY_REFLECTED          0xEDB88320U
+#define CRC_SOFT_POLY                    0x04C11DB7U
+#define CRC_SOFT_CCITT_POLY              0x1021U
+#define CRC_SOFT_MODBUS_POLY             0xA001U
+
+/* zlib_table[k][i]: byte i followed by k zero bytes, least significant bit first */
+static uint32_t zlib_table[8][256];
+/* mpeg2_table[k][i]: the same, most significant bit first */
+static uint32_t mpeg2_table[8][256];
+static uint16_t ccitt_table[256];
+static uint16_t modbus_table[256];
+
+/*!
+    \brief    load a little endian word from any alignment
+    \param[in]  p: 4 bytes
+    \param[out] none
+    \retval     word
+*/
+static inline uint32_t crc_soft_load(const uint8_t *p)
+{
+    uint32_t word;
+
+    memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+/*!
+    \brief    byte swap
+    \param[in]  word: word
+    \param[out] none
+    \retval     word with the byte order reversed
+*/
+static inline uint32_t crc_soft_swap(uint32_t word)
+{
+    return (word >> 24) | ((word >> 8) & 0x0000FF00U) | ((word << 8) & 0x00FF0000U) | (word << 24);
+}
+
+/*!
+    \brief    build the lookup tables
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void crc_soft_init(void)
+{
+    uint32_t i, k, c;
+    uint16_t s;
+
+    for(i = 0U; i < 256U; i++) {
+        c = i;
+        for(k = 0U; k < 8U; k++) {
+            c = (0U != (c & 1U)) ? ((c >> 1) ^ CRC_SOFT_POLY_REFLECTED) : (c >> 1);
+        }
+        zlib_table[0][i] = c;
+
+        c = i << 24;
+        for(k = 0U; k < 8U; k++) {
+            c = (0U != (c & 0x80000000U)) ? ((c << 1) ^ CRC_SOFT_POLY) : (c << 1);
+        }
+        mpeg2_table[0][i] = c;
+
+        s = (uint16_t)(i << 8);
+        for(k = 0U; k < 8U; k++) {
+            s = (0U != (s & 0x8000U)) ? (uint16_t)((s << 1) ^ CRC_SOFT_CCITT_POLY) : (uint16_t)(s << 1);
+        }
+        ccitt_table[i] = s;
+
+        s = (uint16_t)i;
+        for(k = 0U; k < 8U; k++) {
+            s = (0U != (s & 1U)) ? (uint16_t)((s >> 1) ^ CRC_SOFT_MODBUS_POLY) : (uint16_t)(s >> 1);
+        }
+        modbus_table[i] = s;
+    }
+
+    for(k = 1U; k < 8U; k++) {
+        for(i = 0U; i < 256U; i++) {
+            c = zlib_table[k - 1U][i];
+            zlib_table[k][i] = (c >> 8) ^ zlib_table[0][c & 0xFFU];
+            c = mpeg2_table[k - 1U][i];
+            mpeg2_table[k][i] = (c << 8) ^ mpeg2_table[0][c >> 24];
+        }
+    }
+}
+
+/*!
+    \brief    CRC-32 of zlib and Ethernet, one table lookup per byte
+    \param[in]  crc: previous result, CRC_SOFT_ZLIB_INIT to start
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     CRC-32, can be passed back in as crc to continue
+*/
+uint32_t crc_soft_zlib_bytewise(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while(0U != len--) {
+        crc = zlib_table[0][(crc ^ *p++) & 0xFFU] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+/*!
+    \brief    CRC-32 of zlib and Ethernet, slicing-by-4
+    \param[in]  crc: previous result, CRC_SOFT_ZLIB_INIT to start
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     CRC-32
+    \note      4 lookups per word from a 4 KB table set
+*/
+uint32_t crc_soft_zlib_slice4(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    crc = ~crc;
+    while(len >= 4U) {
+        crc ^= crc_soft_load(p);
+        crc = zlib_table[3][crc & 0xFFU] ^ zlib_table[2][(crc >> 8) & 0xFFU] ^
+              zlib_table[1][(crc >> 16) & 0xFFU] ^ zlib_table[0][crc >> 24];
+        p += 4;
+        len -= 4U;
+    }
+    while(0U != len--) {
+        crc = zlib_table[0][(crc ^ *p++) & 0xFFU] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+/*!
+    \brief    CRC-32 of zlib and Ethernet, slicing-by-8
+    \param[in]  crc: previous result, CRC_SOFT_ZLIB_INIT to start
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     CRC-32
+    \note      8 independent lookups per 8 bytes from an 8 KB table set
+*/
+uint32_t crc_soft_zlib_slice8(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t one, two;
+
+    crc = ~crc;
+    while(len >= 8U) {
+        one = crc_soft_load(p) ^ crc;
+        two = crc_soft_load(p + 4);
+        crc = zlib_table[7][one & 0xFFU] ^ zlib_table[6][(one >> 8) & 0xFFU] ^
+              zlib_table[5][(one >> 16) & 0xFFU] ^ zlib_table[4][one >> 24] ^
+              zlib_table[3][two & 0xFFU] ^ zlib_table[2][(two >> 8) & 0xFFU] ^
+              zlib_table[1][(two >> 16) & 0xFFU] ^ zlib_table[0][two >> 24];
+        p += 8;
+        len -= 8U;
+    }
+    while(0U != len--) {
+        crc = zlib_table[0][(crc ^ *p++) & 0xFFU] ^ (crc >> 8);
+    }
+
+    return ~crc;
+}
+
+/*!
+    \brief    slicing-by-8 core of the most significant bit first CRC-32
+    \param[in]  crc: register value
+    \param[in]  one: first 4 bytes as a big endian number
+    \param[in]  two: next 4 bytes as a big endian number
+    \param[out] none
+    \retval     register value
+*/
+static inline uint32_t crc_soft_msb8(uint32_t crc, uint32_t one, uint32_t two)
+{
+    one ^= crc;
+    return mpeg2_table[7][one >> 24] ^ mpeg2_table[6][(one >> 16) & 0xFFU] ^
+           mpeg2_table[5][(one >> 8) & 0xFFU] ^ mpeg2_table[4][one & 0xFFU] ^
+           mpeg2_table[3][two >> 24] ^ mpeg2_table[2][(two >> 16) & 0xFFU] ^
+           mpeg2_table[1][(two >> 8) & 0xFFU] ^ mpeg2_table[0][two & 0xFFU];
+}
+
+/*!
+    \brief    CRC-32/MPEG-2 over a byte stream, slicing-by-8
+    \param[in]  crc: register value, CRC_SOFT_MPEG2_INIT to start
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     register value, which is also the CRC-32/MPEG-2 result
+*/
+uint32_t crc_soft_mpeg2(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    while(len >= 8U) {
+        crc = crc_soft_msb8(crc, crc_soft_swap(crc_soft_load(p)), crc_soft_swap(crc_soft_load(p + 4)));
+        p += 8;
+        len -= 8U;
+    }
+    while(0U != len--) {
+        crc = (crc << 8) ^ mpeg2_table[0][(crc >> 24) ^ *p++];
+    }
+
+    return crc;
+}
+
+/*!
+    \brief    the CRC unit's own order, little endian words fed to CRC_DATA
+    \param[in]  crc: register value, CRC_SOFT_MPEG2_INIT to start
+    \param[in]  data: words, any alignment
+    \param[in]  words: word count
+    \param[out] none
+    \retval     register value, equal to CRC_DATA after writing the same words
+    \note      the unit shifts each word in most significant bit first, so the
+                little endian load is already the big endian number of the core
+*/
+uint32_t crc_soft_word(uint32_t crc, const void *data, size_t words)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t one;
+
+    while(words >= 2U) {
+        crc = crc_soft_msb8(crc, crc_soft_load(p), crc_soft_load(p + 4));
+        p += 8;
+        words -= 2U;
+    }
+    if(0U != words) {
+        one = crc_soft_load(p) ^ crc;
+        crc = mpeg2_table[3][one >> 24] ^ mpeg2_table[2][(one >> 16) & 0xFFU] ^
+              mpeg2_table[1][(one >> 8) & 0xFFU] ^ mpeg2_table[0][one & 0xFFU];
+    }
+
+    return crc;
+}
+
+/*!
+    \brief    CRC-16/CCITT-FALSE
+    \param[in]  crc: previous value, CRC_SOFT_CCITT_INIT to start
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     CRC-16
+*/
+uint16_t crc_soft_ccitt(uint16_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    while(0U != len--) {
+        crc = (uint16_t)((crc << 8) ^ ccitt_table[((crc >> 8) ^ *p++) & 0xFFU]);
+    }
+
+    return crc;
+}
+
+/*!
+    \brief    CRC-16/MODBUS
+    \param[in]  crc: previous value, CRC_SOFT_MODBUS_INIT to start
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     CRC-16, sent low byte first
+*/
+uint16_t crc_soft_modbus(uint16_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+
+    while(0U != len--) {
+        crc = (uint16_t)((crc >> 8) ^ modbus_table[(crc ^ *p++) & 0xFFU]);
+    }
+
+    return crc;
+}
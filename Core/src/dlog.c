@@ -0,0 +1,146 @@
+/*!
+    \file    dlog.c
+    \brief   deferred binary logger, records carry a format string id and raw arguments
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "dlog.h"
+#include "ring.h"
+#include "console.h"
+#include <stdarg.h>
+#include <string.h>
+
+static uint8_t dlog_buffer[DLOG_BUFFER_SIZE];
+static ring_struct dlog_ring;
+static volatile uint32_t dlog_seq;
+static dlog_stat_struct dlog_stat;
+
+/*!
+    \brief    initialize the log ring
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void dlog_init(void)
+{
+    ring_init(&dlog_ring, dlog_buffer, DLOG_BUFFER_SIZE);
+    dlog_seq = 0U;
+}
+
+/*!
+    \brief    queue one record, use the DLOG() macro
+    \param[in]  id: format string id
+    \param[in]  nargs: argument count, at most DLOG_MAX_ARGS
+    \param[in]  ...: 32-bit arguments
+    \param[out] none
+    \retval     none
+    \note      callable from any context, no formatting happens here
+*/
+void dlog_write(uint32_t id, uint32_t nargs, ...)
+{
+    uint32_t record[3U + DLOG_MAX_ARGS];
+    uint32_t seq, i;
+    va_list ap;
+
+    /* every attempt takes a sequence number, the decoder reports the gaps */
+    do {
+        seq = __LDREXW(&dlog_seq);
+    } while(0U != __STREXW(seq + 1U, &dlog_seq));
+
+    if(nargs > DLOG_MAX_ARGS) {
+        nargs = DLOG_MAX_ARGS;
+    }
+    record[0] = DLOG_SYNC | (nargs << 8) | (seq << 16);
+    record[1] = id;
+    record[2] = DWT->CYCCNT;
+    va_start(ap, nargs);
+    for(i = 0U; i < nargs; i++) {
+        record[3U + i] = va_arg(ap, uint32_t);
+    }
+    va_end(ap);
+
+    if(0U == ring_write(&dlog_ring, record, (3U + nargs) * 4U)) {
+        ring_atomic_add(&dlog_stat.dropped, 1U);
+    } else {
+        ring_atomic_add(&dlog_stat.records, 1U);
+    }
+}
+
+/*!
+    \brief    move queued records to the console, returns bytes moved
+    \param[in]  none
+    \param[out] none
+    \retval     bytes handed to the console
+    \note      call from one context only, e.g. the main loop. Only whole records
+                are written, a record that does not fit stays queued
+*/
+uint32_t dlog_drain(void)
+{
+    uint8_t *data;
+    uint32_t len, header, record, piece, pos, moved = 0U;
+
+    /* records are whole words, so the header never straddles the end of the ring */
+    while(0U != (len = ring_peek(&dlog_ring, &data))) {
+        memcpy(&header, data, sizeof(header));
+        record = (3U + ((header >> 8) & 0xFFU)) * 4U;
+        /* never let the console count log bytes as dropped, they are simply sent later */
+        if((record > console_free()) || (SUCCESS != serial_write_begin(CONSOLE_PORT, record, &pos))) {
+            break;
+        }
+        /* a record wrapping around the ring comes in two pieces */
+        for(piece = 0U; piece < record; piece += len) {
+            if(0U != piece) {
+                len = ring_peek(&dlog_ring, &data);
+            }
+            if(len > (record - piece)) {
+                len = record - piece;
+            }
+            pos = serial_write_put(CONSOLE_PORT, pos, data, len);
+            ring_consume(&dlog_ring, len);
+        }
+        serial_write_end(CONSOLE_PORT, record);
+        moved += record;
+    }
+
+    return moved;
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  none
+    \param[out] stat: copy of the counters
+    \retval     none
+*/
+void dlog_stat_get(dlog_stat_struct *stat)
+{
+    *stat = dlog_stat;
+}
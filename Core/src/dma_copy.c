@@ -0,0 +1,473 @@
+/*!
+    \file    dma_copy.c
+    \brief   asynchronous memory copy and fill on a DMA1 memory to memory channel
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "dma_copy.h"
+#include "dma_mgr.h"
+#include "ring.h"
+#include "section.h"
+#include <stddef.h>
+#include <string.h>
+
+/* CHCNT is 16 bits, chunks stay a whole number of 4 beat bursts */
+#define DMA_COPY_CHUNK_ITEMS             0xFFFCU
+/* calibration copies the first half of the buffer to the second */
+#define DMA_COPY_CAL_SIZE                1024U
+#define DMA_COPY_CAL_RUNS                4U
+
+/* memory to memory channel, request DMA_MGR_REQUEST_NUM until allocated */
+static dma_mgr_channel_struct dma_copy_dma = {DMA1, DMA_CH0, DMA_SUBPERI0, DMA_MGR_REQUEST_NUM};
+/* request queue, the head owns the channel */
+static dma_copy_req_struct *dma_copy_head = NULL;
+static dma_copy_req_struct *dma_copy_tail = NULL;
+static uint32_t dma_copy_queued = 0U;
+/* source word of a running fill, must be DMA reachable */
+static uint32_t dma_copy_pattern;
+/* bytes per source item of the running request, 1 or 4 */
+static uint32_t dma_copy_unit = 4U;
+static uint32_t dma_copy_crossover = DMA_COPY_CROSSOVER_DEFAULT;
+static dma_copy_stat_struct dma_copy_stat;
+static uint32_t dma_copy_cal[DMA_COPY_CAL_SIZE / 4U];
+
+/*!
+    \brief    move part of a request on the CPU
+    \param[in]  req: request
+    \param[in]  from: first byte offset
+    \param[in]  to: end byte offset
+    \param[out] none
+    \retval     none
+*/
+static void dma_copy_cpu(dma_copy_req_struct *req, uint32_t from, uint32_t to)
+{
+    if(to <= from) {
+        return;
+    }
+    if(NULL != req->src) {
+        memcpy(&req->dst[from], &req->src[from], to - from);
+    } else {
+        memset(&req->dst[from], (int)(req->value & 0xFFU), to - from);
+    }
+    ring_atomic_add(&dma_copy_stat.cpu_bytes, to - from);
+}
+
+/*!
+    \brief    start the next chunk of the running request
+    \param[in]  req: request at the head of the queue
+    \param[out] none
+    \retval     none
+*/
+static void dma_copy_program(dma_copy_req_struct *req)
+{
+    uint32_t dma = dma_copy_dma.dma_periph;
+    dma_channel_enum ch = dma_copy_dma.channel;
+
+    req->chunk = req->end - req->pos;
+    if(req->chunk > DMA_COPY_CHUNK_ITEMS * dma_copy_unit) {
+        req->chunk = DMA_COPY_CHUNK_ITEMS * dma_copy_unit;
+    }
+    if(NULL != req->src) {
+        dma_periph_address_config(dma, ch, (uint32_t)&req->src[req->pos]);
+    }
+    dma_memory_address_config(dma, ch, DMA_MEMORY_0, (uint32_t)&req->dst[req->pos]);
+    dma_transfer_number_config(dma, ch, req->chunk / dma_copy_unit);
+    dma_interrupt_flag_clear(dma, ch, DMA_MGR_FLAGS);
+    dma_channel_enable(dma, ch);
+}
+
+/*!
+    \brief    configure the channel for a request and start it
+    \param[in]  req: request at the head of the queue
+    \param[out] none
+    \retval     none
+    \note      the CPU writes up to 15 bytes at each end so the DMA writes aligned
+                16 byte bursts. 4 beat bursts are used on the source side too when
+                it is 16 byte aligned after the head, word reads when it is word
+                aligned and byte reads packed by the FIFO otherwise
+*/
+static void dma_copy_start(dma_copy_req_struct *req)
+{
+    dma_multi_data_parameter_struct dma_init_struct;
+    uint32_t dma = dma_copy_dma.dma_periph;
+    dma_channel_enum ch = dma_copy_dma.channel;
+    uint32_t head, src_addr, burst;
+
+    head = (16U - ((uint32_t)req->dst & 15U)) & 15U;
+    src_addr = (NULL != req->src) ? (uint32_t)&req->src[head] : 0U;
+    burst = (0U == (src_addr & 15U)) ? 1U : 0U;
+    dma_copy_unit = (0U == (src_addr & 3U)) ? 4U : 1U;
+    req->pos = head;
+    req->end = head + ((req->len - head) & ((0U != burst) ? ~15U : ~3U));
+    req->status = DMA_COPY_RUNNING;
+    dma_copy_cpu(req, 0U, head);
+    dma_copy_cpu(req, req->end, req->len);
+
+    /* memory to memory: the "peripheral" side is the source */
+    if(NULL == req->src) {
+        dma_copy_pattern = (req->value & 0xFFU) * 0x01010101U;
+        src_addr = (uint32_t)&dma_copy_pattern;
+    }
+    dma_init_struct.periph_addr = src_addr;
+    dma_init_struct.periph_width = (4U == dma_copy_unit) ? DMA_PERIPH_WIDTH_32BIT : DMA_PERIPH_WIDTH_8BIT;
+    dma_init_struct.periph_inc = (NULL != req->src) ? DMA_PERIPH_INCREASE_ENABLE : DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory0_addr = (uint32_t)&req->dst[head];
+    dma_init_struct.memory_width = DMA_MEMORY_WIDTH_32BIT;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.memory_burst_width = DMA_MEMORY_BURST_SINGLE;
+    dma_init_struct.periph_burst_width = DMA_PERIPH_BURST_SINGLE;
+    dma_init_struct.critical_value = DMA_FIFO_4_WORD;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_DISABLE;
+    dma_init_struct.direction = DMA_MEMORY_TO_MEMORY;
+    dma_init_struct.number = 0U;
+    dma_init_struct.priority = DMA_PRIORITY_LOW;
+    dma_multi_data_mode_init(dma, ch, &dma_init_struct);
+    if(0U != burst) {
+        /* a 4 beat word burst is one full FIFO and never crosses a 1KB boundary here */
+        dma_memory_burst_beats_config(dma, ch, DMA_MEMORY_BURST_4_BEAT);
+        if(NULL != req->src) {
+            dma_periph_burst_beats_config(dma, ch, DMA_PERIPH_BURST_4_BEAT);
+        }
+    }
+    dma_interrupt_enable(dma, ch, DMA_INT_FTF | DMA_INT_TAE);
+    dma_copy_program(req);
+}
+
+/*!
+    \brief    DMA event: chain chunks, complete the request and start the next one
+    \param[in]  arg: unused
+    \param[in]  flags: DMA_INT_FLAG_x of the channel
+    \param[out] none
+    \retval     none
+*/
+static void dma_copy_dma_event(void *arg, uint32_t flags)
+{
+    dma_copy_req_struct *req = dma_copy_head;
+    uint32_t primask;
+
+    (void)arg;
+    if(NULL == req) {
+        return;
+    }
+    if(0U != (flags & DMA_INT_FLAG_TAE)) {
+        /* the channel has stopped, the CPU redoes the whole chunk */
+        dma_copy_stat.dma_errors++;
+        dma_copy_cpu(req, req->pos, req->end);
+        req->pos = req->end;
+    } else if(0U != (flags & DMA_INT_FLAG_FTF)) {
+        dma_copy_stat.dma_bytes += req->chunk;
+        req->pos += req->chunk;
+        if(req->pos < req->end) {
+            dma_copy_program(req);
+            return;
+        }
+    } else {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    dma_copy_head = req->next;
+    if(NULL == dma_copy_head) {
+        dma_copy_tail = NULL;
+    }
+    dma_copy_queued--;
+    dma_copy_stat.dma_jobs++;
+    req->status = DMA_COPY_DONE;
+    if(NULL != dma_copy_head) {
+        dma_copy_start(dma_copy_head);
+    }
+    __set_PRIMASK(primask);
+
+    if(NULL != req->callback) {
+        req->callback(req->arg, req);
+    }
+}
+
+/*!
+    \brief    run a request on the CPU or queue it for the DMA
+    \param[in]  req: filled in request
+    \param[out] none
+    \retval     SUCCESS, or ERROR when the request is still queued or running
+*/
+static ErrStatus dma_copy_submit(dma_copy_req_struct *req)
+{
+    uint32_t primask;
+
+    if((DMA_COPY_QUEUED == req->status) || (DMA_COPY_RUNNING == req->status)) {
+        return ERROR;
+    }
+
+    if((DMA_MGR_REQUEST_NUM == dma_copy_dma.request) || (req->len < DMA_COPY_MIN) ||
+       (req->len < dma_copy_crossover) || SECTION_IN_TCM(req->dst) ||
+       ((NULL != req->src) && SECTION_IN_TCM(req->src))) {
+        dma_copy_cpu(req, 0U, req->len);
+        ring_atomic_add(&dma_copy_stat.cpu_jobs, 1U);
+        req->status = DMA_COPY_DONE;
+        if(NULL != req->callback) {
+            req->callback(req->arg, req);
+        }
+        return SUCCESS;
+    }
+
+    req->next = NULL;
+    req->status = DMA_COPY_QUEUED;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(NULL == dma_copy_tail) {
+        dma_copy_head = req;
+    } else {
+        dma_copy_tail->next = req;
+    }
+    dma_copy_tail = req;
+    dma_copy_queued++;
+    if(dma_copy_queued > dma_copy_stat.queue_high_water) {
+        dma_copy_stat.queue_high_water = dma_copy_queued;
+    }
+    if(dma_copy_head == req) {
+        dma_copy_start(req);
+    }
+    __set_PRIMASK(primask);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    time CPU and DMA copies of growing size, the first size the DMA wins is the crossover
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note      needs thread mode with interrupts enabled, the DMA completion is an interrupt
+*/
+static void dma_copy_calibrate(void)
+{
+    dma_copy_req_struct req;
+    uint8_t *buf = (uint8_t *)dma_copy_cal;
+    uint32_t len, run, start, cycles, cpu, dma;
+    /* the DMA never won up to half the buffer: assume twice that */
+    uint32_t crossover = DMA_COPY_CAL_SIZE;
+
+    if((0U != __get_IPSR()) || (0U != __get_PRIMASK())) {
+        return;
+    }
+    if(0U == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    req.status = DMA_COPY_IDLE;
+    dma_copy_crossover = 0U;
+    for(len = DMA_COPY_MIN; len <= DMA_COPY_CAL_SIZE / 2U; len <<= 1) {
+        cpu = 0xFFFFFFFFU;
+        dma = 0xFFFFFFFFU;
+        for(run = 0U; run < DMA_COPY_CAL_RUNS; run++) {
+            start = DWT->CYCCNT;
+            memcpy(&buf[DMA_COPY_CAL_SIZE / 2U], buf, len);
+            cycles = DWT->CYCCNT - start;
+            if(cycles < cpu) {
+                cpu = cycles;
+            }
+            start = DWT->CYCCNT;
+            (void)dma_copy_memcpy_async(&req, &buf[DMA_COPY_CAL_SIZE / 2U], buf, len, NULL, NULL);
+            dma_copy_wait(&req);
+            cycles = DWT->CYCCNT - start;
+            if(cycles < dma) {
+                dma = cycles;
+            }
+        }
+        if(dma < cpu) {
+            crossover = len;
+            break;
+        }
+    }
+    dma_copy_crossover = crossover;
+    memset(&dma_copy_stat, 0, sizeof(dma_copy_stat));
+}
+
+/*!
+    \brief    take a memory to memory channel and measure the CPU/DMA crossover
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note      safe to call again, the channel and the crossover are kept. Without
+                a free channel every request completes on the CPU
+*/
+void dma_copy_init(void)
+{
+    if(DMA_MGR_REQUEST_NUM != dma_copy_dma.request) {
+        return;
+    }
+    if(SUCCESS == dma_mgr_alloc(DMA_MGR_MEMORY, dma_copy_dma_event, NULL, 3U, &dma_copy_dma)) {
+        dma_copy_calibrate();
+    }
+}
+
+/*!
+    \brief    copy len bytes in the background
+    \param[in]  req: request, owned by the engine until it reports DMA_COPY_DONE
+    \param[in]  dst: destination in SRAM
+    \param[in]  src: source in SRAM or flash, must not overlap dst
+    \param[in]  len: byte count
+    \param[in]  callback: completion, NULL to poll dma_copy_done()
+    \param[in]  arg: callback argument
+    \param[out] none
+    \retval     SUCCESS, or ERROR when req is still queued or running
+    \note      requests below the crossover or touching TCMRAM complete on the CPU
+                before this returns. DMA requests run in submission order
+*/
+ErrStatus dma_copy_memcpy_async(dma_copy_req_struct *req, void *dst, const void *src, uint32_t len,
+                                dma_copy_callback callback, void *arg)
+{
+    if((DMA_COPY_QUEUED == req->status) || (DMA_COPY_RUNNING == req->status)) {
+        return ERROR;
+    }
+    req->dst = (uint8_t *)dst;
+    req->src = (const uint8_t *)src;
+    req->len = len;
+    req->value = 0U;
+    req->callback = callback;
+    req->arg = arg;
+
+    return dma_copy_submit(req);
+}
+
+/*!
+    \brief    fill len bytes in the background
+    \param[in]  req: request, owned by the engine until it reports DMA_COPY_DONE
+    \param[in]  dst: destination in SRAM
+    \param[in]  value: fill byte
+    \param[in]  len: byte count
+    \param[in]  callback: completion, NULL to poll dma_copy_done()
+    \param[in]  arg: callback argument
+    \param[out] none
+    \retval     SUCCESS, or ERROR when req is still queued or running
+    \note      requests below the crossover or touching TCMRAM complete on the CPU
+                before this returns. DMA requests run in submission order
+*/
+ErrStatus dma_copy_memset_async(dma_copy_req_struct *req, void *dst, uint8_t value, uint32_t len,
+                                dma_copy_callback callback, void *arg)
+{
+    if((DMA_COPY_QUEUED == req->status) || (DMA_COPY_RUNNING == req->status)) {
+        return ERROR;
+    }
+    req->dst = (uint8_t *)dst;
+    req->src = NULL;
+    req->len = len;
+    req->value = value;
+    req->callback = callback;
+    req->arg = arg;
+
+    return dma_copy_submit(req);
+}
+
+/*!
+    \brief    check whether a request has finished
+    \param[in]  req: request
+    \param[out] none
+    \retval     1 when done or never submitted, 0 while queued or running
+*/
+uint32_t dma_copy_done(const dma_copy_req_struct *req)
+{
+    uint32_t status = req->status;
+
+    return ((DMA_COPY_QUEUED == status) || (DMA_COPY_RUNNING == status)) ? 0U : 1U;
+}
+
+/*!
+    \brief    wait for a request
+    \param[in]  req: request
+    \param[out] none
+    \retval     none
+    \note      thread mode with interrupts enabled only, the DMA interrupt completes it
+*/
+void dma_copy_wait(const dma_copy_req_struct *req)
+{
+    while(0U == dma_copy_done(req)) {
+    }
+}
+
+/*!
+    \brief    blocking copy that takes the DMA above the crossover when called from thread mode
+    \param[in]  dst: destination
+    \param[in]  src: source, must not overlap dst
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     dst
+    \note      interrupt handlers and masked code copy on the CPU, they cannot wait
+                for the DMA interrupt
+*/
+void *dma_copy_memcpy(void *dst, const void *src, uint32_t len)
+{
+    dma_copy_req_struct req;
+
+    if((len < dma_copy_crossover) || (0U != __get_IPSR()) || (0U != __get_PRIMASK())) {
+        return memcpy(dst, src, len);
+    }
+    req.status = DMA_COPY_IDLE;
+    (void)dma_copy_memcpy_async(&req, dst, src, len, NULL, NULL);
+    dma_copy_wait(&req);
+
+    return dst;
+}
+
+/*!
+    \brief    override the crossover
+    \param[in]  bytes: requests of at least this size go to the DMA, never below DMA_COPY_MIN
+    \param[out] none
+    \retval     none
+*/
+void dma_copy_crossover_set(uint32_t bytes)
+{
+    dma_copy_crossover = bytes;
+}
+
+/*!
+    \brief    current crossover
+    \param[in]  none
+    \param[out] none
+    \retval     bytes
+*/
+uint32_t dma_copy_crossover_get(void)
+{
+    return dma_copy_crossover;
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  none
+    \param[out] stat: copy of the counters
+    \retval     none
+*/
+void dma_copy_stat_get(dma_copy_stat_struct *stat)
+{
+    *stat = dma_copy_stat;
+}
@@ -0,0 +1,320 @@
+/*!
+    \file    dma_mgr.c
+    \brief   DMA channel manager: request routing, channel allocation and interrupt dispatch
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "dma_mgr.h"
+#include "section.h"
+#include <stddef.h>
+
+/* route encoding: controller in bit 6, channel in bits 5:3, subperipheral in bits 2:0 */
+#define DMA_MGR_ROUTE(dma, ch, sub)      ((uint8_t)(((dma) << 6) | ((ch) << 3) | (sub)))
+#define DMA_MGR_ROUTE_DMA(route)         ((0U != ((route) & 0x40U)) ? DMA1 : DMA0)
+#define DMA_MGR_ROUTE_CH(route)          ((dma_channel_enum)(((route) >> 3) & 7U))
+#define DMA_MGR_ROUTE_SUB(route)         ((dma_subperipheral_enum)((route) & 7U))
+#define DMA_MGR_ROUTE_NONE               0xFFU
+/* alternatives per peripheral request, memory to memory may use all 8 channels of DMA1 */
+#define DMA_MGR_ROUTES                   2U
+#define DMA_MGR_CHANNELS                 8U
+
+/* bit position of channel x flags in INTF0/INTF1 */
+#define DMA_MGR_FLAG_SHIFT(ch)           ((((uint32_t)(ch) & 3U) * 6U) + ((((uint32_t)(ch) >> 1) & 1U) * 4U))
+
+/* owner of a channel */
+typedef struct {
+    dma_mgr_callback callback;                                         /*!< transfer event handler */
+    void *arg;                                                         /*!< callback argument */
+    uint8_t owner;                                                     /*!< request + 1, 0 when free */
+} dma_mgr_slot_struct;
+
+/* DMA request mapping of the GD32F4xx reference manual, preferred channel first */
+static const uint8_t dma_mgr_route[DMA_MGR_REQUEST_NUM][DMA_MGR_ROUTES] = {
+    {DMA_MGR_ROUTE_NONE, DMA_MGR_ROUTE_NONE},                          /* memory, see dma_mgr_routes() */
+    {DMA_MGR_ROUTE(1, 7, 4), DMA_MGR_ROUTE_NONE},                      /* USART0 TX */
+    {DMA_MGR_ROUTE(1, 5, 4), DMA_MGR_ROUTE(1, 2, 4)},                  /* USART0 RX */
+    {DMA_MGR_ROUTE(0, 6, 4), DMA_MGR_ROUTE_NONE},                      /* USART1 TX */
+    {DMA_MGR_ROUTE(0, 5, 4), DMA_MGR_ROUTE_NONE},                      /* USART1 RX */
+    {DMA_MGR_ROUTE(0, 3, 4), DMA_MGR_ROUTE(0, 4, 7)},                  /* USART2 TX */
+    {DMA_MGR_ROUTE(0, 1, 4), DMA_MGR_ROUTE_NONE},                      /* USART2 RX */
+    {DMA_MGR_ROUTE(0, 4, 4), DMA_MGR_ROUTE_NONE},                      /* UART3 TX */
+    {DMA_MGR_ROUTE(0, 2, 4), DMA_MGR_ROUTE_NONE},                      /* UART3 RX */
+    {DMA_MGR_ROUTE(0, 7, 4), DMA_MGR_ROUTE_NONE},                      /* UART4 TX */
+    {DMA_MGR_ROUTE(0, 0, 4), DMA_MGR_ROUTE_NONE},                      /* UART4 RX */
+    {DMA_MGR_ROUTE(1, 6, 5), DMA_MGR_ROUTE(1, 7, 5)},                  /* USART5 TX */
+    {DMA_MGR_ROUTE(1, 1, 5), DMA_MGR_ROUTE(1, 2, 5)},                  /* USART5 RX */
+    {DMA_MGR_ROUTE(0, 1, 5), DMA_MGR_ROUTE_NONE},                      /* UART6 TX */
+    {DMA_MGR_ROUTE(0, 3, 5), DMA_MGR_ROUTE_NONE},                      /* UART6 RX */
+    {DMA_MGR_ROUTE(0, 0, 5), DMA_MGR_ROUTE_NONE},                      /* UART7 TX */
+    {DMA_MGR_ROUTE(0, 6, 5), DMA_MGR_ROUTE_NONE},                      /* UART7 RX */
+    {DMA_MGR_ROUTE(1, 3, 3), DMA_MGR_ROUTE(1, 5, 3)},                  /* SPI0 TX */
+    {DMA_MGR_ROUTE(1, 0, 3), DMA_MGR_ROUTE(1, 2, 3)},                  /* SPI0 RX */
+    {DMA_MGR_ROUTE(0, 4, 0), DMA_MGR_ROUTE_NONE},                      /* SPI1 TX */
+    {DMA_MGR_ROUTE(0, 3, 0), DMA_MGR_ROUTE_NONE},                      /* SPI1 RX */
+    {DMA_MGR_ROUTE(0, 5, 0), DMA_MGR_ROUTE(0, 7, 0)},                  /* SPI2 TX */
+    {DMA_MGR_ROUTE(0, 0, 0), DMA_MGR_ROUTE(0, 2, 0)},                  /* SPI2 RX */
+    {DMA_MGR_ROUTE(1, 1, 4), DMA_MGR_ROUTE(1, 4, 5)},                  /* SPI3 TX */
+    {DMA_MGR_ROUTE(1, 0, 4), DMA_MGR_ROUTE(1, 3, 5)},                  /* SPI3 RX */
+    {DMA_MGR_ROUTE(1, 4, 2), DMA_MGR_ROUTE(1, 6, 7)},                  /* SPI4 TX */
+    {DMA_MGR_ROUTE(1, 3, 2), DMA_MGR_ROUTE(1, 5, 7)},                  /* SPI4 RX */
+    {DMA_MGR_ROUTE(1, 5, 1), DMA_MGR_ROUTE_NONE},                      /* SPI5 TX */
+    {DMA_MGR_ROUTE(1, 6, 1), DMA_MGR_ROUTE_NONE},                      /* SPI5 RX */
+    {DMA_MGR_ROUTE(0, 6, 1), DMA_MGR_ROUTE(0, 7, 1)},                  /* I2C0 TX */
+    {DMA_MGR_ROUTE(0, 0, 1), DMA_MGR_ROUTE(0, 5, 1)},                  /* I2C0 RX */
+    {DMA_MGR_ROUTE(0, 7, 7), DMA_MGR_ROUTE_NONE},                      /* I2C1 TX */
+    {DMA_MGR_ROUTE(0, 2, 7), DMA_MGR_ROUTE(0, 3, 7)},                  /* I2C1 RX */
+    {DMA_MGR_ROUTE(0, 4, 3), DMA_MGR_ROUTE_NONE},                      /* I2C2 TX */
+    {DMA_MGR_ROUTE(0, 2, 3), DMA_MGR_ROUTE_NONE},                      /* I2C2 RX */
+    {DMA_MGR_ROUTE(1, 0, 0), DMA_MGR_ROUTE(1, 4, 0)},                  /* ADC0 */
+    {DMA_MGR_ROUTE(1, 2, 1), DMA_MGR_ROUTE(1, 3, 1)},                  /* ADC1 */
+    {DMA_MGR_ROUTE(1, 0, 2), DMA_MGR_ROUTE(1, 1, 2)},                  /* ADC2 */
+    {DMA_MGR_ROUTE(0, 5, 7), DMA_MGR_ROUTE_NONE},                      /* DAC0 */
+    {DMA_MGR_ROUTE(0, 6, 7), DMA_MGR_ROUTE_NONE},                      /* DAC1 */
+    {DMA_MGR_ROUTE(1, 3, 4), DMA_MGR_ROUTE(1, 6, 4)},                  /* SDIO */
+    {DMA_MGR_ROUTE(1, 1, 1), DMA_MGR_ROUTE(1, 7, 1)},                  /* DCI */
+    {DMA_MGR_ROUTE(1, 5, 6), DMA_MGR_ROUTE_NONE},                      /* TIMER0 UP */
+    {DMA_MGR_ROUTE(0, 1, 3), DMA_MGR_ROUTE(0, 7, 3)},                  /* TIMER1 UP */
+    {DMA_MGR_ROUTE(0, 2, 5), DMA_MGR_ROUTE_NONE},                      /* TIMER2 UP */
+    {DMA_MGR_ROUTE(0, 6, 2), DMA_MGR_ROUTE_NONE},                      /* TIMER3 UP */
+    {DMA_MGR_ROUTE(0, 0, 6), DMA_MGR_ROUTE(0, 6, 6)},                  /* TIMER4 UP */
+    {DMA_MGR_ROUTE(0, 1, 7), DMA_MGR_ROUTE_NONE},                      /* TIMER5 UP */
+    {DMA_MGR_ROUTE(0, 2, 1), DMA_MGR_ROUTE(0, 4, 1)},                  /* TIMER6 UP */
+    {DMA_MGR_ROUTE(1, 1, 7), DMA_MGR_ROUTE_NONE}                       /* TIMER7 UP */
+};
+
+/* channel interrupts, DMA0 channel 7 and DMA1 channels 5..7 sit apart from the rest */
+static const IRQn_Type dma_mgr_irqn[2][DMA_MGR_CHANNELS] = {
+    {DMA0_Channel0_IRQn, DMA0_Channel1_IRQn, DMA0_Channel2_IRQn, DMA0_Channel3_IRQn,
+     DMA0_Channel4_IRQn, DMA0_Channel5_IRQn, DMA0_Channel6_IRQn, DMA0_Channel7_IRQn},
+    {DMA1_Channel0_IRQn, DMA1_Channel1_IRQn, DMA1_Channel2_IRQn, DMA1_Channel3_IRQn,
+     DMA1_Channel4_IRQn, DMA1_Channel5_IRQn, DMA1_Channel6_IRQn, DMA1_Channel7_IRQn}
+};
+
+static dma_mgr_slot_struct dma_mgr_slot[2][DMA_MGR_CHANNELS];
+static dma_mgr_stat_struct dma_mgr_stat[2][DMA_MGR_CHANNELS];
+
+/*!
+    \brief    controller index
+    \param[in]  dma_periph: DMA0 or DMA1
+    \param[out] none
+    \retval     0 or 1
+*/
+static uint32_t dma_mgr_index(uint32_t dma_periph)
+{
+    return (DMA1 == dma_periph) ? 1U : 0U;
+}
+
+/*!
+    \brief    channels able to serve a request
+    \param[in]  request: DMA request
+    \param[out] route: candidates in order of preference
+    \retval     number of candidates
+*/
+static uint32_t dma_mgr_routes(dma_mgr_request_enum request, uint8_t route[DMA_MGR_CHANNELS])
+{
+    uint32_t i, n = 0U;
+
+    if(DMA_MGR_MEMORY == request) {
+        /* only DMA1 connects both ports to the bus matrix */
+        for(i = 0U; i < DMA_MGR_CHANNELS; i++) {
+            route[n++] = DMA_MGR_ROUTE(1U, i, 0U);
+        }
+    } else {
+        for(i = 0U; i < DMA_MGR_ROUTES; i++) {
+            if(DMA_MGR_ROUTE_NONE != dma_mgr_route[request][i]) {
+                route[n++] = dma_mgr_route[request][i];
+            }
+        }
+    }
+
+    return n;
+}
+
+/*!
+    \brief    take a free channel serving the request and route its interrupt to the callback
+    \param[in]  request: DMA request
+    \param[in]  callback: transfer event handler, NULL when the owner polls
+    \param[in]  arg: callback argument
+    \param[in]  irq_priority: preemption priority of the channel interrupt
+    \param[out] ch: allocated channel, reset and with the subperipheral selected
+    \retval     SUCCESS, or ERROR when every channel serving the request is taken
+    \note      the channel comes back deinitialized, configure it with
+                dma_single_data_mode_init() or dma_multi_data_mode_init() without
+                calling dma_deinit(), which would clear the subperipheral selection
+*/
+ErrStatus dma_mgr_alloc(dma_mgr_request_enum request, dma_mgr_callback callback, void *arg,
+                        uint8_t irq_priority, dma_mgr_channel_struct *ch)
+{
+    uint8_t route[DMA_MGR_CHANNELS];
+    dma_mgr_slot_struct *slot = NULL;
+    uint32_t i, n, dma, primask;
+
+    ch->request = DMA_MGR_REQUEST_NUM;
+    if(request >= DMA_MGR_REQUEST_NUM) {
+        return ERROR;
+    }
+    n = dma_mgr_routes(request, route);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for(i = 0U; i < n; i++) {
+        slot = &dma_mgr_slot[dma_mgr_index(DMA_MGR_ROUTE_DMA(route[i]))][DMA_MGR_ROUTE_CH(route[i])];
+        if(0U == slot->owner) {
+            break;
+        }
+    }
+    if(i == n) {
+        for(i = 0U; i < n; i++) {
+            dma_mgr_stat[dma_mgr_index(DMA_MGR_ROUTE_DMA(route[i]))][DMA_MGR_ROUTE_CH(route[i])].conflicts++;
+        }
+        __set_PRIMASK(primask);
+        return ERROR;
+    }
+    slot->callback = callback;
+    slot->arg = arg;
+    slot->owner = (uint8_t)(request + 1U);
+    __set_PRIMASK(primask);
+
+    ch->dma_periph = DMA_MGR_ROUTE_DMA(route[i]);
+    ch->channel = DMA_MGR_ROUTE_CH(route[i]);
+    ch->subperi = DMA_MGR_ROUTE_SUB(route[i]);
+    ch->request = request;
+    dma = dma_mgr_index(ch->dma_periph);
+    dma_mgr_stat[dma][ch->channel].allocs++;
+
+    rcu_periph_clock_enable((0U != dma) ? RCU_DMA1 : RCU_DMA0);
+    dma_deinit(ch->dma_periph, ch->channel);
+    dma_channel_subperipheral_select(ch->dma_periph, ch->channel, ch->subperi);
+    nvic_irq_enable(dma_mgr_irqn[dma][ch->channel], irq_priority, 0U);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    stop the channel and give it back
+    \param[in]  ch: channel from dma_mgr_alloc(), marked free on return
+    \param[out] none
+    \retval     none
+*/
+void dma_mgr_free(dma_mgr_channel_struct *ch)
+{
+    uint32_t dma, primask;
+
+    if(ch->request >= DMA_MGR_REQUEST_NUM) {
+        return;
+    }
+    dma = dma_mgr_index(ch->dma_periph);
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    dma_channel_disable(ch->dma_periph, ch->channel);
+    while(0U != (DMA_CHCTL(ch->dma_periph, ch->channel) & DMA_CHXCTL_CHEN)) {
+    }
+    dma_deinit(ch->dma_periph, ch->channel);
+    nvic_irq_disable(dma_mgr_irqn[dma][ch->channel]);
+    dma_mgr_slot[dma][ch->channel].owner = 0U;
+    dma_mgr_slot[dma][ch->channel].callback = NULL;
+    __set_PRIMASK(primask);
+
+    ch->request = DMA_MGR_REQUEST_NUM;
+}
+
+/*!
+    \brief    request owning a channel
+    \param[in]  dma_periph: DMA0 or DMA1
+    \param[in]  channel: DMA_CHx(x=0..7)
+    \param[out] none
+    \retval     request, DMA_MGR_REQUEST_NUM when the channel is free
+*/
+dma_mgr_request_enum dma_mgr_owner_get(uint32_t dma_periph, dma_channel_enum channel)
+{
+    uint8_t owner = dma_mgr_slot[dma_mgr_index(dma_periph)][channel].owner;
+
+    return (0U == owner) ? DMA_MGR_REQUEST_NUM : (dma_mgr_request_enum)(owner - 1U);
+}
+
+/*!
+    \brief    read the counters of a channel
+    \param[in]  dma_periph: DMA0 or DMA1
+    \param[in]  channel: DMA_CHx(x=0..7)
+    \param[out] stat: copy of the counters
+    \retval     none
+*/
+void dma_mgr_stat_get(uint32_t dma_periph, dma_channel_enum channel, dma_mgr_stat_struct *stat)
+{
+    *stat = dma_mgr_stat[dma_mgr_index(dma_periph)][channel];
+}
+
+/*!
+    \brief    DMA channel interrupt, called from every DMAx_Channely_IRQHandler
+    \param[in]  dma_periph: DMA0 or DMA1
+    \param[in]  channel: DMA_CHx(x=0..7)
+    \param[out] none
+    \retval     none
+    \note      all flags of the channel are read and cleared in one access each,
+                the callback gets them as DMA_INT_FLAG_x bits
+*/
+__FASTCODE void dma_mgr_irq(uint32_t dma_periph, dma_channel_enum channel)
+{
+    uint32_t dma = dma_mgr_index(dma_periph);
+    dma_mgr_slot_struct *slot = &dma_mgr_slot[dma][channel];
+    dma_mgr_stat_struct *stat = &dma_mgr_stat[dma][channel];
+    uint32_t shift = DMA_MGR_FLAG_SHIFT(channel);
+    uint32_t flags;
+
+    if(channel < DMA_CH4) {
+        flags = (DMA_INTF0(dma_periph) >> shift) & DMA_MGR_FLAGS;
+        DMA_INTC0(dma_periph) = flags << shift;
+    } else {
+        flags = (DMA_INTF1(dma_periph) >> shift) & DMA_MGR_FLAGS;
+        DMA_INTC1(dma_periph) = flags << shift;
+    }
+
+    stat->irqs++;
+    if(0U != (flags & DMA_INT_FLAG_FTF)) {
+        stat->transfers++;
+    }
+    if(0U != (flags & DMA_INT_FLAG_HTF)) {
+        stat->half_transfers++;
+    }
+    if(0U != (flags & (DMA_INT_FLAG_TAE | DMA_INT_FLAG_SDE))) {
+        stat->errors++;
+    }
+    if(0U != (flags & DMA_INT_FLAG_FEE)) {
+        stat->fifo_errors++;
+    }
+
+    if(0U == slot->owner) {
+        stat->unclaimed++;
+    } else if(NULL != slot->callback) {
+        slot->callback(slot->arg, flags);
+    }
+}
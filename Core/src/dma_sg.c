@@ -0,0 +1,318 @@
+/*!
+    \file    dma_sg.c
+    \brief   scatter-gather peripheral DMA walked from the transfer complete interrupt
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "dma_sg.h"
+#include "section.h"
+#include <stddef.h>
+
+/*!
+    \brief    stop the channel and leave it in single buffer mode
+    \param[in]  sg: scatter-gather channel
+    \param[out] none
+    \retval     none
+*/
+static void dma_sg_halt(dma_sg_struct *sg)
+{
+    uint32_t dma = sg->dma.dma_periph;
+    dma_channel_enum ch = sg->dma.channel;
+
+    dma_channel_disable(dma, ch);
+    while(0U != (DMA_CHCTL(dma, ch) & DMA_CHXCTL_CHEN)) {
+    }
+    dma_switch_buffer_mode_enable(dma, ch, DISABLE);
+    dma_circulation_disable(dma, ch);
+    dma_interrupt_flag_clear(dma, ch, DMA_MGR_FLAGS);
+    sg->loaded = NULL;
+}
+
+/*!
+    \brief    start a segment on the stopped channel
+    \param[in]  sg: scatter-gather channel
+    \param[in]  seg: segment, the list is finished when NULL
+    \param[out] none
+    \retval     none
+    \note      when the next segment has the same count it goes into the second
+                switch-buffer slot, the hardware then moves on to it without a gap
+*/
+static void dma_sg_load(dma_sg_struct *sg, dma_sg_desc_struct *seg)
+{
+    uint32_t dma = sg->dma.dma_periph;
+    dma_channel_enum ch = sg->dma.channel;
+    dma_sg_desc_struct *next;
+
+    if(NULL == seg) {
+        sg->active = NULL;
+        sg->busy = 0U;
+        sg->stat.lists++;
+        if(NULL != sg->callback) {
+            sg->callback(sg->arg, sg->list, SUCCESS);
+        }
+        return;
+    }
+
+    next = seg->next;
+    sg->active = seg;
+    DMA_CHCTL(dma, ch) &= ~DMA_CHXCTL_MBS;
+    dma_memory_address_config(dma, ch, DMA_MEMORY_0, (uint32_t)seg->addr);
+    dma_transfer_number_config(dma, ch, seg->count);
+    if((NULL != next) && (next->count == seg->count)) {
+        /* switch-buffer mode runs circular, the interrupt stops it before the last segment ends */
+        dma_switch_buffer_mode_config(dma, ch, (uint32_t)next->addr, DMA_MEMORY_0);
+        dma_circulation_enable(dma, ch);
+        dma_switch_buffer_mode_enable(dma, ch, ENABLE);
+        sg->loaded = next;
+    }
+    dma_interrupt_flag_clear(dma, ch, DMA_MGR_FLAGS);
+    dma_channel_enable(dma, ch);
+}
+
+/*!
+    \brief    a switch-buffer segment finished, the hardware is on the loaded one
+    \param[in]  sg: scatter-gather channel
+    \param[out] none
+    \retval     none
+    \note      the finished slot is refilled while the run of equal counts goes on.
+                When the running segment is the last of the run the channel is
+                stopped and the rest of it restarted in single buffer mode, so the
+                hardware never wraps round to a stale slot. This has to happen
+                within one segment time, as with any switch-buffer user
+*/
+static void dma_sg_switched(dma_sg_struct *sg)
+{
+    uint32_t dma = sg->dma.dma_periph;
+    dma_channel_enum ch = sg->dma.channel;
+    dma_sg_desc_struct *cur = sg->loaded;
+    dma_sg_desc_struct *after = cur->next;
+    uint32_t slot, remaining;
+
+    sg->stat.segments++;
+    sg->stat.switched++;
+    sg->active = cur;
+    slot = dma_using_memory_get(dma, ch);
+
+    if((NULL != after) && (after->count == cur->count)) {
+        /* the slot the DMA has just left takes the segment after the running one */
+        dma_memory_address_config(dma, ch, (DMA_MEMORY_1 == slot) ? DMA_MEMORY_0 : DMA_MEMORY_1, (uint32_t)after->addr);
+        sg->loaded = after;
+        return;
+    }
+
+    dma_sg_halt(sg);
+    remaining = dma_transfer_number_get(dma, ch);
+    if((dma_using_memory_get(dma, ch) != slot) || (0U == remaining)) {
+        /* the last segment of the run finished while stopping */
+        sg->stat.segments++;
+        dma_sg_load(sg, after);
+        return;
+    }
+    DMA_CHCTL(dma, ch) &= ~DMA_CHXCTL_MBS;
+    dma_memory_address_config(dma, ch, DMA_MEMORY_0,
+                              (uint32_t)cur->addr + (cur->count - remaining) * sg->width);
+    dma_transfer_number_config(dma, ch, remaining);
+    dma_channel_enable(dma, ch);
+}
+
+/*!
+    \brief    DMA event: move to the next segment or finish the list
+    \param[in]  arg: scatter-gather channel
+    \param[in]  flags: DMA_INT_FLAG_x of the channel
+    \param[out] none
+    \retval     none
+*/
+static void dma_sg_dma_event(void *arg, uint32_t flags)
+{
+    dma_sg_struct *sg = (dma_sg_struct *)arg;
+
+    if((0U == sg->busy) || (NULL == sg->active)) {
+        return;
+    }
+    if(0U != (flags & DMA_INT_FLAG_TAE)) {
+        dma_sg_halt(sg);
+        sg->active = NULL;
+        sg->busy = 0U;
+        sg->stat.errors++;
+        if(NULL != sg->callback) {
+            sg->callback(sg->arg, sg->list, ERROR);
+        }
+        return;
+    }
+    if(0U == (flags & DMA_INT_FLAG_FTF)) {
+        return;
+    }
+
+    if(NULL != sg->loaded) {
+        dma_sg_switched(sg);
+    } else {
+        /* single buffer mode: the hardware has stopped the channel */
+        sg->stat.segments++;
+        if(NULL != sg->active->next) {
+            sg->stat.restarts++;
+        }
+        dma_sg_load(sg, sg->active->next);
+    }
+}
+
+/*!
+    \brief    take a channel for the peripheral
+    \param[in]  sg: scatter-gather channel
+    \param[in]  config: channel description, copied
+    \param[out] none
+    \retval     SUCCESS, or ERROR when no channel serves the request
+    \note      the channel runs in direct mode so the remaining count is exact when
+                it is stopped between switch-buffer runs
+*/
+ErrStatus dma_sg_init(dma_sg_struct *sg, const dma_sg_config_struct *config)
+{
+    dma_single_data_parameter_struct dma_init_struct;
+
+    sg->config = *config;
+    sg->width = 1U << (config->periph_width >> 11);
+    sg->list = NULL;
+    sg->active = NULL;
+    sg->loaded = NULL;
+    sg->busy = 0U;
+    sg->stat.lists = 0U;
+    sg->stat.segments = 0U;
+    sg->stat.switched = 0U;
+    sg->stat.restarts = 0U;
+    sg->stat.errors = 0U;
+    sg->dma.request = DMA_MGR_REQUEST_NUM;
+    if(SUCCESS != dma_mgr_alloc(config->request, dma_sg_dma_event, sg, config->irq_priority, &sg->dma)) {
+        return ERROR;
+    }
+
+    dma_single_data_para_struct_init(&dma_init_struct);
+    dma_init_struct.periph_addr = config->periph_addr;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = config->periph_width;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_DISABLE;
+    dma_init_struct.direction = config->direction;
+    dma_init_struct.priority = config->priority;
+    dma_single_data_mode_init(sg->dma.dma_periph, sg->dma.channel, &dma_init_struct);
+    dma_interrupt_enable(sg->dma.dma_periph, sg->dma.channel, DMA_INT_FTF | DMA_INT_TAE);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    stop and give the channel back
+    \param[in]  sg: scatter-gather channel
+    \param[out] none
+    \retval     none
+*/
+void dma_sg_deinit(dma_sg_struct *sg)
+{
+    dma_sg_abort(sg);
+    dma_mgr_free(&sg->dma);
+}
+
+/*!
+    \brief    start transferring a list
+    \param[in]  sg: scatter-gather channel
+    \param[in]  list: first segment, owned by the channel until the completion
+    \param[in]  callback: completion, NULL to poll dma_sg_busy()
+    \param[in]  arg: callback argument
+    \param[out] none
+    \retval     SUCCESS, or ERROR when busy, without a channel or on a bad segment
+    \note      the caller enables the peripheral DMA request afterwards, e.g.
+                spi_dma_enable(). Between segments of different counts the channel
+                restarts from the interrupt and the peripheral waits for it, runs of
+                equal counts go through both switch-buffer slots without that gap
+*/
+ErrStatus dma_sg_start(dma_sg_struct *sg, dma_sg_desc_struct *list, dma_sg_callback callback, void *arg)
+{
+    dma_sg_desc_struct *seg;
+
+    if((0U != sg->busy) || (DMA_MGR_REQUEST_NUM == sg->dma.request) || (NULL == list)) {
+        return ERROR;
+    }
+    for(seg = list; NULL != seg; seg = seg->next) {
+        if((0U == seg->count) || (seg->count > 0xFFFFU) || SECTION_IN_TCM(seg->addr) ||
+           (0U != ((uint32_t)seg->addr & (sg->width - 1U)))) {
+            return ERROR;
+        }
+    }
+
+    sg->list = list;
+    sg->callback = callback;
+    sg->arg = arg;
+    sg->busy = 1U;
+    dma_sg_load(sg, list);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    check whether a list is running
+    \param[in]  sg: scatter-gather channel
+    \param[out] none
+    \retval     1 while running, 0 otherwise
+*/
+uint32_t dma_sg_busy(const dma_sg_struct *sg)
+{
+    return sg->busy;
+}
+
+/*!
+    \brief    stop the running list without calling its completion
+    \param[in]  sg: scatter-gather channel
+    \param[out] none
+    \retval     none
+*/
+void dma_sg_abort(dma_sg_struct *sg)
+{
+    uint32_t primask;
+
+    if(DMA_MGR_REQUEST_NUM == sg->dma.request) {
+        return;
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    dma_sg_halt(sg);
+    sg->active = NULL;
+    sg->busy = 0U;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  sg: scatter-gather channel
+    \param[out] stat: copy of the counters
+    \retval     none
+*/
+void dma_sg_stat_get(const dma_sg_struct *sg, dma_sg_stat_struct *stat)
+{
+    *stat = sg->stat;
+}
@@ -0,0 +1,208 @@
+/*!
+    \file    enet_poll.c
+    \brief   ENET receive with coalesced interrupts and budgeted polling
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "enet_poll.h"
+#include "event.h"
+#include "section.h"
+#include <string.h>
+
+/* the receive interrupt only schedules a poll pass and stays masked while passes
+   find frames, a pass handles at most the budget and queues the next one behind
+   every pending event, so a flood of small frames cannot starve the rest of the
+   system. The interrupt comes back once a pass drains the ring */
+
+static void enet_poll_run(uint32_t param);
+
+static enet_poll_parameter_struct enet_poll_para;
+static enet_poll_stat_struct enet_poll_stat;
+static EVENT_HANDLER_DEFINE(enet_poll_event, enet_poll_run);
+static event_work_struct enet_poll_work;
+static volatile uint32_t enet_poll_running = 0U;
+/* set by the interrupt, cleared by the pass that measures the latency */
+static volatile uint32_t enet_poll_irq_pending = 0U;
+static volatile uint32_t enet_poll_irq_time = 0U;
+
+/*!
+    \brief    initialize the parameter struct with default values
+    \param[in]  none
+    \param[out] para: parameters
+    \retval     none
+*/
+void enet_poll_struct_para_init(enet_poll_parameter_struct *para)
+{
+    para->delay = 4U;
+    para->budget = 16U;
+    para->irq_priority = 2U;
+    para->handler = NULL;
+    para->arg = NULL;
+}
+
+/*!
+    \brief    start interrupt driven reception on an initialized and enabled ENET
+    \param[in]  para: parameters, handler is required
+    \param[out] none
+    \retval     none
+    \note      the Rx descriptors must be initialized, ENET_IRQHandler must call
+                enet_poll_irq(). Frames are delivered from event_dispatch()
+*/
+void enet_poll_init(const enet_poll_parameter_struct *para)
+{
+    enet_poll_para = *para;
+    if(0U == enet_poll_para.budget) {
+        enet_poll_para.budget = 1U;
+    }
+    memset(&enet_poll_stat, 0, sizeof(enet_poll_stat));
+    event_work_init(&enet_poll_work, &enet_poll_event);
+
+    if(0U == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+
+    enet_rx_coalesce_config(enet_poll_para.delay);
+    enet_poll_irq_pending = 0U;
+    enet_poll_running = 1U;
+    enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_RS_CLR);
+    enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_NI_CLR);
+    enet_interrupt_enable(ENET_DMA_INT_NIE);
+    nvic_irq_enable(ENET_IRQn, enet_poll_para.irq_priority, 0U);
+
+    /* frames already in the ring raised RS before it was cleared, the first pass takes them */
+    event_work_submit(&enet_poll_work, 0U);
+}
+
+/*!
+    \brief    stop reception, frames stay in the ring
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void enet_poll_stop(void)
+{
+    enet_poll_running = 0U;
+    enet_interrupt_disable(ENET_DMA_INT_RIE);
+    nvic_irq_disable(ENET_IRQn);
+}
+
+/*!
+    \brief    ENET interrupt: receive status
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void enet_poll_irq(void)
+{
+    if(SET == enet_interrupt_flag_get(ENET_DMA_INT_FLAG_RS)) {
+        /* polling mode until a pass drains the ring */
+        enet_interrupt_disable(ENET_DMA_INT_RIE);
+        enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_RS_CLR);
+        enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_NI_CLR);
+        enet_poll_stat.irqs++;
+        enet_poll_irq_time = DWT->CYCCNT;
+        enet_poll_irq_pending = 1U;
+        event_work_submit(&enet_poll_work, 0U);
+    }
+}
+
+/*!
+    \brief    one poll pass, deferred work item
+    \param[in]  param: unused
+    \param[out] none
+    \retval     none
+*/
+static void enet_poll_run(uint32_t param)
+{
+    enet_rxframe_struct frame;
+    uint32_t count = 0U, latency, fifo_drop, dma_drop;
+
+    (void)param;
+    if(0U == enet_poll_running) {
+        return;
+    }
+    if(0U != enet_poll_irq_pending) {
+        enet_poll_irq_pending = 0U;
+        latency = DWT->CYCCNT - enet_poll_irq_time;
+        enet_poll_stat.latency_total += latency;
+        if(latency > enet_poll_stat.latency_max) {
+            enet_poll_stat.latency_max = latency;
+        }
+    }
+    enet_poll_stat.polls++;
+
+    while(count < enet_poll_para.budget) {
+        if(SUCCESS != enet_rxframe_loan(&frame)) {
+            /* RS is cleared before the last look, a frame completing after it raises the interrupt */
+            enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_RS_CLR);
+            if(SUCCESS != enet_rxframe_loan(&frame)) {
+                break;
+            }
+        }
+        /* the handler returns or swaps the frame */
+        enet_poll_para.handler(enet_poll_para.arg, &frame);
+        count++;
+    }
+
+    enet_poll_stat.frames += count;
+    if(count > enet_poll_stat.frames_per_poll_max) {
+        enet_poll_stat.frames_per_poll_max = count;
+    }
+    /* the counters clear on read */
+    enet_missed_frame_counter_get(&fifo_drop, &dma_drop);
+    enet_poll_stat.rx_missed += fifo_drop + dma_drop;
+
+    if(count == enet_poll_para.budget) {
+        /* more may be waiting: stay in polling mode behind the pending events */
+        enet_poll_stat.budget_exhausted++;
+        event_work_submit(&enet_poll_work, 0U);
+    } else {
+        /* ring drained: back to interrupt mode */
+        enet_interrupt_enable(ENET_DMA_INT_RIE);
+    }
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  none
+    \param[out] stat: counters
+    \retval     none
+*/
+void enet_poll_stat_get(enet_poll_stat_struct *stat)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    *stat = enet_poll_stat;
+    __set_PRIMASK(primask);
+}
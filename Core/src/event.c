@@ -0,0 +1,335 @@
+/*!
+    \file    event.c
+    \brief   run-to-completion event scheduler with priority queues and deferred work
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "event.h"
+#include "systick.h"
+#include "section.h"
+#include <stdio.h>
+
+#define EVENT_QUEUE_MASK                 (EVENT_QUEUE_SIZE - 1U)
+
+/* queued event */
+typedef struct {
+    event_handler_struct *handler;
+    uint32_t param;
+} event_entry_struct;
+
+/* single priority queue */
+typedef struct {
+    event_entry_struct entry[EVENT_QUEUE_SIZE];
+    uint32_t head;
+    uint32_t tail;
+    event_queue_stat_struct stat;
+} event_queue_struct;
+
+static event_queue_struct event_queue[EVENT_PRIORITIES] __TCM_BSS;
+/* bit n set while queue n holds events */
+static volatile uint32_t event_ready;
+/* deferred work list, run after all priority queues */
+static event_work_struct *work_head;
+static event_work_struct *work_tail;
+/* handlers seen so far, for reporting */
+static event_handler_struct *handler_list;
+static event_idle_hook idle_hook = NULL;
+
+/*!
+    \brief    link a handler into the report list on first use
+    \param[in]  handler: handler descriptor
+    \param[out] none
+    \retval     none
+    \note      called with interrupts masked
+*/
+static void handler_track(event_handler_struct *handler)
+{
+    event_handler_struct *item;
+
+    for(item = handler_list; NULL != item; item = item->next) {
+        if(item == handler) {
+            return;
+        }
+    }
+    handler->next = handler_list;
+    handler_list = handler;
+}
+
+/*!
+    \brief    run a handler and account its execution time
+    \param[in]  handler: handler descriptor
+    \param[in]  param: handler parameter
+    \param[out] none
+    \retval     none
+*/
+static void handler_run(event_handler_struct *handler, uint32_t param)
+{
+    uint32_t start = systick_cycle_get();
+    uint32_t cycles;
+
+    handler->handler(param);
+
+    cycles = systick_cycle_elapsed(start, systick_cycle_get());
+    handler->count++;
+    handler->cycles_total += cycles;
+    if(cycles > handler->cycles_max) {
+        handler->cycles_max = cycles;
+    }
+}
+
+/*!
+    \brief    post an event, safe from interrupt context
+    \param[in]  handler: handler descriptor run for the event
+    \param[in]  param: handler parameter
+    \param[in]  priority: queue priority, 0 is the highest
+    \param[out] none
+    \retval     0 on success, -1 if the queue is full or priority is invalid
+*/
+int event_post(event_handler_struct *handler, uint32_t param, uint32_t priority)
+{
+    event_queue_struct *queue;
+    uint32_t primask, fill;
+
+    if(priority >= EVENT_PRIORITIES) {
+        return -1;
+    }
+    queue = &event_queue[priority];
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    fill = queue->head - queue->tail;
+    if(fill >= EVENT_QUEUE_SIZE) {
+        queue->stat.dropped++;
+        __set_PRIMASK(primask);
+        return -1;
+    }
+    if(0U == handler->count) {
+        handler_track(handler);
+    }
+    queue->entry[queue->head & EVENT_QUEUE_MASK].handler = handler;
+    queue->entry[queue->head & EVENT_QUEUE_MASK].param = param;
+    queue->head++;
+    queue->stat.posted++;
+    if(fill + 1U > queue->stat.high_water) {
+        queue->stat.high_water = fill + 1U;
+    }
+    event_ready |= (1UL << priority);
+    __set_PRIMASK(primask);
+
+    return 0;
+}
+
+/*!
+    \brief    initialize a deferred work item
+    \param[in]  work: work item
+    \param[in]  handler: handler descriptor run for the work
+    \param[out] none
+    \retval     none
+*/
+void event_work_init(event_work_struct *work, event_handler_struct *handler)
+{
+    work->handler = handler;
+    work->param = 0U;
+    work->next = NULL;
+    work->pending = 0U;
+}
+
+/*!
+    \brief    queue a deferred work item, safe from interrupt context
+    \param[in]  work: initialized work item
+    \param[in]  param: handler parameter, replaces the one of a still pending submission
+    \param[out] none
+    \retval     none
+*/
+void event_work_submit(event_work_struct *work, uint32_t param)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    work->param = param;
+    if(0U == work->pending) {
+        work->pending = 1U;
+        work->next = NULL;
+        if(NULL == work_tail) {
+            work_head = work;
+        } else {
+            work_tail->next = work;
+        }
+        work_tail = work;
+        if(0U == work->handler->count) {
+            handler_track(work->handler);
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    run the highest priority ready event or work item
+    \param[in]  none
+    \param[out] none
+    \retval     1 if something was run, 0 if nothing was ready
+*/
+uint32_t event_dispatch(void)
+{
+    event_queue_struct *queue;
+    event_entry_struct entry;
+    event_work_struct *work;
+    uint32_t priority, param, primask, ready;
+
+    /* one read, an interrupt may set more bits meanwhile */
+    ready = event_ready;
+    if(0U != ready) {
+        /* lowest set bit is the highest priority */
+        priority = __CLZ(__RBIT(ready));
+        queue = &event_queue[priority];
+
+        primask = __get_PRIMASK();
+        __disable_irq();
+        entry = queue->entry[queue->tail & EVENT_QUEUE_MASK];
+        queue->tail++;
+        if(queue->tail == queue->head) {
+            event_ready &= ~(1UL << priority);
+        }
+        __set_PRIMASK(primask);
+
+        handler_run(entry.handler, entry.param);
+        return 1U;
+    }
+
+    if(NULL != work_head) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        work = work_head;
+        work_head = work->next;
+        if(NULL == work_head) {
+            work_tail = NULL;
+        }
+        param = work->param;
+        work->pending = 0U;
+        __set_PRIMASK(primask);
+
+        handler_run(work->handler, param);
+        return 1U;
+    }
+
+    return 0U;
+}
+
+/*!
+    \brief    check whether events or work items are ready
+    \param[in]  none
+    \param[out] none
+    \retval     1 if event_dispatch() has something to run, 0 otherwise
+*/
+int event_pending(void)
+{
+    return ((0U != event_ready) || (NULL != work_head)) ? 1 : 0;
+}
+
+/*!
+    \brief    install the idle hook
+    \param[in]  hook: function that puts the core to sleep, NULL for a plain WFI
+    \param[out] none
+    \retval     none
+*/
+void event_idle_hook_set(event_idle_hook hook)
+{
+    idle_hook = hook;
+}
+
+/*!
+    \brief    sleep through the idle hook if nothing is ready
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void event_idle(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    /* masked so an event posted from an interrupt now still wakes the core */
+    __disable_irq();
+    if(!event_pending()) {
+        if(NULL != idle_hook) {
+            idle_hook();
+        } else {
+            __WFI();
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    get the statistics of a priority queue
+    \param[in]  priority: queue priority
+    \param[out] stat: copy of the queue statistics
+    \retval     none
+*/
+void event_queue_stat_get(uint32_t priority, event_queue_stat_struct *stat)
+{
+    uint32_t primask;
+
+    if(priority < EVENT_PRIORITIES) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        *stat = event_queue[priority].stat;
+        __set_PRIMASK(primask);
+    }
+}
+
+/*!
+    \brief    print handler and queue statistics
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void event_stats_print(void)
+{
+    event_handler_struct *handler;
+    uint32_t priority;
+    uint32_t cycles_per_us = SystemCoreClock / 1000000U;
+
+    printf("\r\nprio  posted  dropped  high-water");
+    for(priority = 0U; priority < EVENT_PRIORITIES; priority++) {
+        printf("\r\n%4lu %7lu %8lu %11lu/%u", (unsigned long)priority,
+               (unsigned long)event_queue[priority].stat.posted,
+               (unsigned long)event_queue[priority].stat.dropped,
+               (unsigned long)event_queue[priority].stat.high_water, EVENT_QUEUE_SIZE);
+    }
+
+    printf("\r\nhandler                   runs   mean(us)   max(us)");
+    for(handler = handler_list; NULL != handler; handler = handler->next) {
+        printf("\r\n%-22s %7lu %10lu %9lu", handler->name, (unsigned long)handler->count,
+               (unsigned long)(handler->count ? (handler->cycles_total / handler->count) / cycles_per_us : 0U),
+               (unsigned long)(handler->cycles_max / cycles_per_us));
+    }
+}
@@ -0,0 +1,387 @@
+/*!
+    \file    frame.c
+    \brief   COBS framed binary transport with hardware CRC32 over a serial port
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "frame.h"
+#include "ring.h"
+#include "crc_engine.h"
+#include <stddef.h>
+#include <string.h>
+
+/* longest run of non-zero bytes in one COBS block */
+#define FRAME_COBS_RUN                   254U
+
+/* COBS encoder writing into a transmit ring reservation, or only counting */
+typedef struct {
+    serial_port_enum port;                                             /*!< port owning the reservation */
+    uint32_t pos;                                                      /*!< next data write index */
+    uint32_t code_pos;                                                 /*!< write index of the open block's code byte */
+    uint32_t run;                                                      /*!< data bytes in the open block */
+    uint32_t write;                                                    /*!< 0 for the sizing pass */
+} frame_cobs_struct;
+
+/*!
+    \brief    CRC of a frame
+    \param[in]  header: FRAME_HEADER_SIZE bytes
+    \param[in]  payload: payload bytes, any alignment
+    \param[in]  len: payload length
+    \param[out] none
+    \retval     CRC-32/MPEG-2 as described in frame.h
+*/
+static uint32_t frame_crc(const uint8_t *header, const uint8_t *payload, uint32_t len)
+{
+    static const uint8_t zero[4] = {0U, 0U, 0U, 0U};
+    crc_engine_ctx_struct ctx;
+
+    crc_engine_start(&ctx, CRC_ENGINE_WORD);
+    crc_engine_update(&ctx, header, FRAME_HEADER_SIZE);
+    crc_engine_update(&ctx, payload, len);
+    if(0U != (len & 3U)) {
+        crc_engine_update(&ctx, zero, 4U - (len & 3U));
+    }
+    /* the length word keeps trailing zero bytes from matching the padding */
+    crc_engine_update(&ctx, &len, sizeof(len));
+
+    return crc_engine_final(&ctx);
+}
+
+/*!
+    \brief    start encoding at a write index
+    \param[in]  cobs: encoder
+    \param[in]  port: serial port
+    \param[in]  pos: first byte of the reservation, 0 for the sizing pass
+    \param[in]  write: 0 to count only
+    \param[out] none
+    \retval     none
+*/
+static void frame_cobs_start(frame_cobs_struct *cobs, serial_port_enum port, uint32_t pos, uint32_t write)
+{
+    cobs->port = port;
+    cobs->code_pos = pos;
+    cobs->pos = pos + 1U;
+    cobs->run = 0U;
+    cobs->write = write;
+}
+
+/*!
+    \brief    close the open block and open the next one
+    \param[in]  cobs: encoder
+    \param[out] none
+    \retval     none
+*/
+static void frame_cobs_next(frame_cobs_struct *cobs)
+{
+    uint8_t code = (uint8_t)(cobs->run + 1U);
+
+    if(0U != cobs->write) {
+        serial_write_put(cobs->port, cobs->code_pos, &code, 1U);
+    }
+    cobs->code_pos = cobs->pos;
+    cobs->pos++;
+    cobs->run = 0U;
+}
+
+/*!
+    \brief    encode bytes, runs of non-zero bytes are copied straight from the source
+    \param[in]  cobs: encoder
+    \param[in]  data: source
+    \param[in]  len: bytes
+    \param[out] none
+    \retval     none
+*/
+static void frame_cobs_feed(frame_cobs_struct *cobs, const uint8_t *data, uint32_t len)
+{
+    uint32_t n, limit;
+
+    while(0U != len) {
+        limit = FRAME_COBS_RUN - cobs->run;
+        for(n = 0U; (n < len) && (n < limit) && (0U != data[n]); n++) {
+        }
+        if(0U != n) {
+            if(0U != cobs->write) {
+                serial_write_put(cobs->port, cobs->pos, data, n);
+            }
+            cobs->pos += n;
+            cobs->run += n;
+            data += n;
+            len -= n;
+        }
+        if(FRAME_COBS_RUN == cobs->run) {
+            /* full block, code 0xFF carries no implicit zero */
+            frame_cobs_next(cobs);
+        } else if(0U != len) {
+            /* the zero itself is carried by the code byte */
+            frame_cobs_next(cobs);
+            data++;
+            len--;
+        }
+    }
+}
+
+/*!
+    \brief    close the last block and append the delimiter
+    \param[in]  cobs: encoder
+    \param[in]  base: write index passed to frame_cobs_start()
+    \param[out] none
+    \retval     encoded length including the delimiter
+*/
+static uint32_t frame_cobs_finish(frame_cobs_struct *cobs, uint32_t base)
+{
+    uint8_t delimiter = 0U;
+
+    frame_cobs_next(cobs);
+    if(0U != cobs->write) {
+        serial_write_put(cobs->port, cobs->code_pos, &delimiter, 1U);
+    }
+
+    return cobs->pos - base;
+}
+
+/*!
+    \brief    check and deliver a decoded frame
+    \param[in]  frame: link
+    \param[out] none
+    \retval     none
+*/
+static void frame_deliver(frame_struct *frame)
+{
+    uint8_t *buffer = frame->para.rx_buffer;
+    uint32_t len, crc;
+    uint16_t seq;
+
+    if(frame->rx_len < FRAME_OVERHEAD) {
+        frame->stat.cobs_errors++;
+        return;
+    }
+    len = frame->rx_len - FRAME_OVERHEAD;
+    memcpy(&crc, &buffer[FRAME_HEADER_SIZE + len], sizeof(crc));
+    if(crc != frame_crc(buffer, &buffer[FRAME_HEADER_SIZE], len)) {
+        frame->stat.crc_errors++;
+        return;
+    }
+
+    seq = (uint16_t)(buffer[0] | ((uint16_t)buffer[1] << 8));
+    if((0U != frame->rx_synced) && (seq != (uint16_t)(frame->rx_seq + 1U))) {
+        frame->stat.lost += (uint16_t)(seq - frame->rx_seq - 1U);
+    }
+    frame->rx_seq = seq;
+    frame->rx_synced = 1U;
+    frame->stat.rx_frames++;
+    frame->stat.rx_bytes += len;
+
+    if(NULL != frame->para.callback) {
+        frame->para.callback(frame->para.arg, buffer[2], seq, &buffer[FRAME_HEADER_SIZE], len);
+    }
+}
+
+/*!
+    \brief    initialize the parameter struct with default values
+    \param[in]  none
+    \param[out] para: parameters
+    \retval     none
+*/
+void frame_struct_para_init(frame_parameter_struct *para)
+{
+    para->port = SERIAL_USART1;
+    para->rx_buffer = NULL;
+    para->rx_size = 0U;
+    para->callback = NULL;
+    para->arg = NULL;
+}
+
+/*!
+    \brief    open the serial port with frame reception and reset the link
+    \param[in]  frame: link
+    \param[in]  para: link parameters
+    \param[in]  serial_para: port parameters, the receive callback is replaced
+    \param[out] none
+    \retval     result of serial_open()
+    \note      frames are decoded in the USART and DMA interrupts as bytes arrive,
+                the receive DMA buffer only has to cover the interrupt latency
+*/
+ErrStatus frame_open(frame_struct *frame, const frame_parameter_struct *para, const serial_parameter_struct *serial_para)
+{
+    serial_parameter_struct port_para = *serial_para;
+
+    memset(frame, 0, sizeof(*frame));
+    frame->para = *para;
+    crc_engine_init();
+
+    port_para.rx_callback = frame_rx_handler;
+    port_para.rx_arg = frame;
+
+    return serial_open(para->port, &port_para);
+}
+
+/*!
+    \brief    encode a frame straight into the transmit ring, callable from any context
+    \param[in]  frame: link
+    \param[in]  type: message type
+    \param[in]  payload: payload bytes, any alignment
+    \param[in]  len: payload length
+    \param[out] none
+    \retval     SUCCESS, or ERROR when the transmit ring had no room
+    \note      the payload is read twice, once to size the COBS output and once to
+                copy it into the ring, there is no intermediate frame buffer
+*/
+ErrStatus frame_send(frame_struct *frame, uint8_t type, const void *payload, uint32_t len)
+{
+    serial_port_enum port = frame->para.port;
+    frame_cobs_struct cobs;
+    uint8_t header[FRAME_HEADER_SIZE];
+    uint8_t trailer[FRAME_CRC_SIZE];
+    uint32_t primask, crc, size, base;
+    uint16_t seq;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    seq = frame->tx_seq++;
+    __set_PRIMASK(primask);
+
+    header[0] = (uint8_t)seq;
+    header[1] = (uint8_t)(seq >> 8);
+    header[2] = type;
+    header[3] = 0U;
+    crc = frame_crc(header, (const uint8_t *)payload, len);
+    memcpy(trailer, &crc, sizeof(trailer));
+
+    frame_cobs_start(&cobs, port, 0U, 0U);
+    frame_cobs_feed(&cobs, header, sizeof(header));
+    frame_cobs_feed(&cobs, (const uint8_t *)payload, len);
+    frame_cobs_feed(&cobs, trailer, sizeof(trailer));
+    size = frame_cobs_finish(&cobs, 0U);
+
+    if(SUCCESS != serial_write_begin(port, size, &base)) {
+        ring_atomic_add(&frame->stat.tx_dropped, 1U);
+        return ERROR;
+    }
+    frame_cobs_start(&cobs, port, base, 1U);
+    frame_cobs_feed(&cobs, header, sizeof(header));
+    frame_cobs_feed(&cobs, (const uint8_t *)payload, len);
+    frame_cobs_feed(&cobs, trailer, sizeof(trailer));
+    frame_cobs_finish(&cobs, base);
+    serial_write_end(port, size);
+    ring_atomic_add(&frame->stat.tx_frames, 1U);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    feed received bytes to the decoder
+    \param[in]  frame: link
+    \param[in]  data: bytes as received
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     none
+*/
+void frame_receive(frame_struct *frame, const uint8_t *data, uint32_t len)
+{
+    uint32_t i;
+    uint8_t byte;
+
+    for(i = 0U; i < len; i++) {
+        byte = data[i];
+        if(0U == byte) {
+            /* delimiter, the last block must be complete */
+            if(0U == frame->rx_discard) {
+                if(0U != frame->rx_remaining) {
+                    frame->stat.cobs_errors++;
+                } else if(0U != frame->rx_len) {
+                    frame_deliver(frame);
+                }
+            }
+            frame->rx_len = 0U;
+            frame->rx_code = 0U;
+            frame->rx_remaining = 0U;
+            frame->rx_discard = 0U;
+            continue;
+        }
+        if(0U != frame->rx_discard) {
+            continue;
+        }
+
+        if(0U == frame->rx_remaining) {
+            /* a new block, the previous one ended in a zero unless it was full */
+            if((0U != frame->rx_code) && (0xFFU != frame->rx_code)) {
+                byte = 0U;
+            }
+            frame->rx_code = data[i];
+            frame->rx_remaining = (uint8_t)(data[i] - 1U);
+            if(0U != byte) {
+                continue;
+            }
+        } else {
+            frame->rx_remaining--;
+        }
+
+        if(frame->rx_len >= frame->para.rx_size) {
+            frame->stat.overlong++;
+            frame->rx_discard = 1U;
+            continue;
+        }
+        frame->para.rx_buffer[frame->rx_len++] = byte;
+    }
+}
+
+/*!
+    \brief    usart_rx callback, installed by frame_open()
+    \param[in]  arg: link
+    \param[in]  data0: first segment
+    \param[in]  len0: first segment length
+    \param[in]  data1: wrapped segment or NULL
+    \param[in]  len1: wrapped segment length
+    \param[in]  flags: USART_RX_FRAME_PARTIAL, frames are delimited by 0x00 here
+    \param[out] none
+    \retval     none
+*/
+void frame_rx_handler(void *arg, const uint8_t *data0, uint32_t len0,
+                      const uint8_t *data1, uint32_t len1, uint32_t flags)
+{
+    frame_struct *frame = (frame_struct *)arg;
+
+    frame_receive(frame, data0, len0);
+    if(NULL != data1) {
+        frame_receive(frame, data1, len1);
+    }
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  frame: link
+    \param[out] stat: copy of the counters
+    \retval     none
+*/
+void frame_stat_get(frame_struct *frame, frame_stat_struct *stat)
+{
+    *stat = frame->stat;
+}
@@ -35,6 +35,13 @@ OF SUCH DAMAGE.
 #include "gd32f4xx_it.h"
 #include "main.h"
 #include "systick.h"
+#include "soft_timer.h"
+#include "kernel.h"
+#include "bench.h"
+#include "section.h"
+#include "serial.h"
+#include "dma_mgr.h"
+#include "enet_poll.h"
 
 /*!
     \brief      this function handles NMI exception
@@ -107,11 +114,10 @@ void UsageFault_Handler(void)
     \param[out] none
     \retval     none
 */
-void SVC_Handler(void)
+__attribute__((naked)) void SVC_Handler(void)
 {
-    /* if SVC exception occurs, go to infinite loop */
-    while(1) {
-    }
+    /* start the first kernel task, the stack must be left untouched */
+    __ASM volatile("b kernel_svc");
 }
 
 /*!
@@ -133,11 +139,10 @@ void DebugMon_Handler(void)
     \param[out] none
     \retval     none
 */
-void PendSV_Handler(void)
+__attribute__((naked)) void PendSV_Handler(void)
 {
-    /* if PendSV exception occurs, go to infinite loop */
-    while(1) {
-    }
+    /* kernel context switch, the stack must be left untouched */
+    __ASM volatile("b kernel_pendsv");
 }
 
 /*!
@@ -146,8 +151,292 @@ void PendSV_Handler(void)
     \param[out] none
     \retval     none
 */
-void SysTick_Handler(void)
+__FASTCODE void SysTick_Handler(void)
+{
+#ifdef BENCH_IRQ
+    bench_irq_systick_probe();
+#endif /* BENCH_IRQ */
+    systick_tick_increment();
+    soft_timer_process(systick_tick_get());
+}
+
+/*!
+    \brief      this function handles DMA0 channel 0 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA0_Channel0_IRQHandler(void)
+{
+    dma_mgr_irq(DMA0, DMA_CH0);
+}
+
+/*!
+    \brief      this function handles DMA0 channel 1 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA0_Channel1_IRQHandler(void)
+{
+    dma_mgr_irq(DMA0, DMA_CH1);
+}
+
+/*!
+    \brief      this function handles DMA0 channel 2 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA0_Channel2_IRQHandler(void)
+{
+    dma_mgr_irq(DMA0, DMA_CH2);
+}
+
+/*!
+    \brief      this function handles DMA0 channel 3 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA0_Channel3_IRQHandler(void)
+{
+    dma_mgr_irq(DMA0, DMA_CH3);
+}
+
+/*!
+    \brief      this function handles DMA0 channel 4 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA0_Channel4_IRQHandler(void)
+{
+    dma_mgr_irq(DMA0, DMA_CH4);
+}
+
+/*!
+    \brief      this function handles DMA0 channel 5 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA0_Channel5_IRQHandler(void)
 {
-    led_spark();
-    delay_decrement();
+    dma_mgr_irq(DMA0, DMA_CH5);
+}
+
+/*!
+    \brief      this function handles DMA0 channel 6 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA0_Channel6_IRQHandler(void)
+{
+    dma_mgr_irq(DMA0, DMA_CH6);
+}
+
+/*!
+    \brief      this function handles DMA0 channel 7 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA0_Channel7_IRQHandler(void)
+{
+    dma_mgr_irq(DMA0, DMA_CH7);
+}
+
+/*!
+    \brief      this function handles DMA1 channel 0 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA1_Channel0_IRQHandler(void)
+{
+    dma_mgr_irq(DMA1, DMA_CH0);
+}
+
+/*!
+    \brief      this function handles DMA1 channel 1 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA1_Channel1_IRQHandler(void)
+{
+    dma_mgr_irq(DMA1, DMA_CH1);
+}
+
+/*!
+    \brief      this function handles DMA1 channel 2 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA1_Channel2_IRQHandler(void)
+{
+    dma_mgr_irq(DMA1, DMA_CH2);
+}
+
+/*!
+    \brief      this function handles DMA1 channel 3 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA1_Channel3_IRQHandler(void)
+{
+    dma_mgr_irq(DMA1, DMA_CH3);
+}
+
+/*!
+    \brief      this function handles DMA1 channel 4 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA1_Channel4_IRQHandler(void)
+{
+    dma_mgr_irq(DMA1, DMA_CH4);
+}
+
+/*!
+    \brief      this function handles DMA1 channel 5 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA1_Channel5_IRQHandler(void)
+{
+    dma_mgr_irq(DMA1, DMA_CH5);
+}
+
+/*!
+    \brief      this function handles DMA1 channel 6 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA1_Channel6_IRQHandler(void)
+{
+    dma_mgr_irq(DMA1, DMA_CH6);
+}
+
+/*!
+    \brief      this function handles DMA1 channel 7 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void DMA1_Channel7_IRQHandler(void)
+{
+    dma_mgr_irq(DMA1, DMA_CH7);
+}
+
+/*!
+    \brief      this function handles USART0 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USART0_IRQHandler(void)
+{
+    serial_usart_irq(SERIAL_USART0);
+}
+
+/*!
+    \brief      this function handles USART1 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USART1_IRQHandler(void)
+{
+    serial_usart_irq(SERIAL_USART1);
+}
+
+/*!
+    \brief      this function handles USART2 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USART2_IRQHandler(void)
+{
+    serial_usart_irq(SERIAL_USART2);
+}
+
+/*!
+    \brief      this function handles UART3 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void UART3_IRQHandler(void)
+{
+    serial_usart_irq(SERIAL_UART3);
+}
+
+/*!
+    \brief      this function handles UART4 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void UART4_IRQHandler(void)
+{
+    serial_usart_irq(SERIAL_UART4);
+}
+
+/*!
+    \brief      this function handles USART5 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void USART5_IRQHandler(void)
+{
+    serial_usart_irq(SERIAL_USART5);
+}
+
+/*!
+    \brief      this function handles UART6 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void UART6_IRQHandler(void)
+{
+    serial_usart_irq(SERIAL_UART6);
+}
+
+/*!
+    \brief      this function handles UART7 interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void UART7_IRQHandler(void)
+{
+    serial_usart_irq(SERIAL_UART7);
+}
+
+/*!
+    \brief      this function handles ENET interrupt
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void ENET_IRQHandler(void)
+{
+    /* zero-copy frames sent: give the buffers back and run their callbacks */
+    if(SET == enet_interrupt_flag_get(ENET_DMA_INT_FLAG_TS)) {
+        enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_TS_CLR);
+        enet_interrupt_flag_clear(ENET_DMA_INT_FLAG_NI_CLR);
+        (void)enet_txframe_reclaim();
+    }
+    enet_poll_irq();
 }
@@ -0,0 +1,1021 @@
+/*!
+    \file    kernel.c
+    \brief   preemptive priority-based micro-kernel on PendSV and SVC
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "kernel.h"
+#include "systick.h"
+#include "section.h"
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+
+/* pattern used to measure stack usage */
+#define KERNEL_STACK_FILL                0xA5A5A5A5U
+/* smallest stack accepted, one full FPU context plus some room */
+#define KERNEL_STACK_MIN_WORDS           64U
+/* BASEPRI value of kernel critical sections */
+#define KERNEL_BASEPRI                   (KERNEL_SYSCALL_PRIORITY << (8U - __NVIC_PRIO_BITS))
+/* thread mode, process stack, basic frame */
+#define KERNEL_EXC_RETURN                0xFFFFFFFDU
+/* Thumb state */
+#define KERNEL_INITIAL_XPSR              0x01000000U
+/* longest mutex ownership chain followed for priority inheritance */
+#define KERNEL_INHERIT_DEPTH             8U
+
+#define KERNEL_TASK_OF(n)                ((kernel_task_struct *)((uint8_t *)(n) - offsetof(kernel_task_struct, node)))
+#define KERNEL_READY_BIT(p)              (0x80000000U >> (p))
+
+/* running task, read by the context switch code */
+kernel_task_struct *volatile kernel_current = NULL;
+/* cycle count written when a context switch returns */
+volatile uint32_t kernel_switch_end;
+
+static kernel_list_struct ready_list[KERNEL_PRIORITIES] __TCM_BSS;
+/* bit 31 - p set while ready_list[p] is not empty, __CLZ gives the highest priority */
+static volatile uint32_t ready_bitmap;
+static kernel_task_struct *task_list = NULL;
+static uint8_t kernel_initialized = 0U;
+static uint8_t kernel_running = 0U;
+static kernel_switch_stat_struct switch_stat = {0U, 0U, 0xFFFFFFFFU, 0U};
+static uint32_t switch_start;
+
+static kernel_task_struct idle_task;
+static uint32_t idle_stack[KERNEL_IDLE_STACK_WORDS] __TCM_STACK;
+static kernel_idle_hook idle_hook = NULL;
+
+/*!
+    \brief    enter a kernel critical section
+    \param[in]  none
+    \param[out] none
+    \retval     previous BASEPRI value
+*/
+static inline uint32_t kernel_lock(void)
+{
+    uint32_t basepri = __get_BASEPRI();
+
+    __set_BASEPRI(KERNEL_BASEPRI);
+    __DSB();
+    __ISB();
+
+    return basepri;
+}
+
+/*!
+    \brief    leave a kernel critical section
+    \param[in]  basepri: value returned by kernel_lock()
+    \param[out] none
+    \retval     none
+*/
+static inline void kernel_unlock(uint32_t basepri)
+{
+    __set_BASEPRI(basepri);
+}
+
+static inline void list_init(kernel_list_struct *list)
+{
+    list->next = list;
+    list->prev = list;
+}
+
+static inline int list_empty(const kernel_list_struct *list)
+{
+    return list->next == list;
+}
+
+static inline void list_insert_before(kernel_list_struct *pos, kernel_list_struct *node)
+{
+    node->next = pos;
+    node->prev = pos->prev;
+    pos->prev->next = node;
+    pos->prev = node;
+}
+
+static inline void list_remove(kernel_list_struct *node)
+{
+    node->prev->next = node->next;
+    node->next->prev = node->prev;
+    node->next = node;
+    node->prev = node;
+}
+
+/*!
+    \brief    initialize the ready lists on first use
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void kernel_init(void)
+{
+    uint32_t i;
+
+    for(i = 0U; i < KERNEL_PRIORITIES; i++) {
+        list_init(&ready_list[i]);
+    }
+    ready_bitmap = 0U;
+    kernel_initialized = 1U;
+}
+
+/*!
+    \brief    append a task to the ready list of its priority
+    \param[in]  task: task not linked into any list
+    \param[out] none
+    \retval     none
+*/
+static void ready_insert(kernel_task_struct *task)
+{
+    list_insert_before(&ready_list[task->priority], &task->node);
+    ready_bitmap |= KERNEL_READY_BIT(task->priority);
+    task->state = KERNEL_TASK_READY;
+}
+
+/*!
+    \brief    remove a task from its ready list
+    \param[in]  task: ready task
+    \param[out] none
+    \retval     none
+*/
+static void ready_remove(kernel_task_struct *task)
+{
+    list_remove(&task->node);
+    if(list_empty(&ready_list[task->priority])) {
+        ready_bitmap &= ~KERNEL_READY_BIT(task->priority);
+    }
+}
+
+/*!
+    \brief    get the first task of the highest non-empty ready list
+    \param[in]  none
+    \param[out] none
+    \retval     highest priority ready task, the idle task keeps the bitmap non-zero
+*/
+static inline kernel_task_struct *ready_highest(void)
+{
+    return KERNEL_TASK_OF(ready_list[__CLZ(ready_bitmap)].next);
+}
+
+/*!
+    \brief    insert a task into a wait list, ordered by priority then arrival
+    \param[in]  list: wait list head
+    \param[in]  task: task not linked into any list
+    \param[out] none
+    \retval     none
+*/
+static void wait_insert(kernel_list_struct *list, kernel_task_struct *task)
+{
+    kernel_list_struct *pos;
+
+    for(pos = list->next; pos != list; pos = pos->next) {
+        if(KERNEL_TASK_OF(pos)->priority > task->priority) {
+            break;
+        }
+    }
+    list_insert_before(pos, &task->node);
+    task->wait_list = list;
+}
+
+/*!
+    \brief    request a context switch if a better task became ready
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void kernel_schedule(void)
+{
+    if(0U == kernel_running) {
+        return;
+    }
+    if((KERNEL_TASK_READY != kernel_current->state) || (__CLZ(ready_bitmap) < kernel_current->priority)) {
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    }
+}
+
+/*!
+    \brief    block the running task until woken or timed out
+    \param[in]  list: wait list, NULL for a plain delay
+    \param[in]  timeout: ticks, KERNEL_WAIT_FOREVER for no timeout
+    \param[in]  basepri: value returned by the caller's kernel_lock()
+    \param[out] none
+    \retval     KERNEL_OK when woken, KERNEL_ERROR_TIMEOUT on timeout
+    \note      called with the kernel locked, returns with it locked again
+*/
+static int kernel_block(kernel_list_struct *list, uint32_t timeout, uint32_t basepri)
+{
+    kernel_task_struct *task = kernel_current;
+
+    ready_remove(task);
+    task->state = KERNEL_TASK_BLOCKED;
+    task->wait_result = KERNEL_OK;
+    task->wait_list = NULL;
+    if(NULL != list) {
+        wait_insert(list, task);
+    }
+    if(KERNEL_WAIT_FOREVER != timeout) {
+        soft_timer_start(&task->timeout, timeout, 0U);
+    }
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+
+    /* PendSV switches away as soon as the lock opens, execution resumes here when woken */
+    kernel_unlock(basepri);
+    __DSB();
+    __ISB();
+    (void)kernel_lock();
+
+    return task->wait_result;
+}
+
+/*!
+    \brief    make a blocked task ready
+    \param[in]  task: blocked task
+    \param[in]  result: value returned from its kernel_block()
+    \param[out] none
+    \retval     none
+*/
+static void kernel_wake(kernel_task_struct *task, int32_t result)
+{
+    if(NULL != task->wait_list) {
+        list_remove(&task->node);
+        task->wait_list = NULL;
+    }
+    soft_timer_stop(&task->timeout);
+    task->wait_result = result;
+    ready_insert(task);
+}
+
+/*!
+    \brief    change the effective priority of a task in whatever list it sits
+    \param[in]  task: task to change
+    \param[in]  priority: new effective priority
+    \param[out] none
+    \retval     none
+*/
+static void task_priority_change(kernel_task_struct *task, uint32_t priority)
+{
+    kernel_list_struct *list;
+
+    if(task->priority == priority) {
+        return;
+    }
+    if(KERNEL_TASK_READY == task->state) {
+        ready_remove(task);
+        task->priority = (uint8_t)priority;
+        ready_insert(task);
+    } else if(NULL != task->wait_list) {
+        list = task->wait_list;
+        list_remove(&task->node);
+        task->priority = (uint8_t)priority;
+        wait_insert(list, task);
+    } else {
+        task->priority = (uint8_t)priority;
+    }
+}
+
+/*!
+    \brief    recompute inherited priorities along a mutex ownership chain
+    \param[in]  task: task whose held mutexes or waiters changed
+    \param[out] none
+    \retval     none
+*/
+static void task_priority_recompute(kernel_task_struct *task)
+{
+    kernel_mutex_struct *mutex;
+    uint32_t priority, depth;
+
+    for(depth = 0U; (NULL != task) && (depth < KERNEL_INHERIT_DEPTH); depth++) {
+        priority = task->base_priority;
+        for(mutex = task->held; NULL != mutex; mutex = mutex->next_held) {
+            if(!list_empty(&mutex->waiters) && (KERNEL_TASK_OF(mutex->waiters.next)->priority < priority)) {
+                priority = KERNEL_TASK_OF(mutex->waiters.next)->priority;
+            }
+        }
+        task_priority_change(task, priority);
+        task = (NULL != task->wait_mutex) ? task->wait_mutex->owner : NULL;
+    }
+}
+
+/*!
+    \brief    remaining wait of a retried blocking call
+    \param[in]  timeout: original timeout
+    \param[in]  deadline: tick at which the original timeout ends
+    \param[out] none
+    \retval     ticks left, KERNEL_WAIT_FOREVER is kept as is
+*/
+static uint32_t wait_remaining(uint32_t timeout, uint64_t deadline)
+{
+    if(KERNEL_WAIT_FOREVER == timeout) {
+        return KERNEL_WAIT_FOREVER;
+    }
+    return systick_deadline_remaining(systick_tick_get(), deadline);
+}
+
+/*!
+    \brief    wait timeout, runs in SysTick_Handler through the timer wheel
+    \param[in]  arg: timed out task
+    \param[out] none
+    \retval     none
+*/
+static void kernel_timeout(void *arg)
+{
+    kernel_task_struct *task = (kernel_task_struct *)arg;
+    kernel_mutex_struct *mutex;
+    uint32_t basepri = kernel_lock();
+
+    if(KERNEL_TASK_BLOCKED == task->state) {
+        mutex = task->wait_mutex;
+        /* a plain delay ends normally, a wait on an object times out */
+        kernel_wake(task, (NULL != task->wait_list) ? KERNEL_ERROR_TIMEOUT : KERNEL_OK);
+        if((NULL != mutex) && (NULL != mutex->owner)) {
+            /* the owner may no longer need the boost this waiter gave it */
+            task_priority_recompute(mutex->owner);
+        }
+        kernel_schedule();
+    }
+    kernel_unlock(basepri);
+}
+
+/*!
+    \brief    catch tasks returning from their entry function
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void kernel_task_exit(void)
+{
+    uint32_t basepri = kernel_lock();
+
+    ready_remove(kernel_current);
+    kernel_current->state = KERNEL_TASK_DEAD;
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    kernel_unlock(basepri);
+
+    while(1) {
+    }
+}
+
+/*!
+    \brief    idle task, runs when no other task is ready
+    \param[in]  arg: unused
+    \param[out] none
+    \retval     none
+*/
+static void kernel_idle(void *arg)
+{
+    while(1) {
+        if(NULL != idle_hook) {
+            idle_hook();
+        } else {
+            __WFI();
+        }
+    }
+}
+
+/*!
+    \brief    select the next task, called from kernel_pendsv with the kernel locked
+    \param[in]  start: cycle count at PendSV entry
+    \param[out] none
+    \retval     none
+*/
+void kernel_switch_context(uint32_t start)
+{
+    kernel_task_struct *next;
+    uint32_t cycles;
+
+    /* account the previous switch, whose end stamp is now known */
+    if(0U != switch_start) {
+        cycles = systick_cycle_elapsed(switch_start, kernel_switch_end);
+        switch_stat.count++;
+        switch_stat.last = cycles;
+        if(cycles < switch_stat.min) {
+            switch_stat.min = cycles;
+        }
+        if(cycles > switch_stat.max) {
+            switch_stat.max = cycles;
+        }
+    }
+    switch_start = start;
+
+    next = ready_highest();
+    if(next != kernel_current) {
+        next->switches++;
+        kernel_current = next;
+    }
+}
+
+/*!
+    \brief    context switch, entered from PendSV_Handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+    \note      only the callee-saved registers are stacked by software, s16-s31 only
+                for tasks that used the FPU, s0-s15 are left to lazy stacking
+*/
+__attribute__((naked)) void kernel_pendsv(void)
+{
+    __ASM volatile(
+        "   ldr     r12, =0xE0001004        \n" /* DWT->CYCCNT at entry */
+        "   ldr     r12, [r12]              \n"
+        "   mrs     r0, psp                 \n"
+        "   isb                             \n"
+        "   ldr     r3, =kernel_current     \n"
+        "   ldr     r2, [r3]                \n"
+        "   tst     lr, #0x10               \n" /* extended frame, task used the FPU */
+        "   it      eq                      \n"
+        "   vstmdbeq r0!, {s16-s31}         \n"
+        "   stmdb   r0!, {r4-r11, lr}       \n"
+        "   str     r0, [r2]                \n"
+        "   mov     r0, %0                  \n"
+        "   msr     basepri, r0             \n"
+        "   dsb                             \n"
+        "   isb                             \n"
+        "   mov     r0, r12                 \n"
+        "   bl      kernel_switch_context   \n"
+        "   mov     r0, #0                  \n"
+        "   msr     basepri, r0             \n"
+        "   ldr     r3, =kernel_current     \n"
+        "   ldr     r1, [r3]                \n"
+        "   ldr     r0, [r1]                \n"
+        "   ldmia   r0!, {r4-r11, lr}       \n"
+        "   tst     lr, #0x10               \n"
+        "   it      eq                      \n"
+        "   vldmiaeq r0!, {s16-s31}         \n"
+        "   msr     psp, r0                 \n"
+        "   isb                             \n"
+        "   ldr     r3, =0xE0001004         \n"
+        "   ldr     r3, [r3]                \n"
+        "   ldr     r2, =kernel_switch_end  \n"
+        "   str     r3, [r2]                \n"
+        "   bx      lr                      \n"
+        "   .ltorg                          \n"
+        :: "i"(KERNEL_BASEPRI)
+    );
+}
+
+/*!
+    \brief    first task start, entered from SVC_Handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((naked)) void kernel_svc(void)
+{
+    __ASM volatile(
+        "   ldr     r3, =kernel_current     \n"
+        "   ldr     r1, [r3]                \n"
+        "   ldr     r0, [r1]                \n"
+        "   ldmia   r0!, {r4-r11, lr}       \n"
+        "   msr     psp, r0                 \n"
+        "   isb                             \n"
+        "   mov     r0, #0                  \n"
+        "   msr     basepri, r0             \n"
+        "   bx      lr                      \n"
+        "   .ltorg                          \n"
+    );
+}
+
+/*!
+    \brief    reset the main stack and enter the first task through SVC
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__attribute__((naked, noreturn)) static void kernel_start_first(void)
+{
+    __ASM volatile(
+        "   ldr     r0, =0xE000ED08         \n" /* SCB->VTOR, main stack top is vector 0 */
+        "   ldr     r0, [r0]                \n"
+        "   ldr     r0, [r0]                \n"
+        "   msr     msp, r0                 \n"
+        "   mov     r0, #0                  \n"
+        "   msr     control, r0             \n" /* clear FPCA, main() may have used the FPU */
+        "   cpsie   i                       \n"
+        "   cpsie   f                       \n"
+        "   dsb                             \n"
+        "   isb                             \n"
+        "   svc     0                       \n"
+        "   nop                             \n"
+        "   .ltorg                          \n"
+    );
+}
+
+/*!
+    \brief    create a task, may be called before or after kernel_start()
+    \param[in]  task: task control block
+    \param[in]  name: name shown in reports
+    \param[in]  entry: task function
+    \param[in]  arg: argument passed to entry
+    \param[in]  priority: 0 (highest) to KERNEL_IDLE_PRIORITY - 1
+    \param[in]  stack: stack memory, 8-byte aligned
+    \param[in]  stack_words: stack size in words
+    \param[out] none
+    \retval     KERNEL_OK or KERNEL_ERROR_PARAM
+*/
+int kernel_task_create(kernel_task_struct *task, const char *name, kernel_task_entry entry, void *arg,
+                       uint32_t priority, uint32_t *stack, uint32_t stack_words)
+{
+    uint32_t *sp;
+    uint32_t basepri, i;
+
+    if((priority >= KERNEL_PRIORITIES) || ((KERNEL_IDLE_PRIORITY == priority) && (task != &idle_task)) ||
+       (stack_words < KERNEL_STACK_MIN_WORDS)) {
+        return KERNEL_ERROR_PARAM;
+    }
+
+    for(i = 0U; i < stack_words; i++) {
+        stack[i] = KERNEL_STACK_FILL;
+    }
+
+    /* initial frame as kernel_pendsv leaves it: r4-r11, EXC_RETURN, then the hardware frame */
+    sp = (uint32_t *)((uint32_t)(stack + stack_words) & ~7U);
+    *(--sp) = KERNEL_INITIAL_XPSR;
+    *(--sp) = (uint32_t)entry & ~1U;
+    *(--sp) = (uint32_t)kernel_task_exit;
+    *(--sp) = 0U;                                                      /* r12 */
+    *(--sp) = 0U;                                                      /* r3 */
+    *(--sp) = 0U;                                                      /* r2 */
+    *(--sp) = 0U;                                                      /* r1 */
+    *(--sp) = (uint32_t)arg;                                           /* r0 */
+    *(--sp) = KERNEL_EXC_RETURN;
+    for(i = 0U; i < 8U; i++) {
+        *(--sp) = 0U;                                                  /* r11-r4 */
+    }
+
+    task->sp = sp;
+    list_init(&task->node);
+    task->wait_list = NULL;
+    task->wait_mutex = NULL;
+    task->held = NULL;
+    soft_timer_init(&task->timeout, kernel_timeout, task, SOFT_TIMER_FLAG_ISR);
+    task->name = name;
+    task->stack = stack;
+    task->stack_words = stack_words;
+    task->switches = 0U;
+    task->wait_result = KERNEL_OK;
+    task->priority = (uint8_t)priority;
+    task->base_priority = (uint8_t)priority;
+
+    basepri = kernel_lock();
+    if(0U == kernel_initialized) {
+        kernel_init();
+    }
+    task->next_task = task_list;
+    task_list = task;
+    ready_insert(task);
+    kernel_schedule();
+    kernel_unlock(basepri);
+
+    return KERNEL_OK;
+}
+
+/*!
+    \brief    start scheduling, does not return
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_start(void)
+{
+    (void)kernel_lock();
+    if(0U == kernel_initialized) {
+        kernel_init();
+    }
+    (void)kernel_task_create(&idle_task, "idle", kernel_idle, NULL, KERNEL_IDLE_PRIORITY,
+                             idle_stack, KERNEL_IDLE_STACK_WORDS);
+
+    /* FP context is stacked lazily, only when a handler actually touches the FPU */
+    FPU->FPCCR |= FPU_FPCCR_ASPEN_Msk | FPU_FPCCR_LSPEN_Msk;
+
+    /* PendSV below everything, the tick at the highest priority allowed to call the kernel */
+    NVIC_SetPriority(PendSV_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+    NVIC_SetPriority(SysTick_IRQn, KERNEL_SYSCALL_PRIORITY);
+
+    kernel_current = ready_highest();
+    kernel_current->switches++;
+    kernel_running = 1U;
+
+    kernel_start_first();
+}
+
+/*!
+    \brief    get the running task
+    \param[in]  none
+    \param[out] none
+    \retval     running task, NULL before kernel_start()
+*/
+kernel_task_struct *kernel_task_self(void)
+{
+    return kernel_current;
+}
+
+/*!
+    \brief    let other ready tasks of the same priority run
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_yield(void)
+{
+    uint32_t basepri = kernel_lock();
+
+    list_remove(&kernel_current->node);
+    list_insert_before(&ready_list[kernel_current->priority], &kernel_current->node);
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    kernel_unlock(basepri);
+}
+
+/*!
+    \brief    block the running task for a number of ticks
+    \param[in]  ticks: delay in ticks, 0 only yields
+    \param[out] none
+    \retval     none
+*/
+void kernel_delay(uint32_t ticks)
+{
+    uint32_t basepri;
+
+    if(0U == ticks) {
+        kernel_yield();
+        return;
+    }
+    basepri = kernel_lock();
+    (void)kernel_block(NULL, ticks, basepri);
+    kernel_unlock(basepri);
+}
+
+/*!
+    \brief    install the idle hook
+    \param[in]  hook: function run repeatedly by the idle task, NULL for a plain WFI
+    \param[out] none
+    \retval     none
+*/
+void kernel_idle_hook_set(kernel_idle_hook hook)
+{
+    idle_hook = hook;
+}
+
+/*!
+    \brief    initialize a semaphore
+    \param[in]  sem: semaphore
+    \param[in]  count: initial units
+    \param[in]  max: upper bound of units
+    \param[out] none
+    \retval     none
+*/
+void kernel_sem_init(kernel_sem_struct *sem, uint32_t count, uint32_t max)
+{
+    sem->count = count;
+    sem->max = max;
+    list_init(&sem->waiters);
+}
+
+/*!
+    \brief    take a semaphore unit
+    \param[in]  sem: semaphore
+    \param[in]  timeout: ticks to wait, KERNEL_NO_WAIT or KERNEL_WAIT_FOREVER
+    \param[out] none
+    \retval     KERNEL_OK or KERNEL_ERROR_TIMEOUT
+*/
+int kernel_sem_take(kernel_sem_struct *sem, uint32_t timeout)
+{
+    uint64_t deadline = systick_deadline_get(systick_tick_get(), timeout);
+    uint32_t basepri = kernel_lock();
+    uint32_t wait = timeout;
+    int result;
+
+    while(0U == sem->count) {
+        if((0U == wait) || (0U != __get_IPSR())) {
+            kernel_unlock(basepri);
+            return KERNEL_ERROR_TIMEOUT;
+        }
+        result = kernel_block(&sem->waiters, wait, basepri);
+        if(KERNEL_OK != result) {
+            kernel_unlock(basepri);
+            return result;
+        }
+        /* another task may have taken the unit first */
+        wait = wait_remaining(timeout, deadline);
+    }
+    sem->count--;
+    kernel_unlock(basepri);
+
+    return KERNEL_OK;
+}
+
+/*!
+    \brief    give a semaphore unit, safe from interrupt context
+    \param[in]  sem: semaphore
+    \param[out] none
+    \retval     KERNEL_OK, or KERNEL_ERROR_PARAM if the semaphore is full
+*/
+int kernel_sem_give(kernel_sem_struct *sem)
+{
+    uint32_t basepri = kernel_lock();
+
+    if(sem->count >= sem->max) {
+        kernel_unlock(basepri);
+        return KERNEL_ERROR_PARAM;
+    }
+    sem->count++;
+    if(!list_empty(&sem->waiters)) {
+        kernel_wake(KERNEL_TASK_OF(sem->waiters.next), KERNEL_OK);
+        kernel_schedule();
+    }
+    kernel_unlock(basepri);
+
+    return KERNEL_OK;
+}
+
+/*!
+    \brief    initialize a mutex
+    \param[in]  mutex: mutex
+    \param[out] none
+    \retval     none
+*/
+void kernel_mutex_init(kernel_mutex_struct *mutex)
+{
+    mutex->owner = NULL;
+    mutex->next_held = NULL;
+    list_init(&mutex->waiters);
+}
+
+/*!
+    \brief    lock a mutex, boosting its owner to the caller's priority while waiting
+    \param[in]  mutex: mutex
+    \param[in]  timeout: ticks to wait, KERNEL_NO_WAIT or KERNEL_WAIT_FOREVER
+    \param[out] none
+    \retval     KERNEL_OK, KERNEL_ERROR_TIMEOUT, or KERNEL_ERROR_PARAM if called from an
+                interrupt or the caller already owns the mutex
+*/
+int kernel_mutex_lock(kernel_mutex_struct *mutex, uint32_t timeout)
+{
+    kernel_task_struct *self = kernel_current;
+    kernel_task_struct *owner;
+    uint32_t basepri, depth;
+    int result;
+
+    if(0U != __get_IPSR()) {
+        return KERNEL_ERROR_PARAM;
+    }
+
+    basepri = kernel_lock();
+    if(NULL == mutex->owner) {
+        mutex->owner = self;
+        mutex->next_held = self->held;
+        self->held = mutex;
+        kernel_unlock(basepri);
+        return KERNEL_OK;
+    }
+    if(mutex->owner == self) {
+        kernel_unlock(basepri);
+        return KERNEL_ERROR_PARAM;
+    }
+    if(KERNEL_NO_WAIT == timeout) {
+        kernel_unlock(basepri);
+        return KERNEL_ERROR_TIMEOUT;
+    }
+
+    /* lend our priority down the ownership chain */
+    owner = mutex->owner;
+    for(depth = 0U; (NULL != owner) && (depth < KERNEL_INHERIT_DEPTH); depth++) {
+        if(self->priority >= owner->priority) {
+            break;
+        }
+        task_priority_change(owner, self->priority);
+        owner = (NULL != owner->wait_mutex) ? owner->wait_mutex->owner : NULL;
+    }
+
+    self->wait_mutex = mutex;
+    /* kernel_mutex_unlock() hands ownership over before waking us */
+    result = kernel_block(&mutex->waiters, timeout, basepri);
+    self->wait_mutex = NULL;
+    kernel_unlock(basepri);
+
+    return result;
+}
+
+/*!
+    \brief    unlock a mutex owned by the caller
+    \param[in]  mutex: mutex
+    \param[out] none
+    \retval     KERNEL_OK, or KERNEL_ERROR_PARAM if the caller is not the owner
+*/
+int kernel_mutex_unlock(kernel_mutex_struct *mutex)
+{
+    kernel_task_struct *self = kernel_current;
+    kernel_task_struct *waiter;
+    kernel_mutex_struct **link;
+    uint32_t basepri = kernel_lock();
+
+    if(mutex->owner != self) {
+        kernel_unlock(basepri);
+        return KERNEL_ERROR_PARAM;
+    }
+
+    for(link = &self->held; NULL != *link; link = &(*link)->next_held) {
+        if(*link == mutex) {
+            *link = mutex->next_held;
+            break;
+        }
+    }
+    mutex->owner = NULL;
+
+    if(!list_empty(&mutex->waiters)) {
+        /* hand over directly to the highest priority waiter */
+        waiter = KERNEL_TASK_OF(mutex->waiters.next);
+        kernel_wake(waiter, KERNEL_OK);
+        waiter->wait_mutex = NULL;
+        mutex->owner = waiter;
+        mutex->next_held = waiter->held;
+        waiter->held = mutex;
+        task_priority_recompute(waiter);
+    }
+    /* drop any priority inherited through this mutex */
+    task_priority_recompute(self);
+    kernel_schedule();
+    kernel_unlock(basepri);
+
+    return KERNEL_OK;
+}
+
+/*!
+    \brief    initialize a message queue
+    \param[in]  queue: message queue
+    \param[in]  buffer: storage of msg_size * msg_count bytes
+    \param[in]  msg_size: bytes per message
+    \param[in]  msg_count: queue capacity
+    \param[out] none
+    \retval     none
+*/
+void kernel_queue_init(kernel_queue_struct *queue, void *buffer, uint32_t msg_size, uint32_t msg_count)
+{
+    queue->buffer = (uint8_t *)buffer;
+    queue->msg_size = msg_size;
+    queue->msg_count = msg_count;
+    queue->head = 0U;
+    queue->used = 0U;
+    list_init(&queue->senders);
+    list_init(&queue->receivers);
+}
+
+/*!
+    \brief    copy a message into a queue, interrupt context must use KERNEL_NO_WAIT
+    \param[in]  queue: message queue
+    \param[in]  msg: message of msg_size bytes
+    \param[in]  timeout: ticks to wait for space, KERNEL_NO_WAIT or KERNEL_WAIT_FOREVER
+    \param[out] none
+    \retval     KERNEL_OK or KERNEL_ERROR_TIMEOUT
+*/
+int kernel_queue_send(kernel_queue_struct *queue, const void *msg, uint32_t timeout)
+{
+    uint64_t deadline = systick_deadline_get(systick_tick_get(), timeout);
+    uint32_t basepri = kernel_lock();
+    uint32_t wait = timeout;
+    int result;
+
+    while(queue->used == queue->msg_count) {
+        if((0U == wait) || (0U != __get_IPSR())) {
+            kernel_unlock(basepri);
+            return KERNEL_ERROR_TIMEOUT;
+        }
+        result = kernel_block(&queue->senders, wait, basepri);
+        if(KERNEL_OK != result) {
+            kernel_unlock(basepri);
+            return result;
+        }
+        wait = wait_remaining(timeout, deadline);
+    }
+
+    memcpy(queue->buffer + queue->head * queue->msg_size, msg, queue->msg_size);
+    queue->head = (queue->head + 1U == queue->msg_count) ? 0U : queue->head + 1U;
+    queue->used++;
+    if(!list_empty(&queue->receivers)) {
+        kernel_wake(KERNEL_TASK_OF(queue->receivers.next), KERNEL_OK);
+        kernel_schedule();
+    }
+    kernel_unlock(basepri);
+
+    return KERNEL_OK;
+}
+
+/*!
+    \brief    copy a message out of a queue
+    \param[in]  queue: message queue
+    \param[in]  timeout: ticks to wait for a message, KERNEL_NO_WAIT or KERNEL_WAIT_FOREVER
+    \param[out] msg: buffer of msg_size bytes
+    \retval     KERNEL_OK or KERNEL_ERROR_TIMEOUT
+*/
+int kernel_queue_receive(kernel_queue_struct *queue, void *msg, uint32_t timeout)
+{
+    uint64_t deadline = systick_deadline_get(systick_tick_get(), timeout);
+    uint32_t basepri = kernel_lock();
+    uint32_t wait = timeout;
+    uint32_t tail;
+    int result;
+
+    while(0U == queue->used) {
+        if((0U == wait) || (0U != __get_IPSR())) {
+            kernel_unlock(basepri);
+            return KERNEL_ERROR_TIMEOUT;
+        }
+        result = kernel_block(&queue->receivers, wait, basepri);
+        if(KERNEL_OK != result) {
+            kernel_unlock(basepri);
+            return result;
+        }
+        wait = wait_remaining(timeout, deadline);
+    }
+
+    tail = (queue->head + queue->msg_count - queue->used) % queue->msg_count;
+    memcpy(msg, queue->buffer + tail * queue->msg_size, queue->msg_size);
+    queue->used--;
+    if(!list_empty(&queue->senders)) {
+        kernel_wake(KERNEL_TASK_OF(queue->senders.next), KERNEL_OK);
+        kernel_schedule();
+    }
+    kernel_unlock(basepri);
+
+    return KERNEL_OK;
+}
+
+/*!
+    \brief    get the context switch timing
+    \param[in]  none
+    \param[out] stat: cycles from PendSV entry to exception return
+    \retval     none
+*/
+void kernel_switch_stat_get(kernel_switch_stat_struct *stat)
+{
+    uint32_t basepri = kernel_lock();
+
+    *stat = switch_stat;
+    kernel_unlock(basepri);
+}
+
+/*!
+    \brief    get the unused stack of a task in words
+    \param[in]  task: task
+    \param[out] none
+    \retval     words never written since the task was created
+*/
+uint32_t kernel_task_stack_free(const kernel_task_struct *task)
+{
+    uint32_t i;
+
+    for(i = 0U; (i < task->stack_words) && (KERNEL_STACK_FILL == task->stack[i]); i++) {
+    }
+
+    return i;
+}
+
+/*!
+    \brief    print context switch and task statistics
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void kernel_stats_print(void)
+{
+    kernel_switch_stat_struct stat;
+    kernel_task_struct *task;
+
+    kernel_switch_stat_get(&stat);
+    printf("\r\ncontext switch: %lu switches, last %lu, min %lu, max %lu cycles",
+           (unsigned long)stat.count, (unsigned long)stat.last,
+           (unsigned long)(stat.count ? stat.min : 0U), (unsigned long)stat.max);
+
+    printf("\r\ntask              prio  base  switches  stack free");
+    for(task = task_list; NULL != task; task = task->next_task) {
+        printf("\r\n%-16s %5u %5u %9lu %7lu/%lu", task->name, task->priority, task->base_priority,
+               (unsigned long)task->switches, (unsigned long)kernel_task_stack_free(task),
+               (unsigned long)task->stack_words);
+    }
+}
@@ -34,32 +34,39 @@ OF SUCH DAMAGE.
 
 #include "gd32f4xx.h"
 #include "systick.h"
+#include "soft_timer.h"
+#include "event.h"
+#include "bench.h"
+#include "boot.h"
+#include "console.h"
+#include "dlog.h"
 #include <stdio.h>
 #include "main.h"
 #include "gd32f450i_eval.h"
 
+static soft_timer_struct led_timer;
+
 /*!
-    \brief    toggle the led every 500ms
-    \param[in]  none
+    \brief    toggle the led, run every 500ms by led_timer
+    \param[in]  arg: unused
     \param[out] none
     \retval     none
 */
-void led_spark(void)
+void led_spark(void *arg)
 {
-    static __IO uint32_t timingdelaylocal = 0U;
-
-    if(timingdelaylocal) {
-
-        if(timingdelaylocal < 500U) {
-            gd_eval_led_on(LED2);
-        } else {
-            gd_eval_led_off(LED2);
-        }
+    gd_eval_led_toggle(LED2);
+}
 
-        timingdelaylocal--;
-    } else {
-        timingdelaylocal = 1000U;
-    }
+/*!
+    \brief    idle hook of the event loop, entered with interrupts masked
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void main_idle(void)
+{
+    /* tickless sleep until the next timer expiry or any interrupt */
+    systick_sleep(soft_timer_idle_ticks());
 }
 
 /*!
@@ -74,38 +81,54 @@ int main(void)
     uint32_t fw_ver = 0;
 #endif
 
+    console_init();
+    dlog_init();
+    boot_time_print();
+
     gd_eval_led_init(LED2);
     gd_eval_led_off(LED2);
     systick_config();
 
+    soft_timer_init(&led_timer, led_spark, NULL, SOFT_TIMER_FLAG_ISR);
+    soft_timer_start(&led_timer, 500U, 500U);
+    event_idle_hook_set(main_idle);
+
 #ifdef __FIRMWARE_VERSION_DEFINE
     fw_ver = gd32f4xx_firmware_version_get();
     /* print firmware version */
     printf("\r\nGD32F4xx series firmware version: V%d.%d.%d", (uint8_t)(fw_ver >> 24), (uint8_t)(fw_ver >> 16), (uint8_t)(fw_ver >> 8));
 #endif /* __FIRMWARE_VERSION_DEFINE */
 
+#ifdef BENCH
+    bench_run();
+#endif /* BENCH */
+
+    /* run-to-completion loop, handlers are fed from interrupts and timers */
     while(1) {
-        /* toggle LEDs */
-        gd_eval_led_toggle(LED2);
-        delay_1ms(500);
+        soft_timer_dispatch();
+        dlog_drain();
+        if(0U == event_dispatch()) {
+            event_idle();
+        }
     }
 }
 
 #ifdef GD_ECLIPSE_GCC
-/* retarget the C library printf function to the USART, in Eclipse GCC environment */
+/* retarget the C library printf function to the console, in Eclipse GCC environment */
 int __io_putchar(int ch)
 {
-    usart_data_transmit(EVAL_COM0, (uint8_t)ch);
-    while(RESET == usart_flag_get(EVAL_COM0, USART_FLAG_TBE));
+    uint8_t c = (uint8_t)ch;
+
+    console_write(&c, 1U);
     return ch;
 }
 #else
-/* retarget the C library printf function to the USART */
+/* retarget the C library printf function to the console */
 int fputc(int ch, FILE *f)
 {
-    usart_data_transmit(EVAL_COM0, (uint8_t)ch);
-    while(RESET == usart_flag_get(EVAL_COM0, USART_FLAG_TBE));
+    uint8_t c = (uint8_t)ch;
 
+    console_write(&c, 1U);
     return ch;
 }
 #endif /* GD_ECLIPSE_GCC */
@@ -0,0 +1,343 @@
+/*!
+    \file    profile.c
+    \brief   DWT cycle counter profiler with nested regions and log2 histograms
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "profile.h"
+#include "section.h"
+#include "serial.h"
+#include <string.h>
+
+/* active region, pushed by profile_begin */
+typedef struct {
+    profile_region_struct *region;
+    uint32_t start;                                                    /*!< cycle count at begin */
+    uint32_t child;                                                    /*!< cycles of nested regions */
+} profile_frame_struct;
+
+static profile_frame_struct profile_stack[PROFILE_MAX_DEPTH] __TCM_BSS;
+static uint32_t profile_depth = 0U;
+/* regions seen so far, for the dump */
+static profile_region_struct *region_list = NULL;
+/* cycles added by one begin/end pair, subtracted from every sample */
+static uint32_t profile_overhead = 0U;
+/* samples lost to a full stack or an unbalanced end */
+static uint32_t profile_errors = 0U;
+
+/*!
+    \brief    enable the DWT cycle counter
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void profile_counter_enable(void)
+{
+    if(0U == (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+}
+
+/*!
+    \brief    link a region into the dump list on first use
+    \param[in]  region: region
+    \param[out] none
+    \retval     none
+    \note      called with interrupts masked
+*/
+static void region_track(profile_region_struct *region)
+{
+    profile_region_struct *item;
+
+    for(item = region_list; NULL != item; item = item->next) {
+        if(item == region) {
+            return;
+        }
+    }
+    region->next = region_list;
+    region_list = region;
+}
+
+/*!
+    \brief    begin a region
+    \param[in]  region: region
+    \param[out] none
+    \retval     none
+*/
+void profile_begin(profile_region_struct *region)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if(profile_depth >= PROFILE_MAX_DEPTH) {
+        profile_errors++;
+        __set_PRIMASK(primask);
+        return;
+    }
+    if(0U == region->count) {
+        region_track(region);
+    }
+    profile_stack[profile_depth].region = region;
+    profile_stack[profile_depth].child = 0U;
+    profile_depth++;
+    /* sample last so the bookkeeping above is not measured */
+    profile_stack[profile_depth - 1U].start = DWT->CYCCNT;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    end the innermost region
+    \param[in]  region: region passed to the matching profile_begin()
+    \param[out] none
+    \retval     none
+*/
+void profile_end(profile_region_struct *region)
+{
+    uint32_t end = DWT->CYCCNT;
+    uint32_t primask = __get_PRIMASK();
+    profile_frame_struct *frame;
+    uint32_t cycles, bucket;
+
+    __disable_irq();
+    if((0U == profile_depth) || (profile_stack[profile_depth - 1U].region != region)) {
+        profile_errors++;
+        __set_PRIMASK(primask);
+        return;
+    }
+    profile_depth--;
+    frame = &profile_stack[profile_depth];
+
+    cycles = end - frame->start;
+    cycles = (cycles > profile_overhead) ? cycles - profile_overhead : 0U;
+
+    region->count++;
+    region->total += cycles;
+    region->self += (cycles > frame->child) ? cycles - frame->child : 0U;
+    if(cycles < region->min) {
+        region->min = cycles;
+    }
+    if(cycles > region->max) {
+        region->max = cycles;
+    }
+    bucket = (0U == cycles) ? 0U : 31U - __CLZ(cycles);
+    region->hist[bucket]++;
+
+    /* the enclosing region, possibly interrupted code, does not own these cycles */
+    if(0U != profile_depth) {
+        profile_stack[profile_depth - 1U].child += cycles + profile_overhead;
+    }
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    measure the begin/end overhead and clear all regions
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void profile_init(void)
+{
+    profile_region_struct calibrate = {"calibrate", NULL, 0U, 0xFFFFFFFFU, 0U, 0U, 0U, {0U}};
+    profile_region_struct **link;
+    uint32_t i, primask, best = 0xFFFFFFFFU;
+
+    profile_counter_enable();
+    profile_overhead = 0U;
+
+    for(i = 0U; i < 8U; i++) {
+        profile_begin(&calibrate);
+        profile_end(&calibrate);
+        if(calibrate.min < best) {
+            best = calibrate.min;
+        }
+    }
+
+    /* calibrate lives on the stack, drop it again wherever regions registered meanwhile put it */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    for(link = &region_list; NULL != *link; link = &(*link)->next) {
+        if(*link == &calibrate) {
+            *link = calibrate.next;
+            break;
+        }
+    }
+    __set_PRIMASK(primask);
+    profile_overhead = best;
+    profile_reset();
+}
+
+/*!
+    \brief    clear the statistics of all regions
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+void profile_reset(void)
+{
+    profile_region_struct *region;
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    for(region = region_list; NULL != region; region = region->next) {
+        region->count = 0U;
+        region->min = 0xFFFFFFFFU;
+        region->max = 0U;
+        region->total = 0U;
+        region->self = 0U;
+        memset(region->hist, 0, sizeof(region->hist));
+    }
+    profile_errors = 0U;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    copy bytes into the dump reservation
+    \param[in]  port: serial port
+    \param[in]  pos: write index inside the reservation, moved past the bytes
+    \param[in]  data: bytes to write
+    \param[in]  len: number of bytes
+    \param[out] sum1, sum2: running Fletcher-16 sums, NULL to only count the size
+    \retval     none
+*/
+static void dump_write(serial_port_enum port, uint32_t *pos, const void *data, uint32_t len,
+                       uint32_t *sum1, uint32_t *sum2)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t i;
+
+    if(NULL == sum1) {
+        *pos += len;
+        return;
+    }
+    for(i = 0U; i < len; i++) {
+        *sum1 = (*sum1 + p[i]) % 255U;
+        *sum2 = (*sum2 + *sum1) % 255U;
+    }
+    *pos = serial_write_put(port, *pos, data, len);
+}
+
+/*!
+    \brief    write the dump body, or only measure it
+    \param[in]  port: serial port
+    \param[in]  pos: write index, moved past the body
+    \param[out] sum1, sum2: running Fletcher-16 sums, NULL to only count the size
+    \retval     none
+*/
+static void dump_body(serial_port_enum port, uint32_t *pos, uint32_t *sum1, uint32_t *sum2)
+{
+    profile_region_struct *region;
+    uint32_t header[4];
+    uint8_t info[4];
+    uint32_t mask, i;
+    uint8_t len;
+
+    info[1] = 0U;
+    for(region = region_list; NULL != region; region = region->next) {
+        info[1]++;
+    }
+    header[0] = PROFILE_DUMP_MAGIC;
+    info[0] = PROFILE_DUMP_VERSION;
+    info[2] = PROFILE_HIST_BUCKETS;
+    info[3] = 0U;
+    dump_write(port, pos, &header[0], 4U, sum1, sum2);
+    dump_write(port, pos, info, 4U, sum1, sum2);
+    header[1] = SystemCoreClock;
+    header[2] = profile_overhead;
+    header[3] = profile_errors;
+    dump_write(port, pos, &header[1], 12U, sum1, sum2);
+
+    for(region = region_list; NULL != region; region = region->next) {
+        len = (uint8_t)strlen(region->name);
+        dump_write(port, pos, &len, 1U, sum1, sum2);
+        dump_write(port, pos, region->name, len, sum1, sum2);
+        dump_write(port, pos, &region->count, 12U, sum1, sum2);
+        dump_write(port, pos, &region->total, 16U, sum1, sum2);
+
+        mask = 0U;
+        for(i = 0U; i < PROFILE_HIST_BUCKETS; i++) {
+            if(0U != region->hist[i]) {
+                mask |= (1UL << i);
+            }
+        }
+        dump_write(port, pos, &mask, 4U, sum1, sum2);
+        for(i = 0U; i < PROFILE_HIST_BUCKETS; i++) {
+            if(0U != region->hist[i]) {
+                dump_write(port, pos, &region->hist[i], 4U, sum1, sum2);
+            }
+        }
+    }
+}
+
+/*!
+    \brief    write all regions as a binary dump to a serial port
+    \param[in]  port: serial port, CONSOLE_PORT for the console on EVAL_COM0
+    \param[out] none
+    \retval     ErrStatus: SUCCESS, or ERROR when the dump does not fit the transmit ring
+    \note      thread mode only. The dump goes out as one reservation of the DMA ring
+                so printf output never lands inside it, all fields little-endian:
+                header  u32 magic, u8 version, u8 regions, u8 buckets, u8 reserved,
+                        u32 core clock, u32 overhead, u32 errors
+                region  u8 name length, name, u32 count, u32 min, u32 max, u64 total,
+                        u64 self, u32 bucket mask, u32 per set bit of the mask
+                trailer u16 Fletcher-16 of everything before it
+*/
+ErrStatus profile_dump(serial_port_enum port)
+{
+    uint32_t primask;
+    uint32_t sum1 = 0U, sum2 = 0U;
+    uint32_t size = 0U, pos;
+    uint16_t check;
+
+    /* wait for the queued output, so the ring has room for the whole dump */
+    serial_flush(port);
+
+    /* masked so the counters, and with them the size, do not change between the passes.
+       Only copies into the ring happen here, the DMA sends the dump afterwards */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    dump_body(port, &size, NULL, NULL);
+    size += sizeof(check);
+    if(SUCCESS != serial_write_begin(port, size, &pos)) {
+        __set_PRIMASK(primask);
+        return ERROR;
+    }
+    dump_body(port, &pos, &sum1, &sum2);
+    check = (uint16_t)((sum2 << 8) | sum1);
+    dump_write(port, &pos, &check, 2U, &sum1, &sum2);
+    __set_PRIMASK(primask);
+
+    serial_write_end(port, size);
+
+    return SUCCESS;
+}
@@ -0,0 +1,200 @@
+/*!
+    \file    ring.c
+    \brief   lock-free multi-producer byte ring
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "ring.h"
+#include <string.h>
+
+/*!
+    \brief    initialize a ring on a power of two sized buffer
+    \param[in]  ring: ring
+    \param[in]  buffer: storage
+    \param[in]  size: storage size in bytes, power of two
+    \param[out] none
+    \retval     none
+*/
+void ring_init(ring_struct *ring, uint8_t *buffer, uint32_t size)
+{
+    ring->buffer = buffer;
+    ring->mask = size - 1U;
+    ring->head = 0U;
+    ring->commit = 0U;
+    ring->tail = 0U;
+    ring->writers = 0U;
+}
+
+/*!
+    \brief    reserve len bytes
+    \param[in]  ring: ring
+    \param[in]  len: bytes to reserve
+    \param[out] pos: write index of the reserved area
+    \retval     0 on success, -1 when the ring lacks space
+    \note      ring_publish() must follow in both cases
+*/
+int ring_reserve(ring_struct *ring, uint32_t len, uint32_t *pos)
+{
+    uint32_t head;
+
+    /* count the writer before taking space, so no publish can pass this reservation */
+    ring_atomic_add(&ring->writers, 1U);
+
+    do {
+        head = __LDREXW(&ring->head);
+        if((ring->mask + 1U) - (head - ring->tail) < len) {
+            __CLREX();
+            return -1;
+        }
+    } while(0U != __STREXW(head + len, &ring->head));
+
+    *pos = head;
+    return 0;
+}
+
+/*!
+    \brief    copy data into a reserved area
+    \param[in]  ring: ring
+    \param[in]  pos: write index from ring_reserve()
+    \param[in]  data: source
+    \param[in]  len: bytes, at most the reserved length
+    \param[out] none
+    \retval     none
+*/
+void ring_put(ring_struct *ring, uint32_t pos, const void *data, uint32_t len)
+{
+    uint32_t offset = pos & ring->mask;
+    uint32_t first = ring->mask + 1U - offset;
+
+    if(first >= len) {
+        memcpy(&ring->buffer[offset], data, len);
+    } else {
+        memcpy(&ring->buffer[offset], data, first);
+        memcpy(ring->buffer, (const uint8_t *)data + first, len - first);
+    }
+}
+
+/*!
+    \brief    close a reservation
+    \param[in]  ring: ring
+    \param[out] none
+    \retval     none
+    \note      the last writer to leave publishes everything reserved so far. An
+                exception between LDREX and STREX clears the monitor, so a writer
+                that reserved meanwhile is seen on the retry
+*/
+void ring_publish(ring_struct *ring)
+{
+    uint32_t writers;
+
+    do {
+        writers = __LDREXW(&ring->writers);
+        if(1U == writers) {
+            ring->commit = ring->head;
+        }
+    } while(0U != __STREXW(writers - 1U, &ring->writers));
+}
+
+/*!
+    \brief    reserve, copy and publish
+    \param[in]  ring: ring
+    \param[in]  data: source
+    \param[in]  len: bytes
+    \param[out] none
+    \retval     len, or 0 when the ring lacks space
+*/
+uint32_t ring_write(ring_struct *ring, const void *data, uint32_t len)
+{
+    uint32_t pos;
+
+    if(0 != ring_reserve(ring, len, &pos)) {
+        ring_publish(ring);
+        return 0U;
+    }
+    ring_put(ring, pos, data, len);
+    ring_publish(ring);
+
+    return len;
+}
+
+/*!
+    \brief    get the contiguous readable block at the tail
+    \param[in]  ring: ring
+    \param[out] data: start of the block
+    \retval     block length, up to the end of the buffer
+*/
+uint32_t ring_peek(ring_struct *ring, uint8_t **data)
+{
+    uint32_t tail = ring->tail;
+    uint32_t len = ring->commit - tail;
+    uint32_t offset = tail & ring->mask;
+
+    if(len > ring->mask + 1U - offset) {
+        len = ring->mask + 1U - offset;
+    }
+    *data = &ring->buffer[offset];
+
+    return len;
+}
+
+/*!
+    \brief    release len bytes at the tail, consumer only
+    \param[in]  ring: ring
+    \param[in]  len: bytes, at most ring_readable()
+    \param[out] none
+    \retval     none
+*/
+void ring_consume(ring_struct *ring, uint32_t len)
+{
+    ring->tail += len;
+}
+
+/*!
+    \brief    bytes published but not consumed
+    \param[in]  ring: ring
+    \param[out] none
+    \retval     byte count
+*/
+uint32_t ring_readable(ring_struct *ring)
+{
+    return ring->commit - ring->tail;
+}
+
+/*!
+    \brief    bytes that can still be reserved
+    \param[in]  ring: ring
+    \param[out] none
+    \retval     byte count
+*/
+uint32_t ring_free(ring_struct *ring)
+{
+    return ring->mask + 1U - (ring->head - ring->tail);
+}
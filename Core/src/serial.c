@@ -0,0 +1,712 @@
+/*!
+    \file    serial.c
+    \brief   multi-port USART/UART driver with DMA transmit rings and DMA reception
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "serial.h"
+#include "ring.h"
+#include <stddef.h>
+#include <string.h>
+
+/* fixed resources of a port */
+typedef struct {
+    uint32_t usart_periph;                                             /*!< USARTx or UARTx */
+    rcu_periph_enum usart_clk;                                         /*!< bus clock of the USART */
+    IRQn_Type usart_irq;                                               /*!< USART interrupt */
+    rcu_clock_freq_enum pclk;                                          /*!< CK_APB1 or CK_APB2 */
+    dma_mgr_request_enum tx_request;                                   /*!< DMA request of USARTx_TX */
+    dma_mgr_request_enum rx_request;                                   /*!< DMA request of USARTx_RX */
+    uint32_t tx_gpio;                                                  /*!< default TX port */
+    uint32_t tx_pin;                                                   /*!< default TX pin */
+    uint32_t rx_gpio;                                                  /*!< default RX port */
+    uint32_t rx_pin;                                                   /*!< default RX pin */
+    uint32_t af;                                                       /*!< alternate function of the default pins */
+} serial_hw_struct;
+
+/* running state of a port */
+typedef struct {
+    ring_struct ring;                                                  /*!< transmit ring */
+    serial_policy_enum policy;                                         /*!< full ring policy */
+    volatile uint32_t open;                                            /*!< port started */
+    volatile uint32_t tx_len;                                          /*!< bytes handed to the running DMA transfer, 0 when idle */
+    uint32_t tx_size;                                                  /*!< ring size, 0 without transmitter */
+    uint32_t rx_on;                                                    /*!< receive engine running */
+    serial_stat_struct stat;                                           /*!< transmit counters */
+    dma_mgr_channel_struct tx_dma;                                     /*!< channel serving USARTx_TX */
+    dma_mgr_channel_struct rx_dma;                                     /*!< channel serving USARTx_RX */
+    usart_rx_struct rx;                                                /*!< receive engine */
+} serial_port_struct;
+
+/* the DMA manager picks the channels, USART0 and USART5 RX have alternatives */
+static const serial_hw_struct serial_hw[SERIAL_PORT_NUM] = {
+    {USART0, RCU_USART0, USART0_IRQn, CK_APB2, DMA_MGR_USART0_TX, DMA_MGR_USART0_RX,
+     GPIOA, GPIO_PIN_9, GPIOA, GPIO_PIN_10, GPIO_AF_7},
+    {USART1, RCU_USART1, USART1_IRQn, CK_APB1, DMA_MGR_USART1_TX, DMA_MGR_USART1_RX,
+     GPIOA, GPIO_PIN_2, GPIOA, GPIO_PIN_3, GPIO_AF_7},
+    {USART2, RCU_USART2, USART2_IRQn, CK_APB1, DMA_MGR_USART2_TX, DMA_MGR_USART2_RX,
+     GPIOB, GPIO_PIN_10, GPIOB, GPIO_PIN_11, GPIO_AF_7},
+    {UART3, RCU_UART3, UART3_IRQn, CK_APB1, DMA_MGR_UART3_TX, DMA_MGR_UART3_RX,
+     GPIOC, GPIO_PIN_10, GPIOC, GPIO_PIN_11, GPIO_AF_8},
+    {UART4, RCU_UART4, UART4_IRQn, CK_APB1, DMA_MGR_UART4_TX, DMA_MGR_UART4_RX,
+     GPIOC, GPIO_PIN_12, GPIOD, GPIO_PIN_2, GPIO_AF_8},
+    {USART5, RCU_USART5, USART5_IRQn, CK_APB2, DMA_MGR_USART5_TX, DMA_MGR_USART5_RX,
+     GPIOC, GPIO_PIN_6, GPIOC, GPIO_PIN_7, GPIO_AF_8},
+    {UART6, RCU_UART6, UART6_IRQn, CK_APB1, DMA_MGR_UART6_TX, DMA_MGR_UART6_RX,
+     GPIOE, GPIO_PIN_8, GPIOE, GPIO_PIN_7, GPIO_AF_8},
+    {UART7, RCU_UART7, UART7_IRQn, CK_APB1, DMA_MGR_UART7_TX, DMA_MGR_UART7_RX,
+     GPIOE, GPIO_PIN_1, GPIOE, GPIO_PIN_0, GPIO_AF_8}
+};
+
+static serial_port_struct serial_port[SERIAL_PORT_NUM];
+
+/*!
+    \brief    GPIO clock of a GPIO port
+    \param[in]  gpio_periph: GPIOx(x=A..I)
+    \param[out] none
+    \retval     RCU_GPIOx
+*/
+static rcu_periph_enum serial_gpio_clock(uint32_t gpio_periph)
+{
+    return (rcu_periph_enum)((uint32_t)RCU_GPIOA + ((gpio_periph - GPIOA) / (GPIOB - GPIOA)));
+}
+
+/*!
+    \brief    configure one pin as push-pull alternate function
+    \param[in]  gpio_periph: GPIOx(x=A..I)
+    \param[in]  pin: GPIO_PIN_x(x=0..15)
+    \param[in]  af: GPIO_AF_x(x=0..15)
+    \param[out] none
+    \retval     none
+*/
+static void serial_pin_config(uint32_t gpio_periph, uint32_t pin, uint32_t af)
+{
+    rcu_periph_clock_enable(serial_gpio_clock(gpio_periph));
+    gpio_af_set(gpio_periph, af, pin);
+    gpio_mode_set(gpio_periph, GPIO_MODE_AF, GPIO_PUPD_PULLUP, pin);
+    gpio_output_options_set(gpio_periph, GPIO_OTYPE_PP, GPIO_OSPEED_50MHZ, pin);
+}
+
+/*!
+    \brief    exact divider for a baud rate
+    \param[in]  pclk: USART clock in Hz
+    \param[in]  baudrate: bits per second
+    \param[out] none
+    \retval     clocks per bit, rounded to nearest, 0 when out of range
+    \note      the divider counts input clocks per bit in both oversampling modes,
+                oversample 16 needs at least 16 and oversample 8 at least 8
+*/
+static uint32_t serial_divider(uint32_t pclk, uint32_t baudrate)
+{
+    uint32_t div;
+
+    if(0U == baudrate) {
+        return 0U;
+    }
+    div = (pclk + (baudrate / 2U)) / baudrate;
+    if((div < 8U) || (div > 0xFFFFU)) {
+        return 0U;
+    }
+    return div;
+}
+
+/*!
+    \brief    start a DMA transfer of the readable block at the tail, if idle
+    \param[in]  port: serial port
+    \param[out] none
+    \retval     none
+*/
+static void serial_kick(serial_port_enum port)
+{
+    serial_port_struct *p = &serial_port[port];
+    const dma_mgr_channel_struct *ch = &p->tx_dma;
+    uint32_t primask = __get_PRIMASK();
+    uint8_t *data;
+    uint32_t len;
+
+    __disable_irq();
+    if((0U != p->open) && (0U == p->tx_len)) {
+        len = ring_peek(&p->ring, &data);
+        if(0U != len) {
+            p->tx_len = len;
+            dma_interrupt_flag_clear(ch->dma_periph, ch->channel, DMA_MGR_FLAGS);
+            dma_memory_address_config(ch->dma_periph, ch->channel, DMA_MEMORY_0, (uint32_t)data);
+            dma_transfer_number_config(ch->dma_periph, ch->channel, len);
+            dma_channel_enable(ch->dma_periph, ch->channel);
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    stop the running transmit DMA transfer, the bytes it moved count as sent
+    \param[in]  port: serial port
+    \param[out] none
+    \retval     none
+    \note      call with interrupts disabled
+*/
+static void serial_tx_abort(serial_port_enum port)
+{
+    serial_port_struct *p = &serial_port[port];
+    const dma_mgr_channel_struct *ch = &p->tx_dma;
+
+    if(0U != p->tx_len) {
+        dma_channel_disable(ch->dma_periph, ch->channel);
+        while(0U != (DMA_CHCTL(ch->dma_periph, ch->channel) & DMA_CHXCTL_CHEN)) {
+        }
+        ring_consume(&p->ring, p->tx_len - dma_transfer_number_get(ch->dma_periph, ch->channel));
+        dma_interrupt_flag_clear(ch->dma_periph, ch->channel, DMA_MGR_FLAGS);
+        p->tx_len = 0U;
+    }
+}
+
+/*!
+    \brief    discard the oldest unsent bytes until len bytes are free
+    \param[in]  port: serial port
+    \param[in]  len: bytes needed
+    \param[out] none
+    \retval     none
+*/
+static void serial_make_room(serial_port_enum port, uint32_t len)
+{
+    serial_port_struct *p = &serial_port[port];
+    uint32_t primask = __get_PRIMASK();
+    uint32_t readable, free, discard;
+
+    __disable_irq();
+    serial_tx_abort(port);
+
+    /* only published bytes can go, open reservations are still being written. The
+       abort already released what the DMA sent, which may be enough on its own */
+    readable = ring_readable(&p->ring);
+    free = ring_free(&p->ring);
+    discard = (free >= len) ? 0U : (len - free);
+    if(discard > readable) {
+        discard = readable;
+    }
+    ring_consume(&p->ring, discard);
+    p->stat.tx_overwritten += discard;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    configure the transmit DMA channel of a port
+    \param[in]  port: serial port
+    \param[out] none
+    \retval     none
+*/
+static void serial_tx_dma_init(serial_port_enum port)
+{
+    const serial_hw_struct *hw = &serial_hw[port];
+    const dma_mgr_channel_struct *ch = &serial_port[port].tx_dma;
+    dma_single_data_parameter_struct dma_init_struct;
+
+    dma_single_data_para_struct_init(&dma_init_struct);
+    dma_init_struct.periph_addr = (uint32_t)&USART_DATA(hw->usart_periph);
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory0_addr = (uint32_t)serial_port[port].ring.buffer;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = DMA_PERIPH_WIDTH_8BIT;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_DISABLE;
+    dma_init_struct.direction = DMA_MEMORY_TO_PERIPH;
+    dma_init_struct.number = 0U;
+    dma_init_struct.priority = DMA_PRIORITY_LOW;
+    dma_single_data_mode_init(ch->dma_periph, ch->channel, &dma_init_struct);
+    dma_interrupt_flag_clear(ch->dma_periph, ch->channel, DMA_MGR_FLAGS);
+    dma_interrupt_enable(ch->dma_periph, ch->channel, DMA_INT_FTF);
+    usart_dma_transmit_config(hw->usart_periph, USART_TRANSMIT_DMA_ENABLE);
+}
+
+/*!
+    \brief    transmit DMA event, the finished block leaves the ring and the next one starts
+    \param[in]  arg: port state
+    \param[in]  flags: DMA_INT_FLAG_x of the channel
+    \param[out] none
+    \retval     none
+*/
+static void serial_tx_dma_event(void *arg, uint32_t flags)
+{
+    serial_port_struct *p = (serial_port_struct *)arg;
+
+    if(0U != (flags & DMA_INT_FLAG_FTF)) {
+        ring_consume(&p->ring, p->tx_len);
+        p->tx_len = 0U;
+        p->stat.tx_transfers++;
+        serial_kick((serial_port_enum)(p - serial_port));
+    }
+}
+
+/*!
+    \brief    receive DMA event, half and full buffer marks
+    \param[in]  arg: receive engine
+    \param[in]  flags: DMA_INT_FLAG_x of the channel
+    \param[out] none
+    \retval     none
+*/
+static void serial_rx_dma_event(void *arg, uint32_t flags)
+{
+    (void)flags;
+    usart_rx_dma_irq((usart_rx_struct *)arg);
+}
+
+/*!
+    \brief    initialize the parameter struct with 115200 8N1 and the default pins of the port
+    \param[in]  port: serial port
+    \param[out] para: parameters, buffers are left NULL
+    \retval     none
+*/
+void serial_struct_para_init(serial_port_enum port, serial_parameter_struct *para)
+{
+    const serial_hw_struct *hw = &serial_hw[port];
+
+    memset(para, 0, sizeof(*para));
+    para->baudrate = 115200U;
+    para->parity = USART_PM_NONE;
+    para->stop_bits = USART_STB_1BIT;
+    para->tx_gpio = hw->tx_gpio;
+    para->tx_pin = hw->tx_pin;
+    para->rx_gpio = hw->rx_gpio;
+    para->rx_pin = hw->rx_pin;
+    para->af = hw->af;
+    para->policy = SERIAL_POLICY_DROP;
+    para->irq_priority = 3U;
+}
+
+/*!
+    \brief    configure the pins, the USART and its DMA channels and start the port
+    \param[in]  port: serial port
+    \param[in]  para: parameters, at least one of tx_buffer and rx_buffer
+    \param[out] none
+    \retval     SUCCESS, or ERROR when the port is open, no free DMA channel serves
+                it, a buffer size is invalid or the baud rate is out of range
+*/
+ErrStatus serial_open(serial_port_enum port, const serial_parameter_struct *para)
+{
+    const serial_hw_struct *hw = &serial_hw[port];
+    serial_port_struct *p = &serial_port[port];
+    usart_rx_parameter_struct rx_para;
+
+    if((port >= SERIAL_PORT_NUM) || (0U != p->open) ||
+       ((NULL == para->tx_buffer) && (NULL == para->rx_buffer))) {
+        return ERROR;
+    }
+    if((NULL != para->tx_buffer) &&
+       ((0U == para->tx_size) || (0U != (para->tx_size & (para->tx_size - 1U))))) {
+        return ERROR;
+    }
+    if((NULL != para->rx_buffer) && ((para->rx_size < 2U) || (0U != (para->rx_size & 1U)))) {
+        return ERROR;
+    }
+    if(0U == serial_divider(rcu_clock_freq_get(hw->pclk), para->baudrate)) {
+        return ERROR;
+    }
+
+    /* claim the DMA channels, USART2 RX and UART6 TX for example share DMA0 channel 1 */
+    p->tx_dma.request = DMA_MGR_REQUEST_NUM;
+    p->rx_dma.request = DMA_MGR_REQUEST_NUM;
+    if((NULL != para->tx_buffer) &&
+       (ERROR == dma_mgr_alloc(hw->tx_request, serial_tx_dma_event, (void *)p, para->irq_priority, &p->tx_dma))) {
+        return ERROR;
+    }
+    if((NULL != para->rx_buffer) &&
+       (ERROR == dma_mgr_alloc(hw->rx_request, serial_rx_dma_event, (void *)&p->rx, para->irq_priority, &p->rx_dma))) {
+        dma_mgr_free(&p->tx_dma);
+        return ERROR;
+    }
+
+    memset(&p->stat, 0, sizeof(p->stat));
+    p->policy = para->policy;
+    p->tx_len = 0U;
+    p->tx_size = (NULL != para->tx_buffer) ? para->tx_size : 0U;
+    p->rx_on = 0U;
+
+    /* pins */
+    if(NULL != para->tx_buffer) {
+        serial_pin_config(para->tx_gpio, para->tx_pin, para->af);
+    }
+    if(NULL != para->rx_buffer) {
+        serial_pin_config(para->rx_gpio, para->rx_pin, para->af);
+    }
+
+    /* USART, a parity bit takes the ninth data bit */
+    rcu_periph_clock_enable(hw->usart_clk);
+    usart_deinit(hw->usart_periph);
+    usart_word_length_set(hw->usart_periph, (USART_PM_NONE == para->parity) ? USART_WL_8BIT : USART_WL_9BIT);
+    usart_parity_config(hw->usart_periph, para->parity);
+    usart_stop_bit_set(hw->usart_periph, para->stop_bits);
+    serial_baudrate_set(port, para->baudrate);
+    if(NULL != para->tx_buffer) {
+        usart_transmit_config(hw->usart_periph, USART_TRANSMIT_ENABLE);
+    }
+    if(NULL != para->rx_buffer) {
+        usart_receive_config(hw->usart_periph, USART_RECEIVE_ENABLE);
+    }
+    usart_enable(hw->usart_periph);
+
+    if(NULL != para->tx_buffer) {
+        ring_init(&p->ring, para->tx_buffer, para->tx_size);
+        serial_tx_dma_init(port);
+    }
+
+    if(NULL != para->rx_buffer) {
+        usart_rx_struct_para_init(&rx_para);
+        rx_para.usart_periph = hw->usart_periph;
+        rx_para.dma_periph = p->rx_dma.dma_periph;
+        rx_para.dma_channel = p->rx_dma.channel;
+        rx_para.dma_subperi = p->rx_dma.subperi;
+        rx_para.buffer = para->rx_buffer;
+        rx_para.size = para->rx_size;
+        rx_para.timeout_bits = para->rx_timeout_bits;
+        rx_para.callback = para->rx_callback;
+        rx_para.arg = para->rx_arg;
+        usart_rx_init(&p->rx, &rx_para);
+        p->rx_on = 1U;
+        nvic_irq_enable(hw->usart_irq, para->irq_priority, 0U);
+    }
+
+    p->open = 1U;
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    stop the port and release its DMA channels
+    \param[in]  port: serial port
+    \param[out] none
+    \retval     none
+    \note      unsent bytes are discarded, call serial_flush() first to keep them
+*/
+void serial_close(serial_port_enum port)
+{
+    const serial_hw_struct *hw = &serial_hw[port];
+    serial_port_struct *p = &serial_port[port];
+    uint32_t primask;
+
+    if((port >= SERIAL_PORT_NUM) || (0U == p->open)) {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(0U != p->tx_size) {
+        serial_tx_abort(port);
+        usart_dma_transmit_config(hw->usart_periph, USART_TRANSMIT_DMA_DISABLE);
+        dma_mgr_free(&p->tx_dma);
+    }
+    if(0U != p->rx_on) {
+        usart_rx_stop(&p->rx);
+        nvic_irq_disable(hw->usart_irq);
+        dma_mgr_free(&p->rx_dma);
+        p->rx_on = 0U;
+    }
+    usart_disable(hw->usart_periph);
+    p->open = 0U;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    program the exact divider, returns the baud rate achieved or 0 when out of range
+    \param[in]  port: serial port
+    \param[in]  baudrate: bits per second
+    \param[out] none
+    \retval     baud rate achieved, 0 when the divider is out of range and nothing changed
+    \note      oversample 16 is used down to 16 clocks per bit, below that oversample 8
+                reaches twice the rate, e.g. 10.5 Mbaud from the 84 MHz APB2 clock.
+                The USART is briefly disabled, do not call while a byte is on the line
+*/
+uint32_t serial_baudrate_set(serial_port_enum port, uint32_t baudrate)
+{
+    const serial_hw_struct *hw = &serial_hw[port];
+    uint32_t usart = hw->usart_periph;
+    uint32_t pclk = rcu_clock_freq_get(hw->pclk);
+    uint32_t div = serial_divider(pclk, baudrate);
+    uint32_t enabled;
+
+    if(0U == div) {
+        return 0U;
+    }
+
+    /* OVSMOD can only change while the USART is disabled */
+    enabled = USART_CTL0(usart) & USART_CTL0_UEN;
+    USART_CTL0(usart) &= ~USART_CTL0_UEN;
+    if(div >= 16U) {
+        usart_oversample_config(usart, USART_OVSMOD_16);
+        USART_BAUD(usart) = div;
+    } else {
+        /* oversample 8: the fraction is 3 bits wide and bit 3 must stay clear */
+        usart_oversample_config(usart, USART_OVSMOD_8);
+        USART_BAUD(usart) = ((div & ~7U) << 1) | (div & 7U);
+    }
+    USART_CTL0(usart) |= enabled;
+
+    return (pclk + (div / 2U)) / div;
+}
+
+/*!
+    \brief    select the full ring policy
+    \param[in]  port: serial port
+    \param[in]  policy: SERIAL_POLICY_DROP, SERIAL_POLICY_BLOCK or SERIAL_POLICY_OVERWRITE
+    \param[out] none
+    \retval     none
+*/
+void serial_policy_set(serial_port_enum port, serial_policy_enum policy)
+{
+    serial_port[port].policy = policy;
+}
+
+/*!
+    \brief    reserve transmit ring space following the port policy
+    \param[in]  port: serial port
+    \param[in]  len: bytes to reserve
+    \param[out] pos: write index for serial_write_put()
+    \retval     SUCCESS, or ERROR when the bytes were dropped
+    \note      on SUCCESS the whole area must be filled with serial_write_put() and
+                closed with serial_write_end(), on ERROR nothing is left open
+*/
+ErrStatus serial_write_begin(serial_port_enum port, uint32_t len, uint32_t *pos)
+{
+    serial_port_struct *p = &serial_port[port];
+    int ret;
+
+    if((0U == p->open) || (0U == p->tx_size)) {
+        return ERROR;
+    }
+    if((0U == len) || (len > p->tx_size)) {
+        ring_atomic_add(&p->stat.tx_dropped, len);
+        return ERROR;
+    }
+
+    ret = ring_reserve(&p->ring, len, pos);
+    if(0 != ret) {
+        ring_publish(&p->ring);
+
+        if(SERIAL_POLICY_OVERWRITE == p->policy) {
+            serial_make_room(port, len);
+            ret = ring_reserve(&p->ring, len, pos);
+            if(0 != ret) {
+                ring_publish(&p->ring);
+            }
+        } else if((SERIAL_POLICY_BLOCK == p->policy) &&
+                  (0U == __get_IPSR()) && (0U == __get_PRIMASK()) && (0U == __get_BASEPRI())) {
+            /* thread mode with interrupts open, the DMA interrupt frees space */
+            ring_atomic_add(&p->stat.tx_blocked, 1U);
+            do {
+                /* nothing left for the DMA: the space is held by the open reservation of a
+                   preempted writer, a task that cannot run while this one waits, so drop */
+                if(0U == ring_readable(&p->ring)) {
+                    break;
+                }
+                serial_kick(port);
+                __WFI();
+                ret = ring_reserve(&p->ring, len, pos);
+                if(0 != ret) {
+                    ring_publish(&p->ring);
+                }
+            } while(0 != ret);
+        }
+
+        if(0 != ret) {
+            ring_atomic_add(&p->stat.tx_dropped, len);
+            return ERROR;
+        }
+    }
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    copy bytes into a reservation from serial_write_begin()
+    \param[in]  port: serial port
+    \param[in]  pos: write index inside the reservation
+    \param[in]  data: source
+    \param[in]  len: bytes
+    \param[out] none
+    \retval     write index following the copied bytes
+*/
+uint32_t serial_write_put(serial_port_enum port, uint32_t pos, const void *data, uint32_t len)
+{
+    ring_put(&serial_port[port].ring, pos, data, len);
+
+    return pos + len;
+}
+
+/*!
+    \brief    publish a reservation and start the DMA
+    \param[in]  port: serial port
+    \param[in]  len: reserved length
+    \param[out] none
+    \retval     none
+*/
+void serial_write_end(serial_port_enum port, uint32_t len)
+{
+    serial_port_struct *p = &serial_port[port];
+    uint32_t used;
+
+    ring_publish(&p->ring);
+    ring_atomic_add(&p->stat.tx_bytes, len);
+
+    used = p->tx_size - ring_free(&p->ring);
+    if(used > p->stat.tx_high_water) {
+        p->stat.tx_high_water = used;
+    }
+    serial_kick(port);
+}
+
+/*!
+    \brief    queue bytes for transmission, callable from any context
+    \param[in]  port: serial port
+    \param[in]  data: bytes
+    \param[in]  len: byte count
+    \param[out] none
+    \retval     bytes accepted, len or 0
+*/
+uint32_t serial_write(serial_port_enum port, const void *data, uint32_t len)
+{
+    uint32_t pos;
+
+    if(SUCCESS != serial_write_begin(port, len, &pos)) {
+        return 0U;
+    }
+    serial_write_put(port, pos, data, len);
+    serial_write_end(port, len);
+
+    return len;
+}
+
+/*!
+    \brief    bytes serial_write() can accept right now
+    \param[in]  port: serial port
+    \param[out] none
+    \retval     free ring space in bytes, 0 without transmitter
+*/
+uint32_t serial_free(serial_port_enum port)
+{
+    if(0U == serial_port[port].tx_size) {
+        return 0U;
+    }
+    return ring_free(&serial_port[port].ring);
+}
+
+/*!
+    \brief    wait until everything queued has left the USART, thread mode only
+    \param[in]  port: serial port
+    \param[out] none
+    \retval     none
+*/
+void serial_flush(serial_port_enum port)
+{
+    serial_port_struct *p = &serial_port[port];
+
+    if((0U == p->open) || (0U == p->tx_size)) {
+        return;
+    }
+    while((0U != ring_readable(&p->ring)) || (0U != p->tx_len)) {
+        serial_kick(port);
+    }
+    while(RESET == usart_flag_get(serial_hw[port].usart_periph, USART_FLAG_TC)) {
+    }
+}
+
+/*!
+    \brief    copy received bytes
+    \param[in]  port: serial port
+    \param[in]  len: room in data
+    \param[out] data: destination
+    \retval     bytes copied, 0 when nothing is waiting
+*/
+uint32_t serial_read(serial_port_enum port, uint8_t *data, uint32_t len)
+{
+    if(0U == serial_port[port].rx_on) {
+        return 0U;
+    }
+    return usart_rx_read(&serial_port[port].rx, data, len);
+}
+
+/*!
+    \brief    bytes waiting for serial_read()
+    \param[in]  port: serial port
+    \param[out] none
+    \retval     byte count
+*/
+uint32_t serial_available(serial_port_enum port)
+{
+    if(0U == serial_port[port].rx_on) {
+        return 0U;
+    }
+    return usart_rx_available(&serial_port[port].rx);
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  port: serial port
+    \param[out] stat: transmit counters and the receive engine counters
+    \retval     none
+*/
+void serial_stat_get(serial_port_enum port, serial_stat_struct *stat)
+{
+    serial_port_struct *p = &serial_port[port];
+    usart_rx_stat_struct rx;
+
+    *stat = p->stat;
+    if(0U != p->rx_on) {
+        usart_rx_stat_get(&p->rx, &rx);
+        stat->rx_bytes = rx.bytes;
+        stat->rx_frames = rx.frames;
+        stat->rx_overruns = rx.overruns;
+        stat->rx_framing_errors = rx.framing_errors;
+        stat->rx_noise_errors = rx.noise_errors;
+        stat->rx_overflows = rx.overflows;
+    }
+}
+
+/*!
+    \brief    peripheral base of the port
+    \param[in]  port: serial port
+    \param[out] none
+    \retval     USARTx or UARTx
+*/
+uint32_t serial_usart_get(serial_port_enum port)
+{
+    return serial_hw[port].usart_periph;
+}
+
+/*!
+    \brief    USART interrupt of the port, called from USARTx_IRQHandler
+    \param[in]  port: serial port
+    \param[out] none
+    \retval     none
+*/
+void serial_usart_irq(serial_port_enum port)
+{
+    if(0U != serial_port[port].rx_on) {
+        usart_rx_usart_irq(&serial_port[port].rx);
+    }
+}
@@ -0,0 +1,398 @@
+/*!
+    \file    soft_timer.c
+    \brief   hierarchical software timer wheel driven by the systick
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "gd32f4xx.h"
+#include "soft_timer.h"
+#include "section.h"
+
+/* internal state bits kept in the upper half of flags */
+#define SOFT_TIMER_STATE_ACTIVE          0x00010000U                   /*!< linked into a wheel slot */
+#define SOFT_TIMER_STATE_PENDING         0x00020000U                   /*!< linked into the deferred list */
+#define SOFT_TIMER_STATE_FIRED           0x00040000U                   /*!< deferred callback is due */
+
+/* wheel slots, every slot is a circular list with a sentinel head */
+static soft_timer_node_struct wheel[SOFT_TIMER_LEVELS][SOFT_TIMER_SLOTS] __TCM_BSS;
+/* next tick the wheel will process */
+static uint64_t wheel_time;
+/* deferred callbacks in expiry order */
+static soft_timer_struct *pending_head;
+static soft_timer_struct *pending_tail;
+static uint8_t wheel_ready = 0U;
+
+/*!
+    \brief    initialize the wheel slots on first use
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void wheel_init(void)
+{
+    uint32_t level, slot;
+
+    for(level = 0U; level < SOFT_TIMER_LEVELS; level++) {
+        for(slot = 0U; slot < SOFT_TIMER_SLOTS; slot++) {
+            wheel[level][slot].next = &wheel[level][slot];
+            wheel[level][slot].prev = &wheel[level][slot];
+        }
+    }
+    wheel_ready = 1U;
+}
+
+/*!
+    \brief    link a timer into the slot matching its expiry
+    \param[in]  timer: timer with a valid expire field
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE static void wheel_insert(soft_timer_struct *timer)
+{
+    uint64_t expire = timer->expire;
+    uint64_t delta;
+    soft_timer_node_struct *head;
+    uint32_t level;
+
+    if(expire < wheel_time) {
+        expire = wheel_time;
+    }
+    delta = expire - wheel_time;
+    if(delta > SOFT_TIMER_MAX_TIMEOUT) {
+        /* park it in the last reachable slot, it is re-cascaded from there */
+        delta = SOFT_TIMER_MAX_TIMEOUT;
+        expire = wheel_time + delta;
+    }
+
+    for(level = 0U; level < SOFT_TIMER_LEVELS - 1U; level++) {
+        if(delta < (1ULL << (SOFT_TIMER_SLOT_BITS * (level + 1U)))) {
+            break;
+        }
+    }
+    head = &wheel[level][(expire >> (SOFT_TIMER_SLOT_BITS * level)) & SOFT_TIMER_SLOT_MASK];
+
+    timer->node.next = head;
+    timer->node.prev = head->prev;
+    head->prev->next = &timer->node;
+    head->prev = &timer->node;
+    timer->flags |= SOFT_TIMER_STATE_ACTIVE;
+}
+
+/*!
+    \brief    unlink a timer from its slot
+    \param[in]  timer: active timer
+    \param[out] none
+    \retval     none
+*/
+static void wheel_remove(soft_timer_struct *timer)
+{
+    timer->node.prev->next = timer->node.next;
+    timer->node.next->prev = timer->node.prev;
+    timer->node.next = &timer->node;
+    timer->node.prev = &timer->node;
+    timer->flags &= ~SOFT_TIMER_STATE_ACTIVE;
+}
+
+/*!
+    \brief    re-insert every timer of an upper level slot into lower levels
+    \param[in]  level: wheel level, 1 or above
+    \param[in]  slot: slot index of the level
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE static void wheel_cascade(uint32_t level, uint32_t slot)
+{
+    soft_timer_node_struct *head = &wheel[level][slot];
+    soft_timer_node_struct *node = head->next;
+    soft_timer_node_struct *next;
+
+    /* detach the whole slot first, timers may land back in it */
+    head->next = head;
+    head->prev = head;
+
+    while(node != head) {
+        next = node->next;
+        wheel_insert((soft_timer_struct *)node);
+        node = next;
+    }
+}
+
+/*!
+    \brief    expire a timer whose slot is due
+    \param[in]  timer: timer already unlinked from the wheel
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE static void timer_expire(soft_timer_struct *timer)
+{
+    if(0U != timer->period) {
+        /* re-arm from the nominal expiry so periodic timers do not drift */
+        timer->expire += timer->period;
+        wheel_insert(timer);
+    }
+
+    if(timer->flags & SOFT_TIMER_FLAG_DEFERRED) {
+        timer->flags |= SOFT_TIMER_STATE_FIRED;
+        if(0U == (timer->flags & SOFT_TIMER_STATE_PENDING)) {
+            timer->flags |= SOFT_TIMER_STATE_PENDING;
+            timer->pending_next = NULL;
+            timer->pending_prev = pending_tail;
+            if(NULL == pending_tail) {
+                pending_head = timer;
+            } else {
+                pending_tail->pending_next = timer;
+            }
+            pending_tail = timer;
+        }
+    } else {
+        timer->callback(timer->arg);
+    }
+}
+
+/*!
+    \brief    unlink a timer from the deferred list in constant time
+    \param[in]  timer: timer with SOFT_TIMER_STATE_PENDING set
+    \param[out] none
+    \retval     none
+*/
+static void pending_remove(soft_timer_struct *timer)
+{
+    if(NULL == timer->pending_prev) {
+        pending_head = timer->pending_next;
+    } else {
+        timer->pending_prev->pending_next = timer->pending_next;
+    }
+    if(NULL == timer->pending_next) {
+        pending_tail = timer->pending_prev;
+    } else {
+        timer->pending_next->pending_prev = timer->pending_prev;
+    }
+    timer->pending_next = NULL;
+    timer->pending_prev = NULL;
+    timer->flags &= ~SOFT_TIMER_STATE_PENDING;
+}
+
+/*!
+    \brief    initialize a timer
+    \param[in]  timer: timer to initialize
+    \param[in]  callback: function called on expiry
+    \param[in]  arg: argument passed to callback
+    \param[in]  flags: callback context
+      \arg        SOFT_TIMER_FLAG_ISR: run the callback in SysTick_Handler
+      \arg        SOFT_TIMER_FLAG_DEFERRED: run the callback from soft_timer_dispatch()
+    \param[out] none
+    \retval     none
+*/
+void soft_timer_init(soft_timer_struct *timer, soft_timer_callback callback, void *arg, uint32_t flags)
+{
+    timer->node.next = &timer->node;
+    timer->node.prev = &timer->node;
+    timer->pending_next = NULL;
+    timer->pending_prev = NULL;
+    timer->expire = 0U;
+    timer->period = 0U;
+    timer->flags = flags & SOFT_TIMER_FLAG_DEFERRED;
+    timer->callback = callback;
+    timer->arg = arg;
+}
+
+/*!
+    \brief    start or restart a timer
+    \param[in]  timer: initialized timer
+    \param[in]  timeout: ticks until the first expiry
+    \param[in]  period: ticks between later expiries, 0 for a one-shot timer
+    \param[out] none
+    \retval     none
+*/
+void soft_timer_start(soft_timer_struct *timer, uint32_t timeout, uint32_t period)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if(0U == wheel_ready) {
+        wheel_init();
+    }
+    if(timer->flags & SOFT_TIMER_STATE_ACTIVE) {
+        wheel_remove(timer);
+    }
+    /* a timeout of 0 expires on the next processed tick */
+    timer->expire = wheel_time + timeout;
+    timer->period = period;
+    timer->flags &= ~SOFT_TIMER_STATE_FIRED;
+    wheel_insert(timer);
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    stop a timer and cancel any deferred callback
+    \param[in]  timer: initialized timer
+    \param[out] none
+    \retval     none
+*/
+void soft_timer_stop(soft_timer_struct *timer)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if(timer->flags & SOFT_TIMER_STATE_ACTIVE) {
+        wheel_remove(timer);
+    }
+    /* unlinked so the storage of a stopped timer can be reused at once */
+    if(timer->flags & SOFT_TIMER_STATE_PENDING) {
+        pending_remove(timer);
+    }
+    timer->flags &= ~SOFT_TIMER_STATE_FIRED;
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    check whether a timer is running
+    \param[in]  timer: initialized timer
+    \param[out] none
+    \retval     1 if the timer is linked into the wheel, 0 otherwise
+*/
+int soft_timer_active(const soft_timer_struct *timer)
+{
+    return (timer->flags & SOFT_TIMER_STATE_ACTIVE) ? 1 : 0;
+}
+
+/*!
+    \brief    advance the wheel to the current tick, called from SysTick_Handler
+    \param[in]  now: current tick from systick_tick_get()
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void soft_timer_process(uint64_t now)
+{
+    soft_timer_node_struct *head;
+    soft_timer_node_struct *node;
+    uint32_t level, slot;
+
+    if(0U == wheel_ready) {
+        wheel_init();
+    }
+
+    /* catches up on ticks skipped by a tickless sleep */
+    while(wheel_time <= now) {
+        slot = (uint32_t)(wheel_time & SOFT_TIMER_SLOT_MASK);
+        if(0U == slot) {
+            /* cascade upper levels as their lower level wraps */
+            for(level = 1U; level < SOFT_TIMER_LEVELS; level++) {
+                slot = (uint32_t)((wheel_time >> (SOFT_TIMER_SLOT_BITS * level)) & SOFT_TIMER_SLOT_MASK);
+                wheel_cascade(level, slot);
+                if(0U != slot) {
+                    break;
+                }
+            }
+            slot = 0U;
+        }
+
+        head = &wheel[0][slot];
+        while(head->next != head) {
+            node = head->next;
+            wheel_remove((soft_timer_struct *)node);
+            timer_expire((soft_timer_struct *)node);
+        }
+        wheel_time++;
+    }
+}
+
+/*!
+    \brief    run deferred callbacks, called from the main loop
+    \param[in]  none
+    \param[out] none
+    \retval     number of callbacks run
+*/
+uint32_t soft_timer_dispatch(void)
+{
+    soft_timer_struct *timer;
+    uint32_t count = 0U;
+    uint32_t fired, primask;
+
+    for(;;) {
+        primask = __get_PRIMASK();
+        __disable_irq();
+        timer = pending_head;
+        /* checked with interrupts masked, soft_timer_stop() may have emptied the list */
+        if(NULL == timer) {
+            __set_PRIMASK(primask);
+            break;
+        }
+        pending_head = timer->pending_next;
+        if(NULL == pending_head) {
+            pending_tail = NULL;
+        } else {
+            pending_head->pending_prev = NULL;
+        }
+        timer->pending_next = NULL;
+        fired = timer->flags & SOFT_TIMER_STATE_FIRED;
+        timer->flags &= ~(SOFT_TIMER_STATE_PENDING | SOFT_TIMER_STATE_FIRED);
+        __set_PRIMASK(primask);
+
+        if(0U != fired) {
+            timer->callback(timer->arg);
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*!
+    \brief    ticks the core may sleep before the wheel has work to do
+    \param[in]  none
+    \param[out] none
+    \retval     0 if deferred callbacks are pending, otherwise the ticks until the next
+                non-empty slot or the next cascade, whichever comes first
+*/
+uint32_t soft_timer_idle_ticks(void)
+{
+    uint32_t i, slot;
+    uint32_t limit;
+
+    if(NULL != pending_head) {
+        return 0U;
+    }
+    if(0U == wheel_ready) {
+        return SOFT_TIMER_SLOTS;
+    }
+
+    /* bounded scan of level 0 up to the next cascade point */
+    slot = (uint32_t)(wheel_time & SOFT_TIMER_SLOT_MASK);
+    limit = SOFT_TIMER_SLOTS - slot;
+    for(i = 0U; i < limit; i++) {
+        if(wheel[0][slot + i].next != &wheel[0][slot + i]) {
+            break;
+        }
+    }
+    /* wheel_time - 1 has been processed, slot i is due i + 1 ticks from now */
+    return i + 1U;
+}
@@ -0,0 +1,338 @@
+/*!
+    \file    stream.c
+    \brief   continuous peripheral to memory streaming on DMA switch-buffer mode
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "stream.h"
+#include "ring.h"
+#include "section.h"
+#include <stddef.h>
+#include <string.h>
+
+/*!
+    \brief    take a free buffer
+    \param[in]  stream: stream
+    \param[out] none
+    \retval     buffer index, STREAM_BUFFERS_MAX when none is free
+*/
+static uint32_t stream_buf_take(stream_struct *stream)
+{
+    uint32_t primask, index = STREAM_BUFFERS_MAX;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(0U != stream->free) {
+        index = (uint32_t)__builtin_ctz(stream->free);
+        stream->free &= ~(1U << index);
+    }
+    __set_PRIMASK(primask);
+
+    return index;
+}
+
+/*!
+    \brief    run a buffer down the chain from a stage on
+    \param[in]  buf: buffer
+    \param[in]  stage: first stage to run, NULL releases the buffer
+    \param[out] none
+    \retval     none
+*/
+static void stream_run(stream_buf_struct *buf, stream_stage_struct *stage)
+{
+    stream_verdict_enum verdict;
+
+    while(NULL != stage) {
+        buf->stage = stage;
+        stage->buffers++;
+        verdict = stage->process(stage->arg, buf);
+        if(STREAM_HOLD == verdict) {
+            return;
+        }
+        if(STREAM_DROP == verdict) {
+            ring_atomic_add(&buf->stream->stat.dropped, 1U);
+            break;
+        }
+        stage = stage->next;
+    }
+    stream_release(buf);
+}
+
+/*!
+    \brief    stop the channel and free the loaded buffers
+    \param[in]  stream: stream
+    \param[in]  keep: loaded buffer not to free, STREAM_BUFFERS_MAX for none
+    \param[out] none
+    \retval     none
+*/
+static void stream_halt(stream_struct *stream, uint32_t keep)
+{
+    uint32_t primask, slot;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if(0U != stream->running) {
+        stream->running = 0U;
+        dma_mgr_free(&stream->dma);
+        for(slot = 0U; slot < 2U; slot++) {
+            if(keep != stream->slot[slot]) {
+                stream->free |= 1U << stream->slot[slot];
+            }
+        }
+    }
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    DMA event: swap a free buffer into the finished slot and deliver the filled one
+    \param[in]  arg: stream
+    \param[in]  flags: DMA_INT_FLAG_x of the channel
+    \param[out] none
+    \retval     none
+    \note      the finished slot is the one the DMA is not using, so the interrupt must
+                run within one buffer period. When no buffer is free the filled one
+                stays loaded and is overwritten, the chain never sees a buffer the DMA
+                is writing
+*/
+static void stream_dma_event(void *arg, uint32_t flags)
+{
+    stream_struct *stream = (stream_struct *)arg;
+    uint32_t dma = stream->dma.dma_periph;
+    dma_channel_enum ch = stream->dma.channel;
+    uint32_t done, index, next, held;
+    stream_buf_struct *buf;
+
+    if(0U != (flags & (DMA_INT_FLAG_FEE | DMA_INT_FLAG_SDE))) {
+        stream->stat.fifo_errors++;
+    }
+    if(0U != (flags & DMA_INT_FLAG_TAE)) {
+        /* the hardware has disabled the channel */
+        stream->stat.errors++;
+        stream_halt(stream, STREAM_BUFFERS_MAX);
+        return;
+    }
+    if((0U == (flags & DMA_INT_FLAG_FTF)) || (0U == stream->running)) {
+        return;
+    }
+
+    done = (DMA_MEMORY_1 == dma_using_memory_get(dma, ch)) ? 0U : 1U;
+    index = stream->slot[done];
+    buf = &stream->buf[index];
+    buf->count = stream->config.items;
+    buf->seq = stream->seq++;
+
+    next = stream_buf_take(stream);
+    if(STREAM_BUFFERS_MAX == next) {
+        stream->stat.overruns++;
+        if(0U == stream->config.stop_on_overrun) {
+            return;
+        }
+        /* the filled buffer is intact, deliver it as the last one */
+        stream_halt(stream, index);
+    } else {
+        dma_memory_address_config(dma, ch, (0U != done) ? DMA_MEMORY_1 : DMA_MEMORY_0, (uint32_t)stream->buf[next].data);
+        stream->slot[done] = next;
+    }
+
+    stream->stat.buffers++;
+    held = stream->config.buffer_num - (uint32_t)__builtin_popcount(stream->free) - 2U * stream->running;
+    if(held > stream->stat.held_max) {
+        stream->stat.held_max = held;
+    }
+    stream_run(buf, stream->stages);
+}
+
+/*!
+    \brief    initialize a stream from its source description
+    \param[in]  stream: stream, stopped
+    \param[in]  config: source description, copied
+    \param[out] none
+    \retval     SUCCESS, or ERROR on a bad buffer count, size or placement
+*/
+ErrStatus stream_init(stream_struct *stream, const stream_config_struct *config)
+{
+    uint32_t i;
+
+    if((config->buffer_num < 2U) || (config->buffer_num > STREAM_BUFFERS_MAX) ||
+       (0U == config->items) || (config->items > 0xFFFFU)) {
+        return ERROR;
+    }
+    for(i = 0U; i < config->buffer_num; i++) {
+        if((NULL == config->buffers[i]) || SECTION_IN_TCM(config->buffers[i])) {
+            return ERROR;
+        }
+    }
+
+    memset(stream, 0, sizeof(*stream));
+    stream->config = *config;
+    stream->dma.request = DMA_MGR_REQUEST_NUM;
+    for(i = 0U; i < config->buffer_num; i++) {
+        stream->buf[i].stream = stream;
+        stream->buf[i].data = config->buffers[i];
+    }
+    stream->free = (1U << config->buffer_num) - 1U;
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    append a stage to the chain
+    \param[in]  stream: stream, stopped
+    \param[in]  stage: stage descriptor, kept by the stream
+    \param[in]  process: processing function
+    \param[in]  arg: process argument
+    \param[out] none
+    \retval     none
+*/
+void stream_stage_add(stream_struct *stream, stream_stage_struct *stage, stream_process process, void *arg)
+{
+    stream_stage_struct **link = &stream->stages;
+
+    stage->next = NULL;
+    stage->process = process;
+    stage->arg = arg;
+    stage->buffers = 0U;
+    while(NULL != *link) {
+        link = &(*link)->next;
+    }
+    *link = stage;
+}
+
+/*!
+    \brief    take the DMA channel and start filling
+    \param[in]  stream: stream
+    \param[out] none
+    \retval     SUCCESS, or ERROR when running, fewer than two buffers are free or no channel serves the request
+    \note      the caller enables the DMA request of the peripheral afterwards, e.g.
+                adc_dma_mode_enable() or spi_dma_enable(). Items arrive in circular
+                switch-buffer mode so the source is never stalled between buffers
+*/
+ErrStatus stream_start(stream_struct *stream)
+{
+    dma_single_data_parameter_struct dma_init_struct;
+    const stream_config_struct *config = &stream->config;
+    uint32_t first, second;
+
+    if(0U != stream->running) {
+        return ERROR;
+    }
+    first = stream_buf_take(stream);
+    second = stream_buf_take(stream);
+    if((STREAM_BUFFERS_MAX == first) || (STREAM_BUFFERS_MAX == second)) {
+        if(STREAM_BUFFERS_MAX != first) {
+            stream_release(&stream->buf[first]);
+        }
+        return ERROR;
+    }
+    if(SUCCESS != dma_mgr_alloc(config->request, stream_dma_event, stream, config->irq_priority, &stream->dma)) {
+        stream_release(&stream->buf[first]);
+        stream_release(&stream->buf[second]);
+        return ERROR;
+    }
+
+    stream->slot[0] = first;
+    stream->slot[1] = second;
+    dma_single_data_para_struct_init(&dma_init_struct);
+    dma_init_struct.periph_addr = config->periph_addr;
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory0_addr = (uint32_t)stream->buf[first].data;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = config->periph_width;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_ENABLE;
+    dma_init_struct.direction = DMA_PERIPH_TO_MEMORY;
+    dma_init_struct.number = config->items;
+    dma_init_struct.priority = config->priority;
+    dma_single_data_mode_init(stream->dma.dma_periph, stream->dma.channel, &dma_init_struct);
+    dma_switch_buffer_mode_config(stream->dma.dma_periph, stream->dma.channel, (uint32_t)stream->buf[second].data, DMA_MEMORY_0);
+    dma_switch_buffer_mode_enable(stream->dma.dma_periph, stream->dma.channel, ENABLE);
+    dma_interrupt_flag_clear(stream->dma.dma_periph, stream->dma.channel, DMA_MGR_FLAGS);
+    dma_interrupt_enable(stream->dma.dma_periph, stream->dma.channel, DMA_INT_FTF | DMA_INT_TAE | DMA_INT_SDE);
+    stream->running = 1U;
+    dma_channel_enable(stream->dma.dma_periph, stream->dma.channel);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    stop filling and give the channel back
+    \param[in]  stream: stream
+    \param[out] none
+    \retval     none
+    \note      the partly filled buffers are discarded, buffers held by stages stay
+                theirs until released. Disable the peripheral DMA request first
+*/
+void stream_stop(stream_struct *stream)
+{
+    stream_halt(stream, STREAM_BUFFERS_MAX);
+}
+
+/*!
+    \brief    pass a held buffer on to the stage after the holder
+    \param[in]  buf: buffer a stage returned STREAM_HOLD for
+    \param[out] none
+    \retval     none
+    \note      the remaining stages run in the caller's context, typically a work
+                item submitted by the holding stage with event_work_submit()
+*/
+void stream_forward(stream_buf_struct *buf)
+{
+    stream_run(buf, buf->stage->next);
+}
+
+/*!
+    \brief    give a held buffer back to the stream
+    \param[in]  buf: buffer a stage returned STREAM_HOLD for
+    \param[out] none
+    \retval     none
+    \note      safe from any context, the buffer is refilled once the DMA gets to it
+*/
+void stream_release(stream_buf_struct *buf)
+{
+    stream_struct *stream = buf->stream;
+    uint32_t primask;
+
+    buf->stage = NULL;
+    primask = __get_PRIMASK();
+    __disable_irq();
+    stream->free |= 1U << (uint32_t)(buf - stream->buf);
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  stream: stream
+    \param[out] stat: copy of the counters
+    \retval     none
+*/
+void stream_stat_get(const stream_struct *stream, stream_stat_struct *stat)
+{
+    *stat = stream->stat;
+}
@@ -34,8 +34,12 @@ OF SUCH DAMAGE.
 
 #include "gd32f4xx.h"
 #include "systick.h"
+#include "section.h"
 
-volatile static uint32_t delay;
+/* number of SysTick cycles in one tick */
+static uint32_t systick_reload;
+/* ticks elapsed since systick_config() */
+static volatile uint64_t systick_ticks;
 
 /*!
     \brief    configure systick
@@ -45,14 +49,179 @@ volatile static uint32_t delay;
 */
 void systick_config(void)
 {
+    systick_reload = SystemCoreClock / SYSTICK_TICK_HZ;
+
     /* setup systick timer for 1000Hz interrupts */
-    if(SysTick_Config(SystemCoreClock / 1000U)) {
+    if(SysTick_Config(systick_reload)) {
         /* capture error */
         while(1) {
         }
     }
     /* configure the systick handler priority */
     NVIC_SetPriority(SysTick_IRQn, 0x00U);
+
+    /* enable the DWT cycle counter for sub-tick timestamps */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/*!
+    \brief    advance the tick counter, called from SysTick_Handler
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+__FASTCODE void systick_tick_increment(void)
+{
+    systick_ticks++;
+}
+
+/*!
+    \brief    get the 64-bit monotonic tick counter
+    \param[in]  none
+    \param[out] none
+    \retval     ticks elapsed since systick_config()
+*/
+uint64_t systick_tick_get(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint64_t ticks;
+
+    __disable_irq();
+    ticks = systick_ticks;
+    __set_PRIMASK(primask);
+
+    return ticks;
+}
+
+/*!
+    \brief    get a monotonic timestamp in microseconds
+    \param[in]  none
+    \param[out] none
+    \retval     microseconds elapsed since systick_config()
+*/
+uint64_t systick_us_get(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint64_t ticks;
+    uint32_t val;
+
+    __disable_irq();
+    ticks = systick_ticks;
+    val = SysTick->VAL;
+    /* the counter wrapped after the last tick interrupt was taken */
+    if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        val = SysTick->VAL;
+        ticks++;
+    }
+    __set_PRIMASK(primask);
+
+    /* VAL counts down to the next tick boundary, even after a tickless sleep */
+    return ticks * (1000000U / SYSTICK_TICK_HZ) +
+           (systick_reload - 1U - val) / (SystemCoreClock / 1000000U);
+}
+
+/*!
+    \brief    get the DWT cycle counter
+    \param[in]  none
+    \param[out] none
+    \retval     free running core cycle count, wraps every 2^32 cycles
+*/
+uint32_t systick_cycle_get(void)
+{
+    return DWT->CYCCNT;
+}
+
+/*!
+    \brief    sleep for up to ticks with the periodic tick suppressed
+    \param[in]  ticks: number of ticks with no pending work, 0 returns at once
+    \param[out] none
+    \retval     none
+    \note      may be called with interrupts masked so that work queued between
+                computing ticks and sleeping still wakes the core
+*/
+void systick_sleep(uint32_t ticks)
+{
+    uint32_t max_ticks = (SysTick_LOAD_RELOAD_Msk / systick_reload) - 1U;
+    uint32_t primask, ctrl, val, load, remaining, elapsed;
+
+    if(0U == ticks) {
+        return;
+    }
+    if(1U == ticks) {
+        /* the next tick interrupt wakes the core anyway */
+        __WFI();
+        return;
+    }
+    if(ticks > max_ticks) {
+        ticks = max_ticks;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    val = SysTick->VAL;
+    if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) {
+        /* a tick is due right now, let it be serviced first */
+        SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+        __set_PRIMASK(primask);
+        return;
+    }
+
+    /* program the counter to expire on the boundary of the last tick */
+    load = val + (ticks - 1U) * systick_reload;
+    SysTick->LOAD = load;
+    SysTick->VAL = 0U;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    /* reading CTRL clears COUNTFLAG, keep the copy of the one read that stops the counter */
+    ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+    if(ctrl & SysTick_CTRL_COUNTFLAG_Msk) {
+        /* the deadline was reached, the pending SysTick_Handler accounts for the last tick */
+        elapsed = ticks - 1U;
+        remaining = systick_reload - 1U - ((load - SysTick->VAL) % systick_reload);
+    } else {
+        /* woken early by another interrupt */
+        val = SysTick->VAL;
+        elapsed = ticks - 1U - (val / systick_reload);
+        remaining = val % systick_reload;
+    }
+    systick_ticks += elapsed;
+    if(0U == remaining) {
+        /* a zero reload never fires, round up to the next cycle */
+        remaining = 1U;
+    }
+
+    /* resume the periodic tick in phase with the original tick boundaries */
+    SysTick->LOAD = remaining;
+    SysTick->VAL = 0U;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD = systick_reload - 1U;
+
+    __set_PRIMASK(primask);
+}
+
+/*!
+    \brief    sleep until the deadline tick is reached
+    \param[in]  deadline: absolute tick value
+    \param[out] none
+    \retval     none
+*/
+void systick_sleep_until(uint64_t deadline)
+{
+    uint64_t now = systick_tick_get();
+
+    while(!systick_deadline_reached(now, deadline)) {
+        systick_sleep(systick_deadline_remaining(now, deadline));
+        now = systick_tick_get();
+    }
 }
 
 /*!
@@ -63,21 +232,25 @@ void systick_config(void)
 */
 void delay_1ms(uint32_t count)
 {
-    delay = count;
+    uint64_t deadline = systick_deadline_get(systick_tick_get(), count * (SYSTICK_TICK_HZ / 1000U));
 
-    while(0U != delay) {
+    /* sleep between ticks instead of spinning, the tick interrupt keeps running */
+    while(!systick_deadline_reached(systick_tick_get(), deadline)) {
+        __WFI();
     }
 }
 
 /*!
-    \brief    delay decrement
-    \param[in]  none
+    \brief    busy wait a time in microseconds on the cycle counter
+    \param[in]  count: count in microseconds
     \param[out] none
     \retval     none
 */
-void delay_decrement(void)
+void delay_1us(uint32_t count)
 {
-    if(0U != delay) {
-        delay--;
+    uint32_t start = DWT->CYCCNT;
+    uint32_t cycles = count * (SystemCoreClock / 1000000U);
+
+    while(systick_cycle_elapsed(start, DWT->CYCCNT) < cycles) {
     }
 }
@@ -0,0 +1,355 @@
+/*!
+    \file    usart_rx.c
+    \brief   circular DMA USART receive engine with IDLE and receiver timeout frame detection
+
+    \version 2024-12-20, V3.3.1, firmware for GD32F4xx
+*/
+
+/*
+    Copyright (c) 2024, GigaDevice Semiconductor Inc.
+
+    Redistribution and use in source and binary forms, with or without modification,
+are permitted provided that the following conditions are met:
+
+    1. Redistributions of source code must retain the above copyright notice, this
+       list of conditions and the following disclaimer.
+    2. Redistributions in binary form must reproduce the above copyright notice,
+       this list of conditions and the following disclaimer in the documentation
+       and/or other materials provided with the distribution.
+    3. Neither the name of the copyright holder nor the names of its contributors
+       may be used to endorse or promote products derived from this software without
+       specific prior written permission.
+
+    THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY
+OF SUCH DAMAGE.
+*/
+
+#include "usart_rx.h"
+#include <stddef.h>
+#include <string.h>
+
+#define USART_RX_DMA_FLAGS               (DMA_INT_FLAG_FEE | DMA_INT_FLAG_SDE | DMA_INT_FLAG_TAE | \
+                                          DMA_INT_FLAG_HTF | DMA_INT_FLAG_FTF)
+
+/*!
+    \brief    check whether the peripheral has a receiver timeout unit
+    \param[in]  usart_periph: USARTx or UARTx
+    \param[out] none
+    \retval     1 for USART0/1/2/5, 0 for UART3/4/6/7
+*/
+static uint32_t usart_rx_has_timeout(uint32_t usart_periph)
+{
+    return ((USART0 == usart_periph) || (USART1 == usart_periph) ||
+            (USART2 == usart_periph) || (USART5 == usart_periph)) ? 1U : 0U;
+}
+
+/*!
+    \brief    current DMA write index
+    \param[in]  rx: receive engine
+    \param[out] none
+    \retval     buffer index the next byte goes to
+*/
+static uint32_t usart_rx_dma_pos(usart_rx_struct *rx)
+{
+    uint32_t pos = rx->para.size - dma_transfer_number_get(rx->para.dma_periph, rx->para.dma_channel);
+
+    return (pos >= rx->para.size) ? 0U : pos;
+}
+
+/*!
+    \brief    account for newly received bytes and detect DMA overflow
+    \param[in]  rx: receive engine
+    \param[out] none
+    \retval     bytes waiting between tail and the DMA write index
+    \note      runs at least every half buffer thanks to the half and full transfer
+                interrupts, so the DMA cannot have moved more than one buffer length
+*/
+static uint32_t usart_rx_update(usart_rx_struct *rx)
+{
+    uint32_t size = rx->para.size;
+    uint32_t pos = usart_rx_dma_pos(rx);
+    uint32_t before = (rx->last_pos + size - rx->tail) % size;
+    uint32_t arrived = (pos + size - rx->last_pos) % size;
+
+    rx->last_pos = pos;
+    rx->stat.bytes += arrived;
+    if(before + arrived >= size) {
+        /* the DMA passed the tail, the oldest bytes are gone */
+        rx->stat.overflows++;
+        rx->tail = pos;
+        return 0U;
+    }
+
+    return before + arrived;
+}
+
+/*!
+    \brief    hand waiting bytes to the callback
+    \param[in]  rx: receive engine
+    \param[in]  end_of_frame: 1 when the line went idle
+    \param[out] none
+    \retval     none
+*/
+static void usart_rx_deliver(usart_rx_struct *rx, uint32_t end_of_frame)
+{
+    uint32_t pending = usart_rx_update(rx);
+    uint32_t tail = rx->tail;
+    uint32_t first;
+
+    if((NULL == rx->para.callback) || (0U == pending)) {
+        return;
+    }
+    /* a long frame is passed on in pieces before the DMA comes round again */
+    if((0U == end_of_frame) && (pending < rx->para.size / 2U)) {
+        return;
+    }
+
+    first = rx->para.size - tail;
+    if(first >= pending) {
+        rx->para.callback(rx->para.arg, &rx->para.buffer[tail], pending, NULL, 0U,
+                          end_of_frame ? 0U : USART_RX_FRAME_PARTIAL);
+    } else {
+        rx->para.callback(rx->para.arg, &rx->para.buffer[tail], first, rx->para.buffer, pending - first,
+                          end_of_frame ? 0U : USART_RX_FRAME_PARTIAL);
+    }
+    rx->tail = (tail + pending) % rx->para.size;
+    if(0U != end_of_frame) {
+        rx->stat.frames++;
+    }
+}
+
+/*!
+    \brief    initialize the parameter struct with default values
+    \param[in]  para: parameter struct
+    \param[out] none
+    \retval     none
+*/
+void usart_rx_struct_para_init(usart_rx_parameter_struct *para)
+{
+    para->usart_periph = USART0;
+    para->dma_periph = DMA1;
+    para->dma_channel = DMA_CH5;
+    para->dma_subperi = DMA_SUBPERI4;
+    para->buffer = NULL;
+    para->size = 0U;
+    para->timeout_bits = 0U;
+    para->callback = NULL;
+    para->arg = NULL;
+}
+
+/*!
+    \brief    start circular DMA reception on an already configured USART
+    \param[in]  rx: receive engine
+    \param[in]  para: parameters, buffer and size are required
+    \param[out] none
+    \retval     none
+    \note      the USART interrupt and the DMA channel interrupt must be routed to
+                usart_rx_usart_irq() and usart_rx_dma_irq() and enabled in the NVIC,
+                the channel is best taken with dma_mgr_alloc() so no other driver uses it
+*/
+void usart_rx_init(usart_rx_struct *rx, const usart_rx_parameter_struct *para)
+{
+    dma_single_data_parameter_struct dma_init_struct;
+    uint32_t usart = para->usart_periph;
+
+    rx->para = *para;
+    rx->tail = 0U;
+    rx->last_pos = 0U;
+    memset(&rx->stat, 0, sizeof(rx->stat));
+
+    rcu_periph_clock_enable((DMA0 == para->dma_periph) ? RCU_DMA0 : RCU_DMA1);
+    dma_deinit(para->dma_periph, para->dma_channel);
+    dma_single_data_para_struct_init(&dma_init_struct);
+    dma_init_struct.periph_addr = (uint32_t)&USART_DATA(usart);
+    dma_init_struct.periph_inc = DMA_PERIPH_INCREASE_DISABLE;
+    dma_init_struct.memory0_addr = (uint32_t)para->buffer;
+    dma_init_struct.memory_inc = DMA_MEMORY_INCREASE_ENABLE;
+    dma_init_struct.periph_memory_width = DMA_PERIPH_WIDTH_8BIT;
+    dma_init_struct.circular_mode = DMA_CIRCULAR_MODE_ENABLE;
+    dma_init_struct.direction = DMA_PERIPH_TO_MEMORY;
+    dma_init_struct.number = para->size;
+    dma_init_struct.priority = DMA_PRIORITY_HIGH;
+    dma_single_data_mode_init(para->dma_periph, para->dma_channel, &dma_init_struct);
+    dma_channel_subperipheral_select(para->dma_periph, para->dma_channel, para->dma_subperi);
+    dma_interrupt_flag_clear(para->dma_periph, para->dma_channel, USART_RX_DMA_FLAGS);
+    dma_interrupt_enable(para->dma_periph, para->dma_channel, DMA_INT_HTF | DMA_INT_FTF);
+    dma_channel_enable(para->dma_periph, para->dma_channel);
+
+    /* clear stale IDLE and error flags: read STAT0 then DATA */
+    (void)USART_STAT0(usart);
+    (void)USART_DATA(usart);
+
+    usart_dma_receive_config(usart, USART_RECEIVE_DMA_ENABLE);
+    usart_interrupt_enable(usart, USART_INT_ERR);
+    if((0U != para->timeout_bits) && (0U != usart_rx_has_timeout(usart))) {
+        usart_receiver_timeout_threshold_config(usart, para->timeout_bits);
+        usart_interrupt_flag_clear(usart, USART_INT_FLAG_RT);
+        usart_receiver_timeout_enable(usart);
+        usart_interrupt_enable(usart, USART_INT_RT);
+    } else {
+        usart_interrupt_enable(usart, USART_INT_IDLE);
+    }
+}
+
+/*!
+    \brief    stop reception
+    \param[in]  rx: receive engine
+    \param[out] none
+    \retval     none
+*/
+void usart_rx_stop(usart_rx_struct *rx)
+{
+    uint32_t usart = rx->para.usart_periph;
+
+    usart_interrupt_disable(usart, USART_INT_IDLE);
+    usart_interrupt_disable(usart, USART_INT_ERR);
+    if(0U != usart_rx_has_timeout(usart)) {
+        usart_interrupt_disable(usart, USART_INT_RT);
+        usart_receiver_timeout_disable(usart);
+    }
+    usart_dma_receive_config(usart, USART_RECEIVE_DMA_DISABLE);
+    dma_channel_disable(rx->para.dma_periph, rx->para.dma_channel);
+    dma_interrupt_disable(rx->para.dma_periph, rx->para.dma_channel, DMA_INT_HTF | DMA_INT_FTF);
+}
+
+/*!
+    \brief    USART interrupt: IDLE, receiver timeout and error flags
+    \param[in]  rx: receive engine
+    \param[out] none
+    \retval     none
+*/
+void usart_rx_usart_irq(usart_rx_struct *rx)
+{
+    uint32_t usart = rx->para.usart_periph;
+    uint32_t stat = USART_STAT0(usart);
+    uint32_t end_of_frame = 0U;
+
+    if(0U != (stat & (USART_STAT0_IDLEF | USART_STAT0_ORERR | USART_STAT0_NERR | USART_STAT0_FERR))) {
+        /* these flags clear by reading STAT0 then DATA, the DMA has already taken the byte */
+        (void)USART_DATA(usart);
+        if(0U != (stat & USART_STAT0_ORERR)) {
+            rx->stat.overruns++;
+        }
+        if(0U != (stat & USART_STAT0_NERR)) {
+            rx->stat.noise_errors++;
+        }
+        if(0U != (stat & USART_STAT0_FERR)) {
+            rx->stat.framing_errors++;
+        }
+        if((0U != (stat & USART_STAT0_IDLEF)) && (0U != (USART_CTL0(usart) & USART_CTL0_IDLEIE))) {
+            end_of_frame = 1U;
+        }
+    }
+    if((0U != usart_rx_has_timeout(usart)) &&
+            (SET == usart_interrupt_flag_get(usart, USART_INT_FLAG_RT))) {
+        usart_interrupt_flag_clear(usart, USART_INT_FLAG_RT);
+        end_of_frame = 1U;
+    }
+
+    if(0U != end_of_frame) {
+        usart_rx_deliver(rx, 1U);
+    }
+}
+
+/*!
+    \brief    DMA half and full transfer interrupt
+    \param[in]  rx: receive engine
+    \param[out] none
+    \retval     none
+*/
+void usart_rx_dma_irq(usart_rx_struct *rx)
+{
+    uint32_t dma = rx->para.dma_periph;
+    dma_channel_enum channel = rx->para.dma_channel;
+
+    if(SET == dma_interrupt_flag_get(dma, channel, DMA_INT_FLAG_HTF)) {
+        dma_interrupt_flag_clear(dma, channel, DMA_INT_FLAG_HTF);
+    }
+    if(SET == dma_interrupt_flag_get(dma, channel, DMA_INT_FLAG_FTF)) {
+        dma_interrupt_flag_clear(dma, channel, DMA_INT_FLAG_FTF);
+    }
+    usart_rx_deliver(rx, 0U);
+}
+
+/*!
+    \brief    bytes waiting in stream mode
+    \param[in]  rx: receive engine
+    \param[out] none
+    \retval     byte count
+*/
+uint32_t usart_rx_available(usart_rx_struct *rx)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t pending;
+
+    __disable_irq();
+    pending = usart_rx_update(rx);
+    __set_PRIMASK(primask);
+
+    return pending;
+}
+
+/*!
+    \brief    copy received bytes out in stream mode
+    \param[in]  rx: receive engine without callback
+    \param[in]  len: room in data
+    \param[out] data: destination
+    \retval     bytes copied, 0 when nothing is waiting or an overflow hit the copy
+*/
+uint32_t usart_rx_read(usart_rx_struct *rx, uint8_t *data, uint32_t len)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t pending, tail, first, overflows;
+
+    /* the interrupts move the tail on overflow, take it together with the count */
+    __disable_irq();
+    pending = usart_rx_update(rx);
+    tail = rx->tail;
+    overflows = rx->stat.overflows;
+    __set_PRIMASK(primask);
+
+    if(len > pending) {
+        len = pending;
+    }
+    if(0U == len) {
+        return 0U;
+    }
+    first = rx->para.size - tail;
+    if(first >= len) {
+        memcpy(data, &rx->para.buffer[tail], len);
+    } else {
+        memcpy(data, &rx->para.buffer[tail], first);
+        memcpy(&data[first], rx->para.buffer, len - first);
+    }
+
+    /* the DMA passing the old tail during the copy overwrote some of it, drop the copy */
+    __disable_irq();
+    (void)usart_rx_update(rx);
+    if(overflows != rx->stat.overflows) {
+        len = 0U;
+    } else {
+        rx->tail = (tail + len) % rx->para.size;
+    }
+    __set_PRIMASK(primask);
+
+    return len;
+}
+
+/*!
+    \brief    read the counters
+    \param[in]  rx: receive engine
+    \param[out] stat: copy of the counters
+    \retval     none
+*/
+void usart_rx_stat_get(usart_rx_struct *rx, usart_rx_stat_struct *stat)
+{
+    *stat = rx->stat;
+}
@@ -21,6 +21,8 @@ extern int errno;
 
 extern int __io_putchar(int ch) __attribute__((weak));
 extern int __io_getchar(void) __attribute__((weak));
+extern int __io_write(char *ptr, int len) __attribute__((weak));
+extern int __io_read(char *ptr, int len) __attribute__((weak));
 
 caddr_t _sbrk(int incr)
 {
@@ -74,6 +76,10 @@ int _write(int file, char *ptr, int len)
 {
 	int DataIdx;
 
+	/* bulk output when the application provides it, otherwise one call per character */
+	if (__io_write)
+		return __io_write(ptr, len);
+
 		for (DataIdx = 0; DataIdx < len; DataIdx++)
 		{
 		   __io_putchar( *ptr++ );
@@ -106,6 +112,10 @@ int _read(int file, char *ptr, int len)
 {
 	int DataIdx;
 
+	/* bulk input when the application provides it, otherwise one call per character */
+	if (__io_read)
+		return __io_read(ptr, len);
+
 	for (DataIdx = 0; DataIdx < len; DataIdx++)
 	{
 	  *ptr++ = __io_getchar();
@@ -59,6 +59,17 @@ OF SUCH DAMAGE.
 #define ENET_TXBUF_SIZE                  ENET_MAX_FRAME_SIZE                    /*!< ethernet transmit buffer size */
 #endif
 
+#ifndef ENET_RX_LOAN_RESERVE
+#define ENET_RX_LOAN_RESERVE             2U                                     /*!< ethernet Rx DMA descriptors never loaned to the application, frames may span several */
+#endif
+
+/* memory of a descriptor ring in enet_descriptors_region_init(), num descriptors with bufsize byte buffers */
+#define ENET_DESC_REGION_SIZE(num, bufsize)  ((num) * (ETH_DMARXDESC_SIZE + (bufsize)))
+
+#ifndef ENET_TX_INFLIGHT_NUM
+#define ENET_TX_INFLIGHT_NUM             8U                                     /*!< ethernet zero-copy Tx frames waiting to be reclaimed */
+#endif
+
 //#define SELECT_DESCRIPTORS_ENHANCED_MODE 
 
 //#define USE_DELAY
@@ -1010,6 +1021,42 @@ typedef struct
     uint32_t sign;                                                                  /*!< sign of system time */
 }enet_ptp_systime_struct;
 
+/* structure of received frame loaned to the application */
+typedef struct
+{
+    enet_descriptors_struct *desc;                                                  /*!< first descriptor holding the frame, owned by CPU while loaned */
+    uint8_t *buffer;                                                                /*!< frame data in the DMA receive buffer, the first piece only when desc_count > 1 */
+    uint32_t length;                                                                /*!< frame length */
+    uint32_t desc_count;                                                            /*!< number of descriptors holding the frame */
+}enet_rxframe_struct;
+
+/* structure of one piece of a received frame, held by one descriptor */
+typedef struct
+{
+    uint8_t *buffer;                                                                /*!< data in the DMA receive buffer */
+    uint32_t length;                                                                /*!< data length */
+}enet_rxseg_struct;
+
+/* structure of one piece of a zero-copy transmit frame */
+typedef struct
+{
+    const uint8_t *buffer;                                                          /*!< data, used by the DMA until the frame is reclaimed */
+    uint32_t length;                                                                /*!< data length, 0 pieces are skipped */
+}enet_txseg_struct;
+
+/* zero-copy transmit frame reclaim callback, status is ERROR if the frame was not sent correctly */
+typedef void (*enet_txframe_callback)(void *arg, ErrStatus status);
+
+/* structure of zero-copy transmit frame waiting to be reclaimed */
+typedef struct
+{
+    enet_descriptors_struct *first;                                                 /*!< first descriptor of the frame */
+    enet_descriptors_struct *last;                                                  /*!< last descriptor of the frame */
+    uint32_t desc_num;                                                              /*!< number of descriptors of the frame */
+    enet_txframe_callback callback;                                                 /*!< reclaim callback, NULL for none */
+    void *arg;                                                                      /*!< callback argument */
+}enet_txframe_struct;
+
 /* mac_cfg register value */
 #define MAC_CFG_BOL(regval)                       (BITS(5,6) & ((uint32_t)(regval) << 5))       /*!< write value to ENET_MAC_CFG_BOL bit field */
 #define ENET_BACKOFFLIMIT_10                      MAC_CFG_BOL(0)                                /*!< min (n, 10) */
@@ -1472,6 +1519,8 @@ uint32_t enet_rxframe_size_get(void);
 void enet_descriptors_chain_init(enet_dmadirection_enum direction);
 /* initialize the dma tx/rx descriptors's parameters in ring mode */
 void enet_descriptors_ring_init(enet_dmadirection_enum direction);
+/* initialize the dma tx/rx descriptors in ring mode inside a caller provided memory region */
+uint32_t enet_descriptors_region_init(enet_dmadirection_enum direction, void *region, uint32_t size, uint32_t bufsize);
 /* handle current received frame data to application buffer */
 ErrStatus enet_frame_receive(uint8_t *buffer, uint32_t bufsize);
 /* handle current received frame but without data copy to application buffer */
@@ -1480,6 +1529,22 @@ ErrStatus enet_frame_receive(uint8_t *buffer, uint32_t bufsize);
 ErrStatus enet_frame_transmit(uint8_t *buffer, uint32_t length);
 /* handle current transmit frame but without data copy from application buffer */
 #define ENET_NOCOPY_FRAME_TRANSMIT(len)     enet_frame_transmit(NULL, (len))
+/* loan the current received frame to the application without copying it */
+ErrStatus enet_rxframe_loan(enet_rxframe_struct *frame);
+/* give a loaned frame's descriptor back to the DMA with its buffer */
+void enet_rxframe_return(enet_rxframe_struct *frame);
+/* get the pieces of a loaned frame, one per descriptor */
+uint32_t enet_rxframe_segments_get(const enet_rxframe_struct *frame, enet_rxseg_struct seg[], uint32_t num);
+/* give a loaned frame's descriptor back to the DMA with a fresh buffer, the application keeps the frame buffer */
+ErrStatus enet_rxframe_swap(enet_rxframe_struct *frame, uint8_t *buffer);
+/* get the number of Rx descriptors loaned to the application */
+uint32_t enet_rxframe_loaned_get(void);
+/* get the number of frames enet_rxframe_loan() dropped as too long to loan */
+uint32_t enet_rxframe_loan_dropped_get(void);
+/* transmit a frame gathered from application buffers without copying it */
+ErrStatus enet_frame_transmit_segments(const enet_txseg_struct seg[], uint32_t num, enet_txframe_callback callback, void *arg);
+/* reclaim the zero-copy frames the DMA has finished with */
+uint32_t enet_txframe_reclaim(void);
 /* configure the transmit IP frame checksum offload calculation and insertion */
 void enet_transmit_checksum_config(enet_descriptors_struct *desc, uint32_t checksum);
 /* ENET Tx and Rx function enable (include MAC and DMA module) */
@@ -1581,6 +1646,8 @@ void enet_desc_flag_clear(enet_descriptors_struct *desc, uint32_t desc_flag);
 void enet_rx_desc_immediate_receive_complete_interrupt(enet_descriptors_struct *desc);
 /* when receiving the completed, set RS bit in ENET_DMA_STAT register will is set after a configurable delay time */
 void enet_rx_desc_delay_receive_complete_interrupt(enet_descriptors_struct *desc, uint32_t delay_time);
+/* configure the receive interrupt coalescing of all descriptors in the Rx ring */
+void enet_rx_coalesce_config(uint32_t delay_time);
 /* drop current receive frame */
 void enet_rxframe_drop(void);
 /* enable DMA feature */
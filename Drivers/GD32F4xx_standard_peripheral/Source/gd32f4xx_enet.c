@@ -33,6 +33,11 @@ OF SUCH DAMAGE.
 
 #include "gd32f4xx_enet.h"
 
+/* TCMRAM, 64KB at 0x10000000, is not connected to the ENET DMA, the main stack lives there */
+#define ENET_TCM_BASE                             0x10000000U
+#define ENET_TCM_SIZE                             0x00010000U
+#define ENET_IN_TCM(addr)                         ((uint32_t)((uint32_t)(addr) - ENET_TCM_BASE) < ENET_TCM_SIZE)
+
 #if defined   (__CC_ARM)                                    /*!< ARM compiler */
 __align(4)
 enet_descriptors_struct  rxdesc_tab[ENET_RXBUF_NUM];        /*!< ENET RxDMA descriptor */
@@ -71,7 +76,23 @@ enet_descriptors_struct  *dma_current_ptp_rxdesc = NULL;
 
 /* init structure parameters for ENET initialization */
 static enet_initpara_struct enet_initpara = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-static uint32_t enet_unknow_err = 0U;
+/* number of descriptors in the Rx and Tx descriptor rings */
+static uint32_t enet_rxdesc_num = ENET_RXBUF_NUM;
+static uint32_t enet_txdesc_num = ENET_TXBUF_NUM;
+/* Tx buffers of the Tx descriptors in table order, buffer1 is restored from them after a zero-copy frame */
+static uint8_t *enet_txbuf = &tx_buff[0][0];
+static uint32_t enet_txbuf_size = ENET_TXBUF_SIZE;
+/* number of Rx descriptors loaned to the application */
+static uint32_t enet_rx_loaned = 0U;
+/* first descriptor of the oldest loaned frame, the RxDMA and the scan stop there while
+   enet_rx_loaned is not 0 */
+static enet_descriptors_struct *enet_rx_loan_first = NULL;
+/* frames dropped by enet_rxframe_loan() because they span more descriptors than can ever be loaned */
+static uint32_t enet_rx_loan_dropped = 0U;
+/* zero-copy Tx frames waiting to be reclaimed, oldest at enet_tx_inflight_head */
+static enet_txframe_struct enet_tx_inflight[ENET_TX_INFLIGHT_NUM];
+static uint32_t enet_tx_inflight_head = 0U;
+static uint32_t enet_tx_inflight_num = 0U;
 /* array of register offset for debug information get */
 static const uint16_t enet_reg_tab[] = {
     0x0000, 0x0004, 0x0008, 0x000C, 0x0010, 0x0014, 0x0018, 0x001C, 0x0028, 0x002C, 0x0034,
@@ -87,6 +108,22 @@ static const uint16_t enet_reg_tab[] = {
 
 /* initialize ENET peripheral with generally concerned parameters, call it by enet_init() */
 static void enet_default_init(void);
+/* get the length of a received frame from its last descriptor status */
+static uint32_t enet_rxframe_length(uint32_t status);
+/* get the descriptor following desc in the Rx descriptor chain or ring */
+static enet_descriptors_struct *enet_rxdesc_next(enet_descriptors_struct *desc);
+/* find the descriptors of the current received frame */
+static enet_descriptors_struct *enet_rxframe_scan(uint32_t *count);
+/* give the descriptors of the current received frame back to the DMA */
+static void enet_rxframe_drop_desc(uint32_t count);
+/* resume the RxDMA if it stopped on a descriptor owned by CPU */
+static void enet_rxdma_resume(void);
+/* get the descriptor following desc in the Tx descriptor chain or ring */
+static enet_descriptors_struct *enet_txdesc_next(enet_descriptors_struct *desc);
+/* check that a Tx descriptor can take a new frame */
+static ErrStatus enet_txdesc_free(enet_descriptors_struct *desc);
+/* resume the TxDMA if it stopped or underflowed */
+static void enet_txdma_resume(void);
 #ifdef USE_DELAY
 /* user can provide more timing precise _ENET_DELAY_ function */
 #define _ENET_DELAY_                              delay_ms
@@ -654,32 +691,32 @@ ErrStatus enet_software_reset(void)
 */
 uint32_t enet_rxframe_size_get(void)
 {
-    uint32_t size = 0U;
+    uint32_t size = 0U, count = 0U;
     uint32_t status;
+    enet_descriptors_struct *last;
 
-    /* get rdes0 information of current RxDMA descriptor */
-    status = dma_current_rxdesc->status;
+    /* find the descriptors of the frame, the last one holds the frame status */
+    last = enet_rxframe_scan(&count);
 
-    /* if the desciptor is owned by DMA */
-    if((uint32_t)RESET != (status & ENET_RDES0_DAV)) {
+    /* if the frame is not completely received yet */
+    if(NULL == last) {
         return 0U;
     }
+    status = last->status;
 
-    /* if has any error, or the frame uses two or more descriptors */
-    if((((uint32_t)RESET) != (status & ENET_RDES0_ERRS)) ||
-            (((uint32_t)RESET) == (status & ENET_RDES0_LDES)) ||
-            (((uint32_t)RESET) == (status & ENET_RDES0_FDES))) {
+    /* if has any error */
+    if(((uint32_t)RESET) != (status & ENET_RDES0_ERRS)) {
         /* drop current receive frame */
-        enet_rxframe_drop();
+        enet_rxframe_drop_desc(count);
 
         return 1U;
     }
 #ifdef SELECT_DESCRIPTORS_ENHANCED_MODE
     /* if is an ethernet-type frame, and IP frame payload error occurred */
-    if(((uint32_t)RESET) != (dma_current_rxdesc->status & ENET_RDES0_FRMT) &&
-            ((uint32_t)RESET) != (dma_current_rxdesc->extended_status & ENET_RDES4_IPPLDERR)) {
+    if(((uint32_t)RESET) != (status & ENET_RDES0_FRMT) &&
+            ((uint32_t)RESET) != (last->extended_status & ENET_RDES4_IPPLDERR)) {
         /* drop current receive frame */
-        enet_rxframe_drop();
+        enet_rxframe_drop_desc(count);
 
         return 1U;
     }
@@ -688,31 +725,13 @@ uint32_t enet_rxframe_size_get(void)
     if((((uint32_t)RESET) != (status & ENET_RDES0_FRMT)) &&
             (((uint32_t)RESET) != (status & ENET_RDES0_PCERR))) {
         /* drop current receive frame */
-        enet_rxframe_drop();
+        enet_rxframe_drop_desc(count);
 
         return 1U;
     }
 #endif
-    /* if CPU owns current descriptor, no error occured, the frame uses only one descriptor */
-    if((((uint32_t)RESET) == (status & ENET_RDES0_DAV)) &&
-            (((uint32_t)RESET) == (status & ENET_RDES0_ERRS)) &&
-            (((uint32_t)RESET) != (status & ENET_RDES0_LDES)) &&
-            (((uint32_t)RESET) != (status & ENET_RDES0_FDES))) {
-        /* get the size of the received data including CRC */
-        size = GET_RDES0_FRML(status);
-        /* substract the CRC size */
-        size = size - 4U;
-
-        /* if is a type frame, and CRC is not included in forwarding frame */
-        if((RESET != (ENET_MAC_CFG & ENET_MAC_CFG_TFCD)) && (RESET != (status & ENET_RDES0_FRMT))) {
-            size = size + 4U;
-        }
-    } else {
-        enet_unknow_err++;
-        enet_rxframe_drop();
-
-        return 1U;
-    }
+    /* get the size of the received data except CRC */
+    size = enet_rxframe_length(status);
 
     /* return packet size */
     return size;
@@ -748,6 +767,11 @@ void enet_descriptors_chain_init(enet_dmadirection_enum direction)
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR = (uint32_t)desc_tab;
         dma_current_txdesc = desc_tab;
+        enet_txdesc_num = ENET_TXBUF_NUM;
+        enet_txbuf = &tx_buff[0][0];
+        enet_txbuf_size = ENET_TXBUF_SIZE;
+        enet_tx_inflight_head = 0U;
+        enet_tx_inflight_num = 0U;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
@@ -764,6 +788,8 @@ void enet_descriptors_chain_init(enet_dmadirection_enum direction)
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR = (uint32_t)desc_tab;
         dma_current_rxdesc = desc_tab;
+        enet_rxdesc_num = ENET_RXBUF_NUM;
+        enet_rx_loaned = 0U;
     }
     dma_current_ptp_rxdesc = NULL;
     dma_current_ptp_txdesc = NULL;
@@ -822,6 +848,11 @@ void enet_descriptors_ring_init(enet_dmadirection_enum direction)
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR = (uint32_t)desc_tab;
         dma_current_txdesc = desc_tab;
+        enet_txdesc_num = ENET_TXBUF_NUM;
+        enet_txbuf = &tx_buff[0][0];
+        enet_txbuf_size = ENET_TXBUF_SIZE;
+        enet_tx_inflight_head = 0U;
+        enet_tx_inflight_num = 0U;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
@@ -838,6 +869,8 @@ void enet_descriptors_ring_init(enet_dmadirection_enum direction)
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR = (uint32_t)desc_tab;
         dma_current_rxdesc = desc_tab;
+        enet_rxdesc_num = ENET_RXBUF_NUM;
+        enet_rx_loaned = 0U;
     }
     dma_current_ptp_rxdesc = NULL;
     dma_current_ptp_txdesc = NULL;
@@ -865,46 +898,144 @@ void enet_descriptors_ring_init(enet_dmadirection_enum direction)
     }
 }
 
+/*!
+    \brief    initialize the DMA Tx/Rx descriptors in ring mode inside a caller provided memory region
+    \param[in]  direction: the descriptors which users want to init, refer to enet_dmadirection_enum
+                only one parameter can be selected which is shown as below
+      \arg        ENET_DMA_TX: DMA Tx descriptors
+      \arg        ENET_DMA_RX: DMA Rx descriptors
+    \param[in]  region: word aligned SRAM for the descriptors followed by their buffers, e.g. marked __ENET_RAM
+    \param[in]  size: region size in bytes, ENET_DESC_REGION_SIZE() gives the size for a ring
+    \param[in]  bufsize: buffer size of each descriptor, a multiple of 4 up to 8188,
+                0 for Tx descriptors only used by enet_frame_transmit_segments()
+    \param[out] none
+    \retval     number of descriptors in the ring, 0 if the region cannot hold two, or for
+                Rx, if the descriptors past ENET_RX_LOAN_RESERVE cannot hold a whole frame
+    \note      replaces enet_descriptors_chain_init() and enet_descriptors_ring_init() so the
+                ring depth and the buffer size are chosen at run time. Call it while the
+                DMA direction is stopped. Not for the PTP descriptor modes
+*/
+uint32_t enet_descriptors_region_init(enet_dmadirection_enum direction, void *region, uint32_t size, uint32_t bufsize)
+{
+    uint32_t num = 0U, count = 0U;
+    enet_descriptors_struct *desc, *desc_tab;
+    uint8_t *buf;
+
+    if((0U != ((uint32_t)region & 3U)) || (0U != (bufsize & 3U)) || (bufsize > ENET_RDES1_RB1S) ||
+            ((ENET_DMA_RX == direction) && (0U == bufsize))) {
+        return 0U;
+    }
+    /* the descriptors first, then one buffer per descriptor */
+    count = size / (ETH_DMARXDESC_SIZE + bufsize);
+    if(count < 2U) {
+        return 0U;
+    }
+    /* enet_rxframe_loan() must be able to hand out a frame of the largest size */
+    if((ENET_DMA_RX == direction) &&
+            ((count <= ENET_RX_LOAN_RESERVE) || (((count - ENET_RX_LOAN_RESERVE) * bufsize) < ENET_MAX_FRAME_SIZE))) {
+        return 0U;
+    }
+    desc_tab = (enet_descriptors_struct *)region;
+    buf = (uint8_t *)region + (count * ETH_DMARXDESC_SIZE);
+
+    /* configure descriptor skip length */
+    ENET_DMA_BCTL &= ~ENET_DMA_BCTL_DPSL;
+    ENET_DMA_BCTL |= DMA_BCTL_DPSL(0);
+
+    /* configure each descriptor */
+    for(num = 0U; num < count; num++) {
+        desc = desc_tab + num;
+        desc->buffer1_addr = (0U != bufsize) ? (uint32_t)(&buf[num * bufsize]) : 0U;
+        desc->buffer2_next_desc_addr = 0U;
+        if(ENET_DMA_TX == direction) {
+            desc->status = 0U;
+            desc->control_buffer_size = 0U;
+            /* configure transmit end of ring mode on the last descriptor */
+            if(num == (count - 1U)) {
+                desc->status |= ENET_TDES0_TERM;
+            }
+        } else {
+            /* enable receiving and set buffer1 size */
+            desc->status = ENET_RDES0_DAV;
+            desc->control_buffer_size = bufsize;
+            /* configure receive end of ring mode on the last descriptor */
+            if(num == (count - 1U)) {
+                desc->control_buffer_size |= ENET_RDES1_RERM;
+            }
+        }
+    }
+
+    if(ENET_DMA_TX == direction) {
+        /* configure DMA Tx descriptor table address register */
+        ENET_DMA_TDTADDR = (uint32_t)desc_tab;
+        dma_current_txdesc = desc_tab;
+        enet_txdesc_num = count;
+        enet_txbuf = buf;
+        enet_txbuf_size = bufsize;
+        enet_tx_inflight_head = 0U;
+        enet_tx_inflight_num = 0U;
+    } else {
+        /* configure DMA Rx descriptor table address register */
+        ENET_DMA_RDTADDR = (uint32_t)desc_tab;
+        dma_current_rxdesc = desc_tab;
+        enet_rxdesc_num = count;
+        enet_rx_loaned = 0U;
+    }
+    dma_current_ptp_rxdesc = NULL;
+    dma_current_ptp_txdesc = NULL;
+
+    return count;
+}
+
 /*!
     \brief    handle current received frame data to application buffer
     \param[in]  bufsize: the size of buffer which is the parameter in function
     \param[out] buffer: pointer to the received frame data
                 note -- if the input is NULL, user should copy data in application by himself
     \retval     ErrStatus: SUCCESS or ERROR
+    \note      a frame over several descriptors is gathered from all of them, so ENET_RXBUF_SIZE
+                may be smaller than ENET_MAX_FRAME_SIZE. ERROR until the frame is completely received
 */
 ErrStatus enet_frame_receive(uint8_t *buffer, uint32_t bufsize)
 {
-    uint32_t offset = 0U, size = 0U;
+    uint32_t offset = 0U, size = 0U, count = 0U, num = 0U, piece = 0U, index = 0U;
+    enet_descriptors_struct *desc, *last;
 
     /* the descriptor is busy due to own by the DMA */
     if((uint32_t)RESET != (dma_current_rxdesc->status & ENET_RDES0_DAV)) {
         return ERROR;
     }
 
+    /* find the descriptors of the frame, the frame may still be arriving in the later ones */
+    last = enet_rxframe_scan(&count);
+    if(NULL == last) {
+        return ERROR;
+    }
 
     /* if buffer pointer is null, indicates that users has copied data in application */
     if(NULL != buffer) {
-        /* if no error occurs, and the frame uses only one descriptor */
-        if((((uint32_t)RESET) == (dma_current_rxdesc->status & ENET_RDES0_ERRS)) &&
-                (((uint32_t)RESET) != (dma_current_rxdesc->status & ENET_RDES0_LDES)) &&
-                (((uint32_t)RESET) != (dma_current_rxdesc->status & ENET_RDES0_FDES))) {
+        /* if no error occurs */
+        if(((uint32_t)RESET) == (last->status & ENET_RDES0_ERRS)) {
             /* get the frame length except CRC */
-            size = GET_RDES0_FRML(dma_current_rxdesc->status);
-            size = size - 4U;
-
-            /* if is a type frame, and CRC is not included in forwarding frame */
-            if((RESET != (ENET_MAC_CFG & ENET_MAC_CFG_TFCD)) && (RESET != (dma_current_rxdesc->status & ENET_RDES0_FRMT))) {
-                size = size + 4U;
-            }
+            size = enet_rxframe_length(last->status);
 
             /* to avoid situation that the frame size exceeds the buffer length */
             if(size > bufsize) {
                 return ERROR;
             }
 
-            /* copy data from Rx buffer to application buffer */
-            for(offset = 0U; offset < size; offset++) {
-                (*(buffer + offset)) = (*(__IO uint8_t *)(uint32_t)((dma_current_rxdesc->buffer1_addr) + offset));
+            /* copy data from the Rx buffers to application buffer, every descriptor but the last one is full */
+            desc = dma_current_rxdesc;
+            for(num = 0U; (num < count) && (offset < size); num++) {
+                piece = desc->control_buffer_size & ENET_RDES1_RB1S;
+                if(piece > (size - offset)) {
+                    piece = size - offset;
+                }
+                for(index = 0U; index < piece; index++) {
+                    (*(buffer + offset + index)) = (*(__IO uint8_t *)(uint32_t)((desc->buffer1_addr) + index));
+                }
+                offset += piece;
+                desc = enet_rxdesc_next(desc);
             }
 
         } else {
@@ -912,31 +1043,9 @@ ErrStatus enet_frame_receive(uint8_t *buffer, uint32_t bufsize)
             return ERROR;
         }
     }
-    /* enable reception, descriptor is owned by DMA */
-    dma_current_rxdesc->status = ENET_RDES0_DAV;
 
-    /* check Rx buffer unavailable flag status */
-    if((uint32_t)RESET != (ENET_DMA_STAT & ENET_DMA_STAT_RBU)) {
-        /* clear RBU flag */
-        ENET_DMA_STAT = ENET_DMA_STAT_RBU;
-        /* resume DMA reception by writing to the RPEN register*/
-        ENET_DMA_RPEN = 0U;
-    }
-
-    /* update the current RxDMA descriptor pointer to the next decriptor in RxDMA decriptor table */
-    /* chained mode */
-    if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RCHM)) {
-        dma_current_rxdesc = (enet_descriptors_struct *)(dma_current_rxdesc->buffer2_next_desc_addr);
-    } else {
-        /* ring mode */
-        if((uint32_t)RESET != (dma_current_rxdesc->control_buffer_size & ENET_RDES1_RERM)) {
-            /* if is the last descriptor in table, the next descriptor is the table header */
-            dma_current_rxdesc = (enet_descriptors_struct *)(ENET_DMA_RDTADDR);
-        } else {
-            /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
-            dma_current_rxdesc = (enet_descriptors_struct *)(uint32_t)((uint32_t)dma_current_rxdesc + ETH_DMARXDESC_SIZE + (GET_DMA_BCTL_DPSL(ENET_DMA_BCTL)));
-        }
-    }
+    /* enable reception, descriptors are owned by DMA, and update the current RxDMA descriptor pointer */
+    enet_rxframe_drop_desc(count);
 
     return SUCCESS;
 }
@@ -954,8 +1063,8 @@ ErrStatus enet_frame_transmit(uint8_t *buffer, uint32_t length)
     uint32_t offset = 0U;
     uint32_t dma_tbu_flag, dma_tu_flag;
 
-    /* the descriptor is busy due to own by the DMA */
-    if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
+    /* the descriptor is busy due to own by the DMA or by a zero-copy frame not reclaimed yet */
+    if(SUCCESS != enet_txdesc_free(dma_current_txdesc)) {
         return ERROR;
     }
 
@@ -964,6 +1073,11 @@ ErrStatus enet_frame_transmit(uint8_t *buffer, uint32_t length)
         return ERROR;
     }
 
+    /* the descriptors of enet_descriptors_region_init() may come without Tx buffers */
+    if(0U == dma_current_txdesc->buffer1_addr) {
+        return ERROR;
+    }
+
     /* if buffer pointer is null, indicates that users has handled data in application */
     if(NULL != buffer) {
         /* copy frame data from application buffer to Tx buffer */
@@ -1008,6 +1122,340 @@ ErrStatus enet_frame_transmit(uint8_t *buffer, uint32_t length)
     return SUCCESS;
 }
 
+/*!
+    \brief    loan the current received frame to the application without copying it
+    \param[in]  none
+    \param[out] frame: the descriptor, the DMA buffer and the length of the received frame
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note      frames with errors, or over more than the ring depth less ENET_RX_LOAN_RESERVE
+                descriptors, are dropped on the way. ERROR means no good frame is
+                completely received or less than ENET_RX_LOAN_RESERVE descriptors would
+                be left, in which case loaned frames must be returned or swapped first.
+                A frame over several descriptors comes as desc_count pieces, see
+                enet_rxframe_segments_get(), buffer only holds its start. Loaned descriptors
+                stay owned by CPU and the RxDMA stops when it reaches one, so frames
+                should go back in the order they were loaned, no frame is reported past
+                the oldest loaned one. Not for the PTP normal mode descriptors
+*/
+ErrStatus enet_rxframe_loan(enet_rxframe_struct *frame)
+{
+    uint32_t count = 0U;
+    enet_descriptors_struct *last;
+
+    /* drop the frames with errors and the ones too long to ever be loaned */
+    for(;;) {
+        last = enet_rxframe_scan(&count);
+        /* no frame is completely received */
+        if(NULL == last) {
+            return ERROR;
+        }
+        if((uint32_t)RESET != (last->status & ENET_RDES0_ERRS)) {
+            enet_rxframe_drop_desc(count);
+            continue;
+        }
+        /* a frame over more descriptors than the reserve leaves would block the ring for good */
+        if((count + ENET_RX_LOAN_RESERVE) > enet_rxdesc_num) {
+            enet_rxframe_drop_desc(count);
+            enet_rx_loan_dropped++;
+            continue;
+        }
+        break;
+    }
+
+    /* keep some descriptors for the DMA so the ring never starves */
+    if((enet_rx_loaned + count + ENET_RX_LOAN_RESERVE) > enet_rxdesc_num) {
+        return ERROR;
+    }
+
+    frame->desc = dma_current_rxdesc;
+    frame->buffer = (uint8_t *)(dma_current_rxdesc->buffer1_addr);
+    frame->length = enet_rxframe_length(last->status);
+    frame->desc_count = count;
+    if(0U == enet_rx_loaned) {
+        enet_rx_loan_first = dma_current_rxdesc;
+    }
+    enet_rx_loaned += count;
+
+    /* the descriptors stay owned by CPU, only the current RxDMA descriptor pointer moves on */
+    dma_current_rxdesc = enet_rxdesc_next(last);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    give a loaned frame's descriptor back to the DMA with its buffer
+    \param[in]  frame: the frame from enet_rxframe_loan(), its buffer must not be used afterwards
+    \param[out] none
+    \retval     none
+*/
+void enet_rxframe_return(enet_rxframe_struct *frame)
+{
+    uint32_t num = 0U;
+    enet_descriptors_struct *desc = frame->desc;
+
+    /* enable reception, descriptors are owned by DMA. The first one goes last, the
+       RxDMA waits on it and never finds the frame half returned */
+    for(num = 1U; num < frame->desc_count; num++) {
+        desc = enet_rxdesc_next(desc);
+        desc->status = ENET_RDES0_DAV;
+    }
+    /* the oldest loaned frame moves on to the next one. A frame returned out of order
+       leaves it in place and the scan waits there until the older frames are back */
+    if(frame->desc == enet_rx_loan_first) {
+        enet_rx_loan_first = enet_rxdesc_next(desc);
+    }
+    frame->desc->status = ENET_RDES0_DAV;
+    enet_rx_loaned -= frame->desc_count;
+
+    enet_rxdma_resume();
+}
+
+/*!
+    \brief    get the pieces of a loaned frame, one per descriptor
+    \param[in]  frame: the frame from enet_rxframe_loan()
+    \param[in]  num: number of entries in seg
+    \param[out] seg: buffer and length of each piece in frame order
+    \retval     number of pieces stored, at most num
+    \note      every piece but the last fills its descriptor buffer
+*/
+uint32_t enet_rxframe_segments_get(const enet_rxframe_struct *frame, enet_rxseg_struct seg[], uint32_t num)
+{
+    uint32_t count = 0U, left = frame->length, piece = 0U;
+    enet_descriptors_struct *desc = frame->desc;
+
+    while((count < frame->desc_count) && (count < num) && (0U != left)) {
+        piece = desc->control_buffer_size & ENET_RDES1_RB1S;
+        if(piece > left) {
+            piece = left;
+        }
+        seg[count].buffer = (uint8_t *)(desc->buffer1_addr);
+        seg[count].length = piece;
+        left -= piece;
+        count++;
+        desc = enet_rxdesc_next(desc);
+    }
+
+    return count;
+}
+
+/*!
+    \brief    give a loaned frame's descriptor back to the DMA with a fresh buffer
+    \param[in]  frame: the frame from enet_rxframe_loan(), its buffer now belongs to the application
+    \param[in]  buffer: fresh receive buffer, word aligned and at least the descriptor buffer size
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note      only the first descriptor takes the fresh buffer, the other pieces of a frame
+                over several descriptors go back to the DMA with their buffers. ERROR means
+                the buffer is in TCMRAM, the frame stays loaned
+*/
+ErrStatus enet_rxframe_swap(enet_rxframe_struct *frame, uint8_t *buffer)
+{
+    if(ENET_IN_TCM(buffer)) {
+        return ERROR;
+    }
+    frame->desc->buffer1_addr = (uint32_t)buffer;
+    enet_rxframe_return(frame);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    get the number of Rx descriptors loaned to the application
+    \param[in]  none
+    \param[out] none
+    \retval     number of loaned descriptors
+*/
+uint32_t enet_rxframe_loaned_get(void)
+{
+    return enet_rx_loaned;
+}
+
+/*!
+    \brief    get the number of frames enet_rxframe_loan() dropped as too long to loan
+    \param[in]  none
+    \param[out] none
+    \retval     number of dropped frames
+*/
+uint32_t enet_rxframe_loan_dropped_get(void)
+{
+    return enet_rx_loan_dropped;
+}
+
+/*!
+    \brief    transmit a frame gathered from application buffers without copying it
+    \param[in]  seg: pieces of the frame in order, e.g. a header and a payload
+    \param[in]  num: number of pieces
+    \param[in]  callback: called by enet_txframe_reclaim() once the DMA has finished with the buffers, NULL for none
+    \param[in]  arg: callback argument
+    \param[out] none
+    \retval     ErrStatus: SUCCESS or ERROR
+    \note      the descriptors point at the pieces, one per descriptor in chain mode and
+                two per descriptor (buffer1 and buffer2) in ring mode, pieces longer
+                than a descriptor buffer are split. The buffers must stay untouched
+                until the callback. ERROR means the frame is too long, a piece is in
+                TCMRAM, too many frames wait to be reclaimed or not enough descriptors
+                are free. The transmit
+                interrupt is enabled here, ENET_IRQHandler reclaims on TS once the ENET
+                interrupt is enabled in the NVIC, e.g. by enet_poll_init(). Not for the
+                PTP descriptor modes
+*/
+ErrStatus enet_frame_transmit_segments(const enet_txseg_struct seg[], uint32_t num, enet_txframe_callback callback, void *arg)
+{
+    enet_descriptors_struct *desc, *first;
+    enet_txframe_struct *frame;
+    uint32_t i, offset, piece, slot, per_desc, desc_num, primask;
+    uint32_t length = 0U, pieces = 0U;
+
+    /* give back what the DMA has finished with before looking for free descriptors */
+    enet_txframe_reclaim();
+    if(ENET_TX_INFLIGHT_NUM == enet_tx_inflight_num) {
+        return ERROR;
+    }
+
+    /* count the descriptor buffers the pieces need, the DMA cannot read TCMRAM */
+    for(i = 0U; i < num; i++) {
+        if((0U != seg[i].length) && ENET_IN_TCM(seg[i].buffer)) {
+            return ERROR;
+        }
+        length += seg[i].length;
+        pieces += (seg[i].length + ENET_TDES1_TB1S - 1U) / ENET_TDES1_TB1S;
+    }
+    /* only frame length no more than ENET_MAX_FRAME_SIZE is allowed */
+    if((0U == length) || (length > ENET_MAX_FRAME_SIZE)) {
+        return ERROR;
+    }
+    /* chained mode uses buffer2 as the next descriptor address */
+    per_desc = ((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_TCHM)) ? 1U : 2U;
+    desc_num = (pieces + per_desc - 1U) / per_desc;
+    if(desc_num > enet_txdesc_num) {
+        return ERROR;
+    }
+
+    /* all the descriptors must be free before any of them is touched */
+    first = dma_current_txdesc;
+    desc = first;
+    for(i = 0U; i < desc_num; i++) {
+        if(SUCCESS != enet_txdesc_free(desc)) {
+            return ERROR;
+        }
+        desc = enet_txdesc_next(desc);
+    }
+
+    /* point the descriptors at the pieces */
+    desc = NULL;
+    slot = 0U;
+    for(i = 0U; i < num; i++) {
+        for(offset = 0U; offset < seg[i].length; offset += piece) {
+            piece = seg[i].length - offset;
+            if(piece > ENET_TDES1_TB1S) {
+                piece = ENET_TDES1_TB1S;
+            }
+            if(0U == slot) {
+                desc = (NULL == desc) ? first : enet_txdesc_next(desc);
+                desc->status &= ~(ENET_TDES0_FSG | ENET_TDES0_LSG | ENET_TDES0_INTC);
+                desc->buffer1_addr = (uint32_t)&seg[i].buffer[offset];
+                desc->control_buffer_size = TDES1_TB1S(piece);
+            } else {
+                desc->buffer2_next_desc_addr = (uint32_t)&seg[i].buffer[offset];
+                desc->control_buffer_size |= TDES1_TB2S(piece);
+            }
+            slot = (slot + 1U) % per_desc;
+        }
+    }
+    first->status |= ENET_TDES0_FSG;
+    /* the last segment raises the transmit interrupt for the reclaim */
+    desc->status |= ENET_TDES0_LSG | ENET_TDES0_INTC;
+
+    /* masked against enet_txframe_reclaim() on the transmit interrupt, which must not
+       see the frame queued before its descriptors belong to the DMA */
+    primask = __get_PRIMASK();
+    __disable_irq();
+    /* TS after the last descriptor reclaims the frame from the ENET interrupt, masked as
+       enet_poll_irq() changes RIE in the same register */
+    if((ENET_DMA_INTEN_TIE | ENET_DMA_INTEN_NIE) != (ENET_DMA_INTEN & (ENET_DMA_INTEN_TIE | ENET_DMA_INTEN_NIE))) {
+        ENET_DMA_INTEN |= ENET_DMA_INTEN_TIE | ENET_DMA_INTEN_NIE;
+    }
+    frame = &enet_tx_inflight[(enet_tx_inflight_head + enet_tx_inflight_num) % ENET_TX_INFLIGHT_NUM];
+    frame->first = first;
+    frame->last = desc;
+    frame->desc_num = desc_num;
+    frame->callback = callback;
+    frame->arg = arg;
+    enet_tx_inflight_num++;
+
+    /* hand the descriptors to the DMA, the first one last so it never sees a partial frame */
+    for(desc = first; desc != frame->last;) {
+        desc = enet_txdesc_next(desc);
+        desc->status |= ENET_TDES0_DAV;
+    }
+    first->status |= ENET_TDES0_DAV;
+    __set_PRIMASK(primask);
+
+    enet_txdma_resume();
+
+    /* update the current TxDMA descriptor pointer to the descriptor after the frame */
+    dma_current_txdesc = enet_txdesc_next(frame->last);
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    reclaim the zero-copy frames the DMA has finished with
+    \param[in]  none
+    \param[out] none
+    \retval     number of frames reclaimed
+    \note      call it on the transmit interrupt (ENET_DMA_INT_FLAG_TS) or from time to
+                time. The descriptors get their Tx buffers back for enet_frame_transmit()
+                and the callbacks run here, oldest frame first. It may run on the interrupt
+                while enet_frame_transmit_segments() runs in thread mode
+*/
+uint32_t enet_txframe_reclaim(void)
+{
+    enet_txframe_struct *frame;
+    enet_descriptors_struct *desc;
+    enet_txframe_callback callback;
+    void *arg;
+    ErrStatus status;
+    uint32_t i, index, primask, count = 0U;
+
+    for(;;) {
+        /* masked so a reclaim on the interrupt and one in thread mode never take the same frame */
+        primask = __get_PRIMASK();
+        __disable_irq();
+        if(0U == enet_tx_inflight_num) {
+            __set_PRIMASK(primask);
+            break;
+        }
+        frame = &enet_tx_inflight[enet_tx_inflight_head];
+        /* the DMA gives the last descriptor back after the whole frame */
+        if((uint32_t)RESET != (frame->last->status & ENET_TDES0_DAV)) {
+            __set_PRIMASK(primask);
+            break;
+        }
+        status = ((uint32_t)RESET != (frame->last->status & ENET_TDES0_ES)) ? ERROR : SUCCESS;
+
+        /* restore the Tx buffer of each descriptor, none for a ring without Tx buffers */
+        desc = frame->first;
+        for(i = 0U; i < frame->desc_num; i++) {
+            index = ((uint32_t)desc - ENET_DMA_TDTADDR) / ETH_DMATXDESC_SIZE;
+            desc->buffer1_addr = (0U != enet_txbuf_size) ? (uint32_t)(&enet_txbuf[index * enet_txbuf_size]) : 0U;
+            desc = enet_txdesc_next(desc);
+        }
+
+        callback = frame->callback;
+        arg = frame->arg;
+        enet_tx_inflight_head = (enet_tx_inflight_head + 1U) % ENET_TX_INFLIGHT_NUM;
+        enet_tx_inflight_num--;
+        __set_PRIMASK(primask);
+        count++;
+        if(NULL != callback) {
+            callback(arg, status);
+        }
+    }
+
+    return count;
+}
+
 /*!
     \brief    configure the transmit IP frame checksum offload calculation and insertion
     \param[in]  desc: the descriptor pointer which users want to configure, refer to enet_descriptors_struct
@@ -2197,6 +2645,32 @@ void enet_rx_desc_delay_receive_complete_interrupt(enet_descriptors_struct *desc
     ENET_DMA_RSWDC = DMA_RSWDC_WDCFRS(delay_time);
 }
 
+/*!
+    \brief    configure the receive interrupt coalescing of all descriptors in the Rx ring
+    \param[in]  delay_time: RS bit in ENET_DMA_STAT register is set 256*delay_time HCLK after
+                a frame completes (0x00000000 - 0x000000FF), frames completing meanwhile share
+                the interrupt. 0 sets RS as soon as each frame completes
+    \param[out] none
+    \retval     none
+    \note      call it after the Rx descriptors are initialized, the init functions clear
+                DINTC. Not for the PTP descriptor modes
+*/
+void enet_rx_coalesce_config(uint32_t delay_time)
+{
+    uint32_t num = 0U;
+    enet_descriptors_struct *desc = (enet_descriptors_struct *)(ENET_DMA_RDTADDR);
+
+    for(num = 0U; num < enet_rxdesc_num; num++) {
+        if(0U == delay_time) {
+            enet_rx_desc_immediate_receive_complete_interrupt(desc);
+        } else {
+            desc->control_buffer_size |= ENET_RDES1_DINTC;
+        }
+        desc = enet_rxdesc_next(desc);
+    }
+    ENET_DMA_RSWDC = DMA_RSWDC_WDCFRS(delay_time);
+}
+
 /*!
     \brief    drop current receive frame
     \param[in]  none
@@ -2351,6 +2825,11 @@ void enet_ptp_enhanced_descriptors_chain_init(enet_dmadirection_enum direction)
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR = (uint32_t)desc_tab;
         dma_current_txdesc = desc_tab;
+        enet_txdesc_num = ENET_TXBUF_NUM;
+        enet_txbuf = &tx_buff[0][0];
+        enet_txbuf_size = ENET_TXBUF_SIZE;
+        enet_tx_inflight_head = 0U;
+        enet_tx_inflight_num = 0U;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
@@ -2367,6 +2846,8 @@ void enet_ptp_enhanced_descriptors_chain_init(enet_dmadirection_enum direction)
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR = (uint32_t)desc_tab;
         dma_current_rxdesc = desc_tab;
+        enet_rxdesc_num = ENET_RXBUF_NUM;
+        enet_rx_loaned = 0U;
     }
 
     /* configuration each descriptor */
@@ -2426,6 +2907,11 @@ void enet_ptp_enhanced_descriptors_ring_init(enet_dmadirection_enum direction)
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR = (uint32_t)desc_tab;
         dma_current_txdesc = desc_tab;
+        enet_txdesc_num = ENET_TXBUF_NUM;
+        enet_txbuf = &tx_buff[0][0];
+        enet_txbuf_size = ENET_TXBUF_SIZE;
+        enet_tx_inflight_head = 0U;
+        enet_tx_inflight_num = 0U;
     } else {
         /* if want to initialize DMA Rx descriptors */
         /* save a copy of the DMA Rx descriptors */
@@ -2442,6 +2928,8 @@ void enet_ptp_enhanced_descriptors_ring_init(enet_dmadirection_enum direction)
         /* configure DMA Rx descriptor table address register */
         ENET_DMA_RDTADDR = (uint32_t)desc_tab;
         dma_current_rxdesc = desc_tab;
+        enet_rxdesc_num = ENET_RXBUF_NUM;
+        enet_rx_loaned = 0U;
     }
 
     /* configure each descriptor */
@@ -2581,8 +3069,8 @@ ErrStatus enet_ptpframe_transmit_enhanced_mode(uint8_t *buffer, uint32_t length,
     uint32_t tdes0_ttmss_flag;
     uint32_t timeout = 0;
 
-    /* the descriptor is busy due to own by the DMA */
-    if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
+    /* the descriptor is busy due to own by the DMA or by a zero-copy frame not reclaimed yet */
+    if(SUCCESS != enet_txdesc_free(dma_current_txdesc)) {
         return ERROR;
     }
 
@@ -2698,6 +3186,11 @@ void enet_ptp_normal_descriptors_chain_init(enet_dmadirection_enum direction, en
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR = (uint32_t)desc_tab;
         dma_current_txdesc = desc_tab;
+        enet_txdesc_num = ENET_TXBUF_NUM;
+        enet_txbuf = &tx_buff[0][0];
+        enet_txbuf_size = ENET_TXBUF_SIZE;
+        enet_tx_inflight_head = 0U;
+        enet_tx_inflight_num = 0U;
         dma_current_ptp_txdesc = desc_ptptab;
     } else {
         /* if want to initialize DMA Rx descriptors */
@@ -2716,6 +3209,8 @@ void enet_ptp_normal_descriptors_chain_init(enet_dmadirection_enum direction, en
         ENET_DMA_RDTADDR = (uint32_t)desc_tab;
         dma_current_rxdesc = desc_tab;
         dma_current_ptp_rxdesc = desc_ptptab;
+        enet_rxdesc_num = ENET_RXBUF_NUM;
+        enet_rx_loaned = 0U;
     }
 
     /* configure each descriptor */
@@ -2781,6 +3276,11 @@ void enet_ptp_normal_descriptors_ring_init(enet_dmadirection_enum direction, ene
         /* configure DMA Tx descriptor table address register */
         ENET_DMA_TDTADDR = (uint32_t)desc_tab;
         dma_current_txdesc = desc_tab;
+        enet_txdesc_num = ENET_TXBUF_NUM;
+        enet_txbuf = &tx_buff[0][0];
+        enet_txbuf_size = ENET_TXBUF_SIZE;
+        enet_tx_inflight_head = 0U;
+        enet_tx_inflight_num = 0U;
         dma_current_ptp_txdesc = desc_ptptab;
     } else {
         /* if want to initialize DMA Rx descriptors */
@@ -2799,6 +3299,8 @@ void enet_ptp_normal_descriptors_ring_init(enet_dmadirection_enum direction, ene
         ENET_DMA_RDTADDR = (uint32_t)desc_tab;
         dma_current_rxdesc = desc_tab;
         dma_current_ptp_rxdesc = desc_ptptab;
+        enet_rxdesc_num = ENET_RXBUF_NUM;
+        enet_rx_loaned = 0U;
     }
 
     /* configure each descriptor */
@@ -2938,8 +3440,8 @@ ErrStatus enet_ptpframe_transmit_normal_mode(uint8_t *buffer, uint32_t length, u
     uint32_t offset = 0U, timeout = 0U;
     uint32_t dma_tbu_flag, dma_tu_flag, tdes0_ttmss_flag;
 
-    /* the descriptor is busy due to own by the DMA */
-    if((uint32_t)RESET != (dma_current_txdesc->status & ENET_TDES0_DAV)) {
+    /* the descriptor is busy due to own by the DMA or by a zero-copy frame not reclaimed yet */
+    if(SUCCESS != enet_txdesc_free(dma_current_txdesc)) {
         return ERROR;
     }
 
@@ -3502,6 +4004,200 @@ static void enet_default_init(void)
     ENET_DMA_BCTL = reg_value;
 }
 
+/*!
+    \brief    get the length of a received frame from its last descriptor status
+    \param[in]  status: RDES0 of the last descriptor of the frame
+    \param[out] none
+    \retval     frame length, without CRC unless it is kept in the forwarded frame
+*/
+static uint32_t enet_rxframe_length(uint32_t status)
+{
+    /* get the frame length except CRC */
+    uint32_t size = GET_RDES0_FRML(status) - 4U;
+
+    /* if is a type frame, and CRC is not included in forwarding frame */
+    if((RESET != (ENET_MAC_CFG & ENET_MAC_CFG_TFCD)) && (RESET != (status & ENET_RDES0_FRMT))) {
+        size = size + 4U;
+    }
+
+    return size;
+}
+
+/*!
+    \brief    get the descriptor following desc in the Rx descriptor chain or ring
+    \param[in]  desc: Rx descriptor
+    \param[out] none
+    \retval     next Rx descriptor
+*/
+static enet_descriptors_struct *enet_rxdesc_next(enet_descriptors_struct *desc)
+{
+    /* chained mode */
+    if((uint32_t)RESET != (desc->control_buffer_size & ENET_RDES1_RCHM)) {
+        return (enet_descriptors_struct *)(desc->buffer2_next_desc_addr);
+    }
+    /* ring mode */
+    if((uint32_t)RESET != (desc->control_buffer_size & ENET_RDES1_RERM)) {
+        /* if is the last descriptor in table, the next descriptor is the table header */
+        return (enet_descriptors_struct *)(ENET_DMA_RDTADDR);
+    }
+    /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
+    return (enet_descriptors_struct *)(uint32_t)((uint32_t)desc + ETH_DMARXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL));
+}
+
+/*!
+    \brief    find the descriptors of the current received frame
+    \param[in]  none
+    \param[out] count: number of descriptors from the current RxDMA descriptor on
+    \retval     last descriptor of the frame, holding its status, or NULL if no frame is
+                completely received
+    \note      descriptors left over from a frame whose start or end got lost are dropped,
+                loaned descriptors are never reported or dropped. Frames over several descriptors need the normal chain or ring mode, the
+                PTP normal mode descriptors do not link to each other
+*/
+static enet_descriptors_struct *enet_rxframe_scan(uint32_t *count)
+{
+    enet_descriptors_struct *desc;
+    uint32_t num = 0U;
+
+    for(;;) {
+        desc = dma_current_rxdesc;
+        /* the ring wrapped onto the frames still loaned to the application */
+        if((0U != enet_rx_loaned) && (desc == enet_rx_loan_first)) {
+            return NULL;
+        }
+        /* the descriptor is busy due to own by the DMA */
+        if((uint32_t)RESET != (desc->status & ENET_RDES0_DAV)) {
+            return NULL;
+        }
+        /* the tail of a frame without its first descriptor */
+        if((uint32_t)RESET == (desc->status & ENET_RDES0_FDES)) {
+            enet_rxframe_drop_desc(1U);
+            continue;
+        }
+
+        num = 1U;
+        while((uint32_t)RESET == (desc->status & ENET_RDES0_LDES)) {
+            if(num >= enet_rxdesc_num) {
+                return NULL;
+            }
+            desc = enet_rxdesc_next(desc);
+            /* the rest of the frame is still being received, or waits for the loaned frames */
+            if(((uint32_t)RESET != (desc->status & ENET_RDES0_DAV)) ||
+                    ((0U != enet_rx_loaned) && (desc == enet_rx_loan_first))) {
+                return NULL;
+            }
+            /* a new frame starts before the last descriptor, the earlier one was cut short */
+            if((uint32_t)RESET != (desc->status & ENET_RDES0_FDES)) {
+                break;
+            }
+            num++;
+        }
+        if((uint32_t)RESET == (desc->status & ENET_RDES0_LDES)) {
+            enet_rxframe_drop_desc(num);
+            continue;
+        }
+
+        *count = num;
+        return desc;
+    }
+}
+
+/*!
+    \brief    give the descriptors of the current received frame back to the DMA
+    \param[in]  count: number of descriptors from the current RxDMA descriptor on
+    \param[out] none
+    \retval     none
+*/
+static void enet_rxframe_drop_desc(uint32_t count)
+{
+    uint32_t num = 0U;
+
+    for(num = 0U; num < count; num++) {
+        enet_rxframe_drop();
+    }
+    enet_rxdma_resume();
+}
+
+/*!
+    \brief    resume the RxDMA if it stopped on a descriptor owned by CPU
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void enet_rxdma_resume(void)
+{
+    /* check Rx buffer unavailable flag status */
+    if((uint32_t)RESET != (ENET_DMA_STAT & ENET_DMA_STAT_RBU)) {
+        /* clear RBU flag */
+        ENET_DMA_STAT = ENET_DMA_STAT_RBU;
+        /* resume DMA reception by writing to the RPEN register*/
+        ENET_DMA_RPEN = 0U;
+    }
+}
+
+/*!
+    \brief    get the descriptor following desc in the Tx descriptor chain or ring
+    \param[in]  desc: Tx descriptor
+    \param[out] none
+    \retval     next Tx descriptor
+*/
+static enet_descriptors_struct *enet_txdesc_next(enet_descriptors_struct *desc)
+{
+    /* chained mode */
+    if((uint32_t)RESET != (desc->status & ENET_TDES0_TCHM)) {
+        return (enet_descriptors_struct *)(desc->buffer2_next_desc_addr);
+    }
+    /* ring mode */
+    if((uint32_t)RESET != (desc->status & ENET_TDES0_TERM)) {
+        /* if is the last descriptor in table, the next descriptor is the table header */
+        return (enet_descriptors_struct *)(ENET_DMA_TDTADDR);
+    }
+    /* the next descriptor is the current address, add the descriptor size, and descriptor skip length */
+    return (enet_descriptors_struct *)(uint32_t)((uint32_t)desc + ETH_DMATXDESC_SIZE + GET_DMA_BCTL_DPSL(ENET_DMA_BCTL));
+}
+
+/*!
+    \brief    check that a Tx descriptor can take a new frame
+    \param[in]  desc: Tx descriptor
+    \param[out] none
+    \retval     ErrStatus: SUCCESS if free, ERROR if owned by the DMA or by a zero-copy frame not reclaimed yet
+    \note      going round the ring from the current descriptor, the first descriptor
+                of the oldest zero-copy frame is the first one still in use by any
+*/
+static ErrStatus enet_txdesc_free(enet_descriptors_struct *desc)
+{
+    if((uint32_t)RESET != (desc->status & ENET_TDES0_DAV)) {
+        return ERROR;
+    }
+    if((0U != enet_tx_inflight_num) && (desc == enet_tx_inflight[enet_tx_inflight_head].first)) {
+        return ERROR;
+    }
+
+    return SUCCESS;
+}
+
+/*!
+    \brief    resume the TxDMA if it stopped or underflowed
+    \param[in]  none
+    \param[out] none
+    \retval     none
+*/
+static void enet_txdma_resume(void)
+{
+    uint32_t dma_tbu_flag, dma_tu_flag;
+
+    /* check Tx buffer unavailable flag status */
+    dma_tbu_flag = (ENET_DMA_STAT & ENET_DMA_STAT_TBU);
+    dma_tu_flag = (ENET_DMA_STAT & ENET_DMA_STAT_TU);
+
+    if((RESET != dma_tbu_flag) || (RESET != dma_tu_flag)) {
+        /* clear TBU and TU flag */
+        ENET_DMA_STAT = (dma_tbu_flag | dma_tu_flag);
+        /* resume DMA transmission by writing to the TPEN register*/
+        ENET_DMA_TPEN = 0U;
+    }
+}
+
 #ifndef USE_DELAY
 /*!
     \brief    insert a delay time
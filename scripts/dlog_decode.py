@@ -0,0 +1,315 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+延迟二进制日志解码 (Deferred Log Decoder)
+
+功能描述:
+    固件中的 DLOG() 只输出格式字符串ID和原始参数字, 格式字符串保存在ELF的
+    .dlog_fmt 段中(不下载到芯片)。本脚本直接解析ELF文件, 把串口抓取的数据流
+    还原成文本。流中混合的printf文本原样输出。
+
+记录格式(小端, 与 Core/inc/dlog.h 一致):
+    word0  bit0-7 同步字节0x00, bit8-15 参数个数, bit16-31 序号
+    word1  格式字符串ID(在 .dlog_fmt 段中的偏移)
+    word2  DWT->CYCCNT 时间戳
+    word3+ 参数, 每个32位
+
+使用方法:
+    1. 从已抓取的文件解码:
+       python dlog_decode.py build/gd32f4xx_project.elf capture.bin
+
+    2. 直接从串口读取(需要 pyserial), 按 Ctrl+C 结束:
+       python dlog_decode.py build/gd32f4xx_project.elf --port /dev/ttyUSB0 --clock 168000000
+
+    3. 主机端自测(构造ELF和数据流, 编码后再解码比较):
+       python dlog_decode.py --selftest
+
+注意事项:
+    - %s 参数必须指向FLASH中的常量字符串, 脚本从ELF中读取
+    - %f/%e/%g 参数需在固件中用 DLOG_FLOAT() 传递
+    - 序号不连续时会输出丢失的记录数
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+SYNC = 0x00
+MAX_ARGS = 8
+HEADER_WORDS = 3
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+RE_SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t)?([diouxXcspfeEgG%])")
+
+
+class ElfImage:
+    """最小的ELF解析器, 只读取段表"""
+
+    def __init__(self, data):
+        if data[:4] != b"\x7fELF":
+            raise ValueError("不是ELF文件")
+        is64 = data[4] == 2
+        if data[5] != 1:
+            raise ValueError("只支持小端ELF")
+        if is64:
+            shoff, = struct.unpack_from("<Q", data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+            fmt = "<IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from("<I", data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+            fmt = "<IIIIIIIIII"
+
+        headers = [struct.unpack_from(fmt, data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx]
+        self.sections = {}
+        for h in headers:
+            name_off, sh_type, flags, addr, offset, size = h[:6]
+            start = names[4] + name_off
+            name = data[start:data.index(b"\0", start)].decode("ascii", "replace")
+            body = b"" if sh_type == SHT_NOBITS else data[offset:offset + size]
+            self.sections[name] = (sh_type, flags, addr, body)
+
+    def formats(self):
+        """返回 {ID: 格式字符串}"""
+        if ".dlog_fmt" not in self.sections:
+            raise ValueError("ELF中没有 .dlog_fmt 段")
+        _, _, base, body = self.sections[".dlog_fmt"]
+        table = {}
+        pos = 0
+        while pos < len(body):
+            if body[pos] == 0:
+                pos += 1
+                continue
+            end = body.index(b"\0", pos)
+            # 固件链接在地址0(INFO段), 主机测试程序中该段已加载, ID为其地址的低32位
+            table[(base + pos) & 0xFFFFFFFF] = body[pos:end].decode("utf-8", "replace")
+            pos = end + 1
+        return table
+
+    def cstring(self, addr):
+        """从已加载的段中读取C字符串"""
+        for sh_type, flags, base, body in self.sections.values():
+            if flags & SHF_ALLOC and body and base <= addr < base + len(body):
+                end = body.find(b"\0", addr - base)
+                if end < 0:
+                    end = len(body)
+                return body[addr - base:end].decode("utf-8", "replace")
+        return "<0x%08x>" % addr
+
+
+def count_args(fmt):
+    return sum(1 for m in RE_SPEC.finditer(fmt) if m.group(5) != "%")
+
+
+def c_format(fmt, args, elf):
+    """按C printf语义格式化32位参数"""
+    args = list(args)
+    out = []
+    pos = 0
+    for m in RE_SPEC.finditer(fmt):
+        out.append(fmt[pos:m.start()])
+        pos = m.end()
+        flags, width, prec, _, conv = m.groups()
+        if conv == "%":
+            out.append("%")
+            continue
+        if width == "*":
+            width = str(struct.unpack("<i", struct.pack("<I", args.pop(0)))[0])
+        if prec == "*":
+            prec = str(args.pop(0))
+        spec = "%" + flags + (width or "") + ("." + prec if prec is not None else "")
+        value = args.pop(0) if args else 0
+        if conv in "di":
+            out.append((spec + "d") % struct.unpack("<i", struct.pack("<I", value))[0])
+        elif conv == "u":
+            out.append((spec + "d") % value)
+        elif conv in "oxX":
+            out.append((spec + conv) % value)
+        elif conv == "c":
+            out.append((spec + "c") % chr(value & 0xFF))
+        elif conv == "s":
+            out.append((spec + "s") % elf.cstring(value))
+        elif conv == "p":
+            out.append("0x%08x" % value)
+        else:
+            out.append((spec + conv) % struct.unpack("<f", struct.pack("<I", value))[0])
+    out.append(fmt[pos:])
+    return "".join(out)
+
+
+def decode_stream(data, elf, formats, state=None):
+    """解析数据流, 返回 (事件列表, 剩余未完成的字节), state 在多次调用间保存序号"""
+    if state is None:
+        state = {}
+    events = []
+    text = bytearray()
+    last_seq = state.get("seq")
+    pos = 0
+    while pos < len(data):
+        if data[pos] != SYNC:
+            text.append(data[pos])
+            pos += 1
+            continue
+        if pos + HEADER_WORDS * 4 > len(data):
+            break
+        header, fmt_id, cycles = struct.unpack_from("<III", data, pos)
+        nargs = (header >> 8) & 0xFF
+        seq = header >> 16
+        fmt = formats.get(fmt_id)
+        if nargs > MAX_ARGS or fmt is None or count_args(fmt) != nargs:
+            pos += 1
+            continue
+        size = (HEADER_WORDS + nargs) * 4
+        if pos + size > len(data):
+            break
+        args = struct.unpack_from("<%dI" % nargs, data, pos + HEADER_WORDS * 4)
+        if text:
+            events.append(("text", text.decode("utf-8", "replace")))
+            text = bytearray()
+        if last_seq is not None and seq != (last_seq + 1) & 0xFFFF:
+            events.append(("lost", (seq - last_seq - 1) & 0xFFFF))
+        last_seq = seq
+        events.append(("log", seq, cycles, c_format(fmt, args, elf)))
+        pos += size
+    if text:
+        events.append(("text", text.decode("utf-8", "replace")))
+    state["seq"] = last_seq
+    return events, data[pos:]
+
+
+def print_events(events, clock):
+    for ev in events:
+        if ev[0] == "text":
+            sys.stdout.write(ev[1])
+        elif ev[0] == "lost":
+            print("\n[dlog] %d records lost" % ev[1])
+        else:
+            _, seq, cycles, text = ev
+            if clock:
+                print("\n[%12.6f] %s" % (cycles / float(clock), text))
+            else:
+                print("\n[%10u] %s" % (cycles, text))
+    sys.stdout.flush()
+
+
+def encode_record(seq, fmt_id, cycles, args):
+    """与固件 dlog_write() 相同的编码, 供自测使用"""
+    header = SYNC | (len(args) << 8) | ((seq & 0xFFFF) << 16)
+    return struct.pack("<III%dI" % len(args), header, fmt_id, cycles, *args)
+
+
+def build_test_elf(sections):
+    """构造只有段表的ELF32, sections 为 [(name, type, flags, addr, body)]"""
+    names = b"\0"
+    name_offsets = []
+    for name, _, _, _, _ in sections:
+        name_offsets.append(len(names))
+        names += name.encode() + b"\0"
+    all_sections = [("", 0, 0, 0, b"")] + list(sections) + [(".shstrtab", 3, 0, 0, names)]
+    name_offsets = [0] + name_offsets + [len(names)]
+    names += b".shstrtab\0"
+    all_sections[-1] = (".shstrtab", 3, 0, 0, names)
+
+    body = bytearray(52)
+    offsets = []
+    for sec in all_sections:
+        offsets.append(len(body))
+        body += sec[4]
+    shoff = len(body)
+    for i, (name, sh_type, flags, addr, data) in enumerate(all_sections):
+        body += struct.pack("<IIIIIIIIII", name_offsets[i], sh_type, flags, addr,
+                            offsets[i], len(data), 0, 0, 1, 0)
+    header = b"\x7fELF" + bytes([1, 1, 1]) + bytes(9)
+    header += struct.pack("<HHIIIIIHHHHHH", 2, 40, 1, 0, 0, shoff, 0, 52, 0, 0, 40,
+                          len(all_sections), len(all_sections) - 1)
+    body[:52] = header
+    return bytes(body)
+
+
+def selftest():
+    formats = ["boot %u ms", "irq %d on %s", "temp %.2f C", "ptr %p flags 0x%04x", "plain"]
+    fmt_body = bytearray()
+    ids = []
+    for f in formats:
+        ids.append(len(fmt_body))
+        fmt_body += f.encode() + b"\0"
+        while len(fmt_body) % 4:
+            fmt_body += b"\0"
+    rodata_addr = 0x08001000
+    rodata = b"USART0\0"
+    elf = ElfImage(build_test_elf([
+        (".rodata", 1, SHF_ALLOC, rodata_addr, rodata),
+        (".dlog_fmt", 1, 0, 0, bytes(fmt_body)),
+    ]))
+    table = elf.formats()
+
+    temp = struct.unpack("<I", struct.pack("<f", 21.5))[0]
+    stream = b"hello\r\n"
+    stream += encode_record(0, ids[0], 100, [42])
+    stream += encode_record(1, ids[1], 200, [0xFFFFFFFE, rodata_addr])
+    stream += b"text in between"
+    stream += encode_record(3, ids[2], 300, [temp])
+    stream += encode_record(4, ids[3], 400, [0x20000010, 0xAB])
+    stream += encode_record(5, ids[4], 500, [])
+
+    events, rest = decode_stream(stream, elf, table)
+    got = [e[3] if e[0] == "log" else e[1] for e in events]
+    expected = ["hello\r\n", "boot 42 ms", "irq -2 on USART0", "text in between", 1,
+                "temp 21.50 C", "ptr 0x20000010 flags 0x00ab", "plain"]
+    if got != expected or rest:
+        print("selftest FAILED")
+        print("expected", expected)
+        print("got     ", got)
+        return 1
+    print("selftest ok, %d records" % sum(1 for e in events if e[0] == "log"))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="decode DLOG() records")
+    parser.add_argument("elf", nargs="?", help="firmware ELF with the .dlog_fmt section")
+    parser.add_argument("capture", nargs="?", help="captured binary stream")
+    parser.add_argument("--port", help="serial port to read from")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--clock", type=int, default=0, help="core clock in Hz, prints seconds")
+    parser.add_argument("--selftest", action="store_true", help="encode and decode on the host")
+    args = parser.parse_args()
+
+    if args.selftest:
+        sys.exit(selftest())
+    if not args.elf:
+        parser.error("需要指定ELF文件")
+
+    with open(args.elf, "rb") as f:
+        elf = ElfImage(f.read())
+    formats = elf.formats()
+
+    if args.port:
+        try:
+            import serial
+        except ImportError:
+            sys.exit("读取串口需要 pyserial: pip install pyserial")
+        pending = b""
+        state = {}
+        with serial.Serial(args.port, args.baud, timeout=0.2) as ser:
+            try:
+                while True:
+                    pending += ser.read(4096)
+                    events, pending = decode_stream(pending, elf, formats, state)
+                    print_events(events, args.clock)
+            except KeyboardInterrupt:
+                pass
+    elif args.capture:
+        with open(args.capture, "rb") as f:
+            events, _ = decode_stream(f.read(), elf, formats)
+        print_events(events, args.clock)
+    else:
+        parser.error("需要指定抓取文件或 --port")
+
+
+if __name__ == "__main__":
+    main()
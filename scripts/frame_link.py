@@ -0,0 +1,299 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+COBS帧传输主机端库 (Frame Link Host Library)
+
+功能描述:
+    与固件 Core/src/frame.c 配套的主机端实现。每帧包含序号、类型和负载,
+    用片上CRC单元相同的CRC-32/MPEG-2校验, 整帧经COBS编码后以0x00结尾,
+    可以直接在任意字节流(串口、pty、socket)上传输。
+
+帧格式(小端, 与 Core/inc/frame.h 一致):
+    seq    u16  发送方序号, 每帧加1
+    type   u8   消息类型
+    flags  u8   保留, 为0
+    data   负载
+    crc    u32  CRC-32/MPEG-2, 输入为头部字、按32位小端分组并补零的负载、负载长度字
+
+使用方法:
+    1. 作为库使用:
+       from frame_link import FrameLink
+       link = FrameLink.open_serial("/dev/ttyUSB1", 2000000)
+       link.send(1, b"hello")
+       frame = link.recv(timeout=1.0)
+
+    2. 监听串口并打印收到的帧(需要 pyserial):
+       python frame_link.py --port /dev/ttyUSB1 --baud 2000000
+
+    3. 主机端自测, 用Linux pty模拟开发板回环并比较二进制帧与文本的负载速率:
+       python frame_link.py --selftest
+
+注意事项:
+    - 固件端的CRC由硬件计算, 本脚本用查表法得到相同结果
+    - 序号不连续时 FrameDecoder.lost 累加丢失的帧数
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import threading
+import time
+
+HEADER = struct.Struct("<HBB")
+HEADER_SIZE = 4
+CRC_SIZE = 4
+OVERHEAD = HEADER_SIZE + CRC_SIZE
+COBS_RUN = 254
+
+
+def _crc_table():
+    table = []
+    for i in range(256):
+        c = i << 24
+        for _ in range(8):
+            c = ((c << 1) ^ 0x04C11DB7) if c & 0x80000000 else (c << 1)
+        table.append(c & 0xFFFFFFFF)
+    return table
+
+
+CRC_TABLE = _crc_table()
+
+
+def crc32_words(words, crc=0xFFFFFFFF):
+    """CRC单元算法: 每个32位字从最高字节开始移入, 不反射, 不异或输出"""
+    for w in words:
+        for shift in (24, 16, 8, 0):
+            crc = ((crc << 8) & 0xFFFFFFFF) ^ CRC_TABLE[((crc >> 24) ^ (w >> shift)) & 0xFF]
+    return crc
+
+
+def frame_crc(header, payload):
+    padded = payload + b"\0" * (-len(payload) % 4)
+    words = struct.unpack("<%dI" % ((HEADER_SIZE + len(padded)) // 4), header + padded)
+    return crc32_words(list(words) + [len(payload)])
+
+
+def cobs_encode(data):
+    """COBS编码, 不含结尾的0x00, 与固件编码器逐字节一致"""
+    out = bytearray(b"\0")
+    code_pos = 0
+    run = 0
+    for b in data:
+        if b == 0:
+            out[code_pos] = run + 1
+            code_pos = len(out)
+            out.append(0)
+            run = 0
+            continue
+        out.append(b)
+        run += 1
+        if run == COBS_RUN:
+            out[code_pos] = run + 1
+            code_pos = len(out)
+            out.append(0)
+            run = 0
+    out[code_pos] = run + 1
+    return bytes(out)
+
+
+def cobs_decode(data):
+    """COBS解码, 输入不含0x00, 格式错误时抛出 ValueError"""
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        code = data[pos]
+        if code == 0 or pos + code > len(data):
+            raise ValueError("COBS格式错误")
+        out += data[pos + 1:pos + code]
+        pos += code
+        if code != 0xFF and pos < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode_frame(seq, msg_type, payload):
+    header = HEADER.pack(seq & 0xFFFF, msg_type & 0xFF, 0)
+    body = header + payload + struct.pack("<I", frame_crc(header, payload))
+    return cobs_encode(body) + b"\0"
+
+
+class FrameDecoder:
+    """流式解码器, feed() 返回完整的 (seq, type, payload) 列表"""
+
+    def __init__(self):
+        self.pending = bytearray()
+        self.last_seq = None
+        self.frames = 0
+        self.crc_errors = 0
+        self.cobs_errors = 0
+        self.lost = 0
+
+    def feed(self, data):
+        self.pending += data
+        frames = []
+        while True:
+            end = self.pending.find(b"\0")
+            if end < 0:
+                break
+            chunk = bytes(self.pending[:end])
+            del self.pending[:end + 1]
+            if not chunk:
+                continue
+            try:
+                body = cobs_decode(chunk)
+            except ValueError:
+                self.cobs_errors += 1
+                continue
+            if len(body) < OVERHEAD:
+                self.cobs_errors += 1
+                continue
+            header, payload = body[:HEADER_SIZE], body[HEADER_SIZE:-CRC_SIZE]
+            crc, = struct.unpack("<I", body[-CRC_SIZE:])
+            if crc != frame_crc(header, payload):
+                self.crc_errors += 1
+                continue
+            seq, msg_type, _ = HEADER.unpack(header)
+            if self.last_seq is not None and seq != (self.last_seq + 1) & 0xFFFF:
+                self.lost += (seq - self.last_seq - 1) & 0xFFFF
+            self.last_seq = seq
+            self.frames += 1
+            frames.append((seq, msg_type, payload))
+        return frames
+
+
+class FrameLink:
+    """在文件描述符或pyserial对象上收发帧"""
+
+    def __init__(self, read, write):
+        self._read = read
+        self._write = write
+        self.decoder = FrameDecoder()
+        self.seq = 0
+        self.queue = []
+
+    @classmethod
+    def open_fd(cls, fd):
+        def read(timeout):
+            ready, _, _ = select.select([fd], [], [], timeout)
+            return os.read(fd, 65536) if ready else b""
+
+        def write(data):
+            view = memoryview(data)
+            while view:
+                view = view[os.write(fd, view):]
+        return cls(read, write)
+
+    @classmethod
+    def open_serial(cls, port, baud):
+        try:
+            import serial
+        except ImportError:
+            sys.exit("读取串口需要 pyserial: pip install pyserial")
+        ser = serial.Serial(port, baud, timeout=0)
+
+        def read(timeout):
+            ser.timeout = timeout
+            return ser.read(max(1, ser.in_waiting))
+        return cls(read, ser.write)
+
+    def send(self, msg_type, payload):
+        self._write(encode_frame(self.seq, msg_type, bytes(payload)))
+        self.seq = (self.seq + 1) & 0xFFFF
+
+    def recv(self, timeout=None):
+        """返回 (seq, type, payload), 超时返回 None"""
+        deadline = None if timeout is None else time.monotonic() + timeout
+        while not self.queue:
+            wait = 0.5 if deadline is None else deadline - time.monotonic()
+            if wait <= 0:
+                return None
+            self.queue += self.decoder.feed(self._read(wait))
+        return self.queue.pop(0)
+
+
+def board_echo(fd, stop):
+    """pty主端上的开发板替身: 解码每帧并用自己的序号回送"""
+    link = FrameLink.open_fd(fd)
+    while not stop.is_set():
+        frame = link.recv(timeout=0.1)
+        if frame is not None:
+            link.send(frame[1], frame[2])
+
+
+def selftest():
+    import tty
+
+    # 与固件编码结果逐字节比较(seq 0x1234, type 9, 负载 01 00 02 00 00 03)
+    vector = bytes.fromhex("0434120902010202010603754365db00")
+    if encode_frame(0x1234, 9, bytes([1, 0, 2, 0, 0, 3])) != vector:
+        print("selftest FAILED: encoder does not match the firmware vector")
+        return 1
+    for data in (b"", b"\0", b"\0" * 300, bytes(range(1, 255)), bytes(range(1, 256)) * 3, os.urandom(2000)):
+        if cobs_decode(cobs_encode(data)) != data or 0 in cobs_encode(data):
+            print("selftest FAILED: COBS round trip")
+            return 1
+
+    master, slave = os.openpty()
+    tty.setraw(master)
+    tty.setraw(slave)
+    stop = threading.Event()
+    board = threading.Thread(target=board_echo, args=(master, stop), daemon=True)
+    board.start()
+
+    host = FrameLink.open_fd(slave)
+    count, size = 500, 256
+    wire = 0
+    start = time.monotonic()
+    for i in range(count):
+        payload = os.urandom(size)
+        wire += len(encode_frame(host.seq, 1, payload))
+        host.send(1, payload)
+        frame = host.recv(timeout=2.0)
+        if frame is None or frame[2] != payload:
+            stop.set()
+            print("selftest FAILED: echo %d" % i)
+            return 1
+    elapsed = time.monotonic() - start
+    stop.set()
+    board.join()
+    os.close(master)
+    os.close(slave)
+
+    text = len(" ".join("%02x" % b for b in os.urandom(size)) + "\r\n")
+    print("selftest ok, %d frames of %d bytes echoed through a pty in %.2f s" % (count, size, elapsed))
+    print("payload efficiency: binary frame %.1f%%, printf hex text %.1f%%" % (
+        100.0 * count * size / wire, 100.0 * size / text))
+    print("decoder: frames %d, crc errors %d, cobs errors %d, lost %d" % (
+        host.decoder.frames, host.decoder.crc_errors, host.decoder.cobs_errors, host.decoder.lost))
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="COBS framed serial link")
+    parser.add_argument("--port", help="serial port to listen on")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--selftest", action="store_true", help="loop back through a pty on the host")
+    args = parser.parse_args()
+
+    if args.selftest:
+        sys.exit(selftest())
+    if not args.port:
+        parser.error("需要指定 --port 或 --selftest")
+
+    link = FrameLink.open_serial(args.port, args.baud)
+    try:
+        while True:
+            frame = link.recv()
+            if frame is not None:
+                seq, msg_type, payload = frame
+                print("seq %5d type %3d len %4d  %s" % (seq, msg_type, len(payload), payload[:32].hex()))
+    except KeyboardInterrupt:
+        pass
+    d = link.decoder
+    print("frames %d, crc errors %d, cobs errors %d, lost %d" % (d.frames, d.crc_errors, d.cobs_errors, d.lost))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,244 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+链接映射文件统计 (Linker Map Summary)
+
+功能描述:
+    解析 arm-none-eabi-ld 生成的 .map 文件(Makefile 中 -Wl,-Map=...),
+    统计各存储区域(FLASH/RAM/TCMRAM)的使用率和各输出段的大小,
+    并列出放入指定输出段(默认 .tcmram/.tcmram_bss/.stack)的符号及其来源文件。
+    代码布局报告按地址把每个函数归类为: SRAM(.fastcode)、零等待FLASH、带等待FLASH。
+
+使用方法:
+    1. 构建后直接查看:
+       make map
+       python map_summary.py build/gd32f4xx_project.map
+
+    2. 列出其它输出段的内容:
+       python map_summary.py build/gd32f4xx_project.map --section .data --section .bss
+
+    3. 只看区域汇总:
+       python map_summary.py build/gd32f4xx_project.map --no-detail
+
+    4. 代码布局报告(零等待区大小与链接脚本 __flash_nowait_size 一致):
+       python map_summary.py build/gd32f4xx_project.map --code --nowait-size 512K
+
+注意事项:
+    - 只统计分配到 MEMORY 区域内的段, 调试信息段(.debug_*, .comment 等)被忽略
+    - FLASH 使用量包含 .data/.tcmram 等段在 FLASH 中的加载镜像
+"""
+
+import argparse
+import re
+import sys
+
+DEFAULT_SECTIONS = [".tcmram", ".tcmram_bss", ".stack"]
+CODE_SECTIONS = [".text", ".fastcode", ".slowcode"]
+FLASH_ORIGIN = 0x08000000
+
+HEX = r"0x[0-9a-fA-F]+"
+RE_REGION = re.compile(r"^(\S+)\s+(%s)\s+(%s)" % (HEX, HEX))
+RE_OUTPUT = re.compile(r"^(\.\S+)(?:\s+(%s)\s+(%s)(?:\s+load address\s+(%s))?)?\s*$" % (HEX, HEX, HEX))
+RE_INPUT = re.compile(r"^ (\.\S+|COMMON)(?:\s+(%s)\s+(%s)\s+(.+))?\s*$" % (HEX, HEX))
+RE_ADDR_SIZE = re.compile(r"^\s+(%s)\s+(%s)(?:\s+(.+))?\s*$" % (HEX, HEX))
+RE_SYMBOL = re.compile(r"^\s+(%s)\s+([A-Za-z_][\w.$]*)\s*$" % HEX)
+
+
+class Section:
+    """一个输出段及其输入段"""
+
+    def __init__(self, name, addr, size, load):
+        self.name = name
+        self.addr = addr
+        self.size = size
+        self.load = load
+        self.inputs = []
+
+    def add_input(self, name, addr, size, obj):
+        self.inputs.append({"name": name, "addr": addr, "size": size, "obj": obj, "symbols": []})
+
+
+def parse_map(text):
+    """返回 (regions, sections), regions 为 [(name, origin, length)]"""
+    regions = []
+    sections = []
+    lines = text.splitlines()
+    i = 0
+
+    while i < len(lines) and not lines[i].startswith("Memory Configuration"):
+        i += 1
+    while i < len(lines) and not lines[i].startswith("Linker script and memory map"):
+        m = RE_REGION.match(lines[i])
+        if m and m.group(1) != "*default*":
+            regions.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+        i += 1
+
+    current = None
+    pending_output = None
+    pending_input = None
+    for line in lines[i:]:
+        if line.startswith("OUTPUT("):
+            break
+        if pending_output is not None:
+            m = RE_ADDR_SIZE.match(line)
+            if m:
+                load = re.search(r"load address\s+(%s)" % HEX, line)
+                current = Section(pending_output, int(m.group(1), 16), int(m.group(2), 16),
+                                  int(load.group(1), 16) if load else None)
+                sections.append(current)
+            pending_output = None
+            continue
+        if pending_input is not None:
+            m = RE_ADDR_SIZE.match(line)
+            if m and current is not None:
+                current.add_input(pending_input, int(m.group(1), 16), int(m.group(2), 16),
+                                  (m.group(3) or "").strip())
+            pending_input = None
+            continue
+
+        if line.startswith("."):
+            m = RE_OUTPUT.match(line)
+            if not m:
+                current = None
+                continue
+            if m.group(2) is None:
+                pending_output = m.group(1)
+                continue
+            current = Section(m.group(1), int(m.group(2), 16), int(m.group(3), 16),
+                              int(m.group(4), 16) if m.group(4) else None)
+            sections.append(current)
+            continue
+
+        if current is None:
+            continue
+        m = RE_INPUT.match(line)
+        if m:
+            if m.group(2) is None:
+                pending_input = m.group(1)
+            else:
+                current.add_input(m.group(1), int(m.group(2), 16), int(m.group(3), 16),
+                                  m.group(4).strip())
+            continue
+        m = RE_SYMBOL.match(line)
+        if m and current.inputs:
+            current.inputs[-1]["symbols"].append((int(m.group(1), 16), m.group(2)))
+
+    return regions, sections
+
+
+def region_of(regions, addr):
+    if addr is None:
+        return None
+    for name, origin, length in regions:
+        if origin <= addr < origin + length:
+            return name
+    return None
+
+
+def print_summary(regions, sections):
+    used = dict((name, 0) for name, _, _ in regions)
+    print("%-20s %-8s %10s %10s %-8s" % ("section", "region", "address", "size", "load"))
+    for sec in sections:
+        vma_region = region_of(regions, sec.addr)
+        if vma_region is None or sec.size == 0:
+            continue
+        used[vma_region] += sec.size
+        lma_region = region_of(regions, sec.load)
+        if lma_region is not None and lma_region != vma_region:
+            used[lma_region] += sec.size
+        print("%-20s %-8s 0x%08x %10d %-8s" % (sec.name, vma_region, sec.addr, sec.size,
+                                               lma_region or ""))
+
+    print()
+    print("%-10s %10s %10s %7s" % ("region", "used", "size", "usage"))
+    for name, _, length in regions:
+        print("%-10s %10d %10d %6.1f%%" % (name, used[name], length,
+                                           100.0 * used[name] / length if length else 0.0))
+
+
+def print_detail(sections, names):
+    for sec in sections:
+        if sec.name not in names:
+            continue
+        print("\n%s  0x%08x  %d bytes" % (sec.name, sec.addr, sec.size))
+        entries = [e for e in sec.inputs if e["size"]]
+        for entry in sorted(entries, key=lambda e: e["size"], reverse=True):
+            symbols = ", ".join(name for _, name in entry["symbols"]) or entry["name"]
+            obj = entry["obj"].split("/")[-1]
+            print("  %8d  %-24s %s" % (entry["size"], obj, symbols))
+
+
+def parse_size(text):
+    """解析 512K / 1M / 0x80000 形式的大小"""
+    text = text.strip().upper()
+    scale = 1
+    if text.endswith("K"):
+        scale, text = 1024, text[:-1]
+    elif text.endswith("M"):
+        scale, text = 1024 * 1024, text[:-1]
+    return int(text, 0) * scale
+
+
+def print_code(sections, nowait_size, limit):
+    """按执行位置列出函数"""
+    places = {"SRAM": [], "flash zero wait": [], "flash wait state": []}
+    for sec in sections:
+        if sec.name not in CODE_SECTIONS:
+            continue
+        for entry in sec.inputs:
+            if not entry["size"]:
+                continue
+            if sec.name == ".fastcode":
+                place = "SRAM"
+            elif entry["addr"] < FLASH_ORIGIN + nowait_size:
+                place = "flash zero wait"
+            else:
+                place = "flash wait state"
+            names = [name for _, name in entry["symbols"]] or [entry["name"]]
+            places[place].append((entry["size"], ", ".join(names), entry["obj"].split("/")[-1]))
+
+    print("\ncode placement (zero wait state flash: %dK)" % (nowait_size // 1024))
+    for place in ("SRAM", "flash zero wait", "flash wait state"):
+        items = sorted(places[place], reverse=True)
+        print("  %-18s %5d functions %8d bytes" % (place, len(items), sum(i[0] for i in items)))
+    for place in ("SRAM", "flash wait state"):
+        items = sorted(places[place], reverse=True)
+        if not items:
+            continue
+        print("\n%s" % place)
+        for size, names, obj in items[:limit]:
+            print("  %8d  %-24s %s" % (size, obj, names))
+        if len(items) > limit:
+            print("  ... %d more" % (len(items) - limit))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="summarize a GNU ld map file")
+    parser.add_argument("map", help="linker map file")
+    parser.add_argument("--section", action="append",
+                        help="output section to list (default: %s)" % " ".join(DEFAULT_SECTIONS))
+    parser.add_argument("--no-detail", action="store_true", help="only print the region summary")
+    parser.add_argument("--code", action="store_true", help="report where every function executes from")
+    parser.add_argument("--nowait-size", default="512K", help="zero wait state flash size (default 512K)")
+    parser.add_argument("--limit", type=int, default=40, help="functions listed per placement")
+    args = parser.parse_args()
+
+    try:
+        with open(args.map, "r", encoding="utf-8", errors="replace") as f:
+            text = f.read()
+    except OSError as e:
+        sys.exit("无法读取map文件: %s" % e)
+
+    regions, sections = parse_map(text)
+    if not regions:
+        sys.exit("map文件中未找到 Memory Configuration")
+
+    print_summary(regions, sections)
+    if not args.no_detail:
+        print_detail(sections, args.section or DEFAULT_SECTIONS)
+    if args.code:
+        print_code(sections, parse_size(args.nowait_size), args.limit)
+
+
+if __name__ == "__main__":
+    main()
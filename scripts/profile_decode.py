@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+DWT性能剖析数据解码 (Profile Dump Decoder)
+
+功能描述:
+    解码固件 profile_dump() 通过串口(EVAL_COM0)输出的二进制剖析数据,
+    打印每个区域的调用次数、最小/最大/平均周期数、独占周期数以及log2直方图。
+
+数据格式(小端, 与 Core/src/profile.c 中 profile_dump() 的注释一致):
+    header  u32 magic("PRF1"), u8 version, u8 regions, u8 buckets, u8 reserved,
+            u32 core clock, u32 overhead, u32 errors
+    region  u8 name length, name, u32 count, u32 min, u32 max, u64 total,
+            u64 self, u32 bucket mask, 每个置位bucket一个u32
+    trailer u16 Fletcher-16
+
+使用方法:
+    1. 从已抓取的文件解码:
+       python profile_decode.py capture.bin
+
+    2. 直接从串口读取(需要 pyserial):
+       python profile_decode.py --port /dev/ttyUSB0 --baud 115200
+
+注意事项:
+    - 输入流中可以混有printf文本, 脚本会自动搜索magic
+    - 校验失败时会给出提示但仍然打印解析结果
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = b"PRF1"
+VERSION = 1
+
+
+class DumpError(Exception):
+    """数据不完整或格式错误"""
+
+
+class Reader:
+    """带Fletcher-16校验的顺序读取器"""
+
+    def __init__(self, data, offset):
+        self.data = data
+        self.pos = offset
+        self.sum1 = 0
+        self.sum2 = 0
+
+    def take(self, size, checked=True):
+        if self.pos + size > len(self.data):
+            raise DumpError("数据不完整, 需要更多字节")
+        chunk = self.data[self.pos:self.pos + size]
+        self.pos += size
+        if checked:
+            for b in chunk:
+                self.sum1 = (self.sum1 + b) % 255
+                self.sum2 = (self.sum2 + self.sum1) % 255
+        return chunk
+
+    def unpack(self, fmt, checked=True):
+        return struct.unpack("<" + fmt, self.take(struct.calcsize("<" + fmt), checked))
+
+
+def decode(data, offset=0):
+    """从data[offset]开始解析一次dump, 返回(结果字典, 结束位置)"""
+    r = Reader(data, offset)
+    magic = r.take(4)
+    if magic != MAGIC:
+        raise DumpError("magic不匹配")
+    version, count, buckets, _ = r.unpack("BBBB")
+    if version != VERSION:
+        raise DumpError("不支持的版本 %d" % version)
+    clock, overhead, errors = r.unpack("III")
+
+    regions = []
+    for _ in range(count):
+        (name_len,) = r.unpack("B")
+        name = r.take(name_len).decode("utf-8", "replace")
+        n, cmin, cmax, total, self_cycles, mask = r.unpack("IIIQQI")
+        hist = [0] * buckets
+        for i in range(buckets):
+            if mask & (1 << i):
+                (hist[i],) = r.unpack("I")
+        regions.append({
+            "name": name, "count": n, "min": cmin if n else 0, "max": cmax,
+            "total": total, "self": self_cycles, "hist": hist,
+        })
+
+    expected = (r.sum2 << 8) | r.sum1
+    (check,) = r.unpack("H", checked=False)
+    return {
+        "clock": clock, "overhead": overhead, "errors": errors,
+        "regions": regions, "check_ok": check == expected,
+    }, r.pos
+
+
+def print_report(dump):
+    clock = dump["clock"] or 1
+    print("core clock %d Hz, begin/end overhead %d cycles, errors %d%s" % (
+        dump["clock"], dump["overhead"], dump["errors"],
+        "" if dump["check_ok"] else "  [校验失败]"))
+    print("%-24s %9s %10s %10s %10s %10s %12s" % (
+        "region", "count", "min", "mean", "max", "self%", "total(us)"))
+    for reg in sorted(dump["regions"], key=lambda x: x["total"], reverse=True):
+        mean = reg["total"] // reg["count"] if reg["count"] else 0
+        self_pct = 100.0 * reg["self"] / reg["total"] if reg["total"] else 0.0
+        print("%-24s %9d %10d %10d %10d %9.1f%% %12.1f" % (
+            reg["name"], reg["count"], reg["min"], mean, reg["max"], self_pct,
+            reg["total"] * 1e6 / clock))
+
+    for reg in dump["regions"]:
+        peak = max(reg["hist"]) if reg["hist"] else 0
+        if not peak:
+            continue
+        print("\n%s (cycles, log2 buckets)" % reg["name"])
+        for i, n in enumerate(reg["hist"]):
+            if n:
+                bar = "#" * max(1, n * 50 // peak)
+                print("  %10d-%-10d %9d %s" % (1 << i if i else 0, (1 << (i + 1)) - 1, n, bar))
+
+
+def read_port(port, baud):
+    try:
+        import serial
+    except ImportError:
+        sys.exit("读取串口需要 pyserial: pip install pyserial")
+    data = bytearray()
+    with serial.Serial(port, baud, timeout=2) as ser:
+        while True:
+            chunk = ser.read(4096)
+            if not chunk:
+                if MAGIC in data:
+                    break
+                continue
+            data += chunk
+    return bytes(data)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="decode profile_dump() output")
+    parser.add_argument("file", nargs="?", help="captured binary stream")
+    parser.add_argument("--port", help="serial port to read from")
+    parser.add_argument("--baud", type=int, default=115200)
+    args = parser.parse_args()
+
+    if args.port:
+        data = read_port(args.port, args.baud)
+    elif args.file:
+        with open(args.file, "rb") as f:
+            data = f.read()
+    else:
+        parser.error("需要指定文件或 --port")
+
+    pos = data.find(MAGIC)
+    found = False
+    while pos >= 0:
+        try:
+            dump, end = decode(data, pos)
+        except DumpError:
+            pos = data.find(MAGIC, pos + 1)
+            continue
+        found = True
+        print_report(dump)
+        print()
+        pos = data.find(MAGIC, end)
+    if not found:
+        sys.exit("未找到有效的profile dump")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,80 @@
+/*!
+    \file    bench_soft_timer.c
+    \brief   host benchmark of the soft_timer wheel, make bench-host
+*/
+
+#include "gd32f4xx.h"
+#include "soft_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_TIMERS_MAX                 4096U
+#define BENCH_TICKS                      100000U
+#define BENCH_RESTARTS                   1000000U
+
+uint32_t test_primask = 0U;
+
+static soft_timer_struct timers[BENCH_TIMERS_MAX];
+static uint64_t now = 0U;
+static uint32_t fired = 0U;
+
+static void on_fire(void *arg)
+{
+    (void)arg;
+    fired++;
+}
+
+static double seconds(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* per tick cost with n periodic timers and start/stop cost, both should not grow with n */
+static void bench(uint32_t n)
+{
+    uint32_t i;
+    double start, tick_ns, restart_ns;
+
+    srand(1U);
+    for(i = 0U; i < n; i++) {
+        soft_timer_init(&timers[i], on_fire, NULL, SOFT_TIMER_FLAG_ISR);
+        /* periods from 1 ms to about 10 s, a mix of level 0 to level 2 timers */
+        soft_timer_start(&timers[i], (uint32_t)rand() % 10000U, 1U + (uint32_t)rand() % 10000U);
+    }
+
+    fired = 0U;
+    start = seconds();
+    for(i = 0U; i < BENCH_TICKS; i++) {
+        now++;
+        soft_timer_process(now);
+    }
+    tick_ns = (seconds() - start) * 1e9 / BENCH_TICKS;
+
+    start = seconds();
+    for(i = 0U; i < BENCH_RESTARTS; i++) {
+        soft_timer_start(&timers[i % n], 1U + (i & 0xFFFU), 0U);
+    }
+    restart_ns = (seconds() - start) * 1e9 / BENCH_RESTARTS;
+
+    for(i = 0U; i < n; i++) {
+        soft_timer_stop(&timers[i]);
+    }
+    printf("%6u timers: %8.1f ns per tick (%.2f expiries per tick), %6.1f ns per restart\n",
+           n, tick_ns, (double)fired / BENCH_TICKS, restart_ns);
+}
+
+int main(void)
+{
+    uint32_t n;
+
+    soft_timer_process(now);
+    for(n = 16U; n <= BENCH_TIMERS_MAX; n *= 4U) {
+        bench(n);
+    }
+
+    return 0;
+}
@@ -0,0 +1,25 @@
+/*!
+    \file    console.h
+    \brief   host stand-in for the console, the test captures what would go to the USART
+*/
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "gd32f4xx.h"
+#include <stdint.h>
+
+typedef enum {
+    SERIAL_USART0 = 0
+} serial_port_enum;
+
+#define CONSOLE_PORT                     SERIAL_USART0
+
+/* bytes console_write() can accept right now */
+uint32_t console_free(void);
+/* reserve transmit space, fill it with serial_write_put() and close it with serial_write_end() */
+ErrStatus serial_write_begin(serial_port_enum port, uint32_t len, uint32_t *pos);
+uint32_t serial_write_put(serial_port_enum port, uint32_t pos, const void *data, uint32_t len);
+void serial_write_end(serial_port_enum port, uint32_t len);
+
+#endif /* CONSOLE_H */
@@ -0,0 +1,61 @@
+/*!
+    \file    gd32f4xx.h
+    \brief   host stand-in for the device header, only what the modules under test use
+*/
+
+#ifndef GD32F4XX_H
+#define GD32F4XX_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* PRIMASK of the single host "core", tests may set it to check save and restore */
+extern uint32_t test_primask;
+
+static inline uint32_t __get_PRIMASK(void)
+{
+    return test_primask;
+}
+
+static inline void __set_PRIMASK(uint32_t primask)
+{
+    test_primask = primask;
+}
+
+static inline void __disable_irq(void)
+{
+    test_primask = 1U;
+}
+
+static inline void __enable_irq(void)
+{
+    test_primask = 0U;
+}
+
+typedef enum {ERROR = 0, SUCCESS = !ERROR} ErrStatus;
+
+/* exclusive access always succeeds, the host tests run on one thread */
+static inline uint32_t __LDREXW(volatile uint32_t *addr)
+{
+    return *addr;
+}
+
+static inline uint32_t __STREXW(uint32_t value, volatile uint32_t *addr)
+{
+    *addr = value;
+    return 0U;
+}
+
+static inline void __CLREX(void)
+{
+}
+
+/* cycle counter, tests that use DWT define test_dwt and set CYCCNT */
+typedef struct {
+    volatile uint32_t CYCCNT;
+} test_dwt_struct;
+
+extern test_dwt_struct test_dwt;
+#define DWT                              (&test_dwt)
+
+#endif /* GD32F4XX_H */
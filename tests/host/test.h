@@ -0,0 +1,27 @@
+/*!
+    \file    test.h
+    \brief   minimal checks for the host unit tests, make test
+*/
+
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+
+static unsigned int test_failures = 0U;
+static unsigned int test_checks = 0U;
+
+/* record a failed condition with its location and keep going */
+#define TEST_CHECK(cond)                 do { \
+        test_checks++; \
+        if(!(cond)) { \
+            test_failures++; \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        } \
+    } while(0)
+
+/* print the summary, the exit status of main() */
+#define TEST_DONE(name)                  (printf("%s: %u checks, %u failed\n", (name), test_checks, test_failures), \
+                                          (0U == test_failures) ? 0 : 1)
+
+#endif /* TEST_H */
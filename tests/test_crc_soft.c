@@ -0,0 +1,98 @@
+/*!
+    \file    test_crc_soft.c
+    \brief   host test of the table driven CRCs, make test
+*/
+
+#include "crc_soft.h"
+#include "test.h"
+#include <string.h>
+
+static const char check_input[] = "123456789";
+static uint8_t block[1100];
+
+/* bit at a time CRC-32/MPEG-2 over words fed most significant bit first, like CRC_DATA */
+static uint32_t ref_word(uint32_t crc, const uint32_t *words, size_t num)
+{
+    size_t i;
+    uint32_t k;
+
+    for(i = 0U; i < num; i++) {
+        crc ^= words[i];
+        for(k = 0U; k < 32U; k++) {
+            crc = (0U != (crc & 0x80000000U)) ? ((crc << 1) ^ 0x04C11DB7U) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void test_check_values(void)
+{
+    size_t len = strlen(check_input);
+
+    TEST_CHECK(0xCBF43926U == crc_soft_zlib_bytewise(CRC_SOFT_ZLIB_INIT, check_input, len));
+    TEST_CHECK(0xCBF43926U == crc_soft_zlib_slice4(CRC_SOFT_ZLIB_INIT, check_input, len));
+    TEST_CHECK(0xCBF43926U == crc_soft_zlib_slice8(CRC_SOFT_ZLIB_INIT, check_input, len));
+    TEST_CHECK(0x0376E6E7U == crc_soft_mpeg2(CRC_SOFT_MPEG2_INIT, check_input, len));
+    TEST_CHECK(0x29B1U == crc_soft_ccitt(CRC_SOFT_CCITT_INIT, check_input, len));
+    TEST_CHECK(0x4B37U == crc_soft_modbus(CRC_SOFT_MODBUS_INIT, check_input, len));
+
+    /* the previous result continues a checksum */
+    TEST_CHECK(0xCBF43926U == crc_soft_zlib_slice8(crc_soft_zlib_slice8(CRC_SOFT_ZLIB_INIT, check_input, 4U),
+                                                   &check_input[4], len - 4U));
+    TEST_CHECK(0x0376E6E7U == crc_soft_mpeg2(crc_soft_mpeg2(CRC_SOFT_MPEG2_INIT, check_input, 5U),
+                                             &check_input[5], len - 5U));
+}
+
+static void test_slices(void)
+{
+    uint32_t offset, len, ref, failures = 0U;
+
+    /* every alignment and the lengths around the 4 and 8 byte steps */
+    for(offset = 0U; offset < 8U; offset++) {
+        for(len = 0U; len < 80U; len++) {
+            ref = crc_soft_zlib_bytewise(CRC_SOFT_ZLIB_INIT, &block[offset], len);
+            if(ref != crc_soft_zlib_slice4(CRC_SOFT_ZLIB_INIT, &block[offset], len)) {
+                failures++;
+            }
+            if(ref != crc_soft_zlib_slice8(CRC_SOFT_ZLIB_INIT, &block[offset], len)) {
+                failures++;
+            }
+        }
+        ref = crc_soft_zlib_bytewise(CRC_SOFT_ZLIB_INIT, &block[offset], 1021U);
+        TEST_CHECK(ref == crc_soft_zlib_slice4(CRC_SOFT_ZLIB_INIT, &block[offset], 1021U));
+        TEST_CHECK(ref == crc_soft_zlib_slice8(CRC_SOFT_ZLIB_INIT, &block[offset], 1021U));
+    }
+    TEST_CHECK(0U == failures);
+}
+
+static void test_word_order(void)
+{
+    uint32_t words[64];
+    uint32_t num, offset, failures = 0U;
+
+    for(offset = 0U; offset < 4U; offset++) {
+        memcpy(words, &block[offset], sizeof(words));
+        for(num = 0U; num <= 64U; num++) {
+            if(ref_word(CRC_SOFT_MPEG2_INIT, words, num) != crc_soft_word(CRC_SOFT_MPEG2_INIT, &block[offset], num)) {
+                failures++;
+            }
+        }
+    }
+    TEST_CHECK(0U == failures);
+}
+
+int main(void)
+{
+    uint32_t i, x = 1U;
+
+    crc_soft_init();
+    for(i = 0U; i < sizeof(block); i++) {
+        x = x * 1103515245U + 12345U;
+        block[i] = (uint8_t)(x >> 16);
+    }
+    test_check_values();
+    test_slices();
+    test_word_order();
+
+    return TEST_DONE("crc_soft");
+}
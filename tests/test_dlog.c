@@ -0,0 +1,186 @@
+/*!
+    \file    test_dlog.c
+    \brief   host test of the deferred log records, make test
+    \note    the captured console bytes are written next to the binary, make test
+             decodes them with scripts/dlog_decode.py and compares the text
+*/
+
+#include "gd32f4xx.h"
+#include "console.h"
+#include "dlog.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+uint32_t test_primask = 0U;
+test_dwt_struct test_dwt = {0U};
+
+/* what went to the console, and the room it has left */
+static uint8_t capture[16384];
+static uint32_t captured = 0U;
+static uint32_t console_room = sizeof(capture);
+
+uint32_t console_free(void)
+{
+    return console_room;
+}
+
+ErrStatus serial_write_begin(serial_port_enum port, uint32_t len, uint32_t *pos)
+{
+    (void)port;
+    if(len > console_room) {
+        return ERROR;
+    }
+    console_room -= len;
+    *pos = captured;
+    captured += len;
+    return SUCCESS;
+}
+
+uint32_t serial_write_put(serial_port_enum port, uint32_t pos, const void *data, uint32_t len)
+{
+    (void)port;
+    memcpy(&capture[pos], data, len);
+    return pos + len;
+}
+
+void serial_write_end(serial_port_enum port, uint32_t len)
+{
+    (void)port;
+    (void)len;
+}
+
+/* printf text sharing the console with the records */
+static void console_text(const char *text)
+{
+    uint32_t pos, len = (uint32_t)strlen(text);
+
+    if(SUCCESS == serial_write_begin(CONSOLE_PORT, len, &pos)) {
+        serial_write_put(CONSOLE_PORT, pos, text, len);
+        serial_write_end(CONSOLE_PORT, len);
+    }
+}
+
+/* check one record of the capture, returns the offset after it */
+static uint32_t check_record(uint32_t offset, uint32_t seq, const char *fmt, uint32_t cycles,
+                             uint32_t nargs, const uint32_t *args)
+{
+    uint32_t word[3U + DLOG_MAX_ARGS];
+    uint32_t i;
+
+    memcpy(word, &capture[offset], (3U + nargs) * 4U);
+    TEST_CHECK(DLOG_SYNC == (word[0] & 0xFFU));
+    TEST_CHECK(nargs == ((word[0] >> 8) & 0xFFU));
+    TEST_CHECK(seq == (word[0] >> 16));
+    /* the id is the address of the format string in .dlog_fmt */
+    TEST_CHECK(0 == strcmp(fmt, (const char *)(uintptr_t)word[1]));
+    TEST_CHECK(cycles == word[2]);
+    for(i = 0U; i < nargs; i++) {
+        TEST_CHECK(args[i] == word[3U + i]);
+    }
+    return offset + (3U + nargs) * 4U;
+}
+
+static void test_layout(void)
+{
+    static const char usart[] = "USART0";
+    const uint32_t irq[] = {0xFFFFFFFEU, (uint32_t)(uintptr_t)usart};
+    const uint32_t eight[] = {1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U};
+    const uint32_t boot[] = {42U};
+    uint32_t temp = dlog_float_bits(21.5f);
+    uint32_t offset;
+
+    console_text("hello\n");
+    offset = captured;
+
+    test_dwt.CYCCNT = 100U;
+    DLOG("boot %u ms", 42U);
+    test_dwt.CYCCNT = 200U;
+    DLOG("irq %d on %s", -2, (uint32_t)(uintptr_t)usart);
+    test_dwt.CYCCNT = 300U;
+    DLOG("temp %.2f C", DLOG_FLOAT(21.5f));
+    test_dwt.CYCCNT = 400U;
+    DLOG("eight %u %u %u %u %u %u %u %u", 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U);
+    test_dwt.CYCCNT = 500U;
+    DLOG("plain");
+
+    /* only whole records leave: 15 bytes hold nothing, 20 hold the first record only */
+    console_room = 15U;
+    TEST_CHECK(0U == dlog_drain());
+    TEST_CHECK(offset == captured);
+    console_room = 20U;
+    TEST_CHECK(16U == dlog_drain());
+    TEST_CHECK(4U == console_room);
+    console_room = sizeof(capture) - captured;
+    TEST_CHECK((20U + 16U + 44U + 12U) == dlog_drain());
+
+    offset = check_record(offset, 0U, "boot %u ms", 100U, 1U, boot);
+    offset = check_record(offset, 1U, "irq %d on %s", 200U, 2U, irq);
+    offset = check_record(offset, 2U, "temp %.2f C", 300U, 1U, &temp);
+    offset = check_record(offset, 3U, "eight %u %u %u %u %u %u %u %u", 400U, 8U, eight);
+    offset = check_record(offset, 4U, "plain", 500U, 0U, NULL);
+    TEST_CHECK(offset == captured);
+}
+
+static void test_wrap(void)
+{
+    uint32_t i;
+
+    /* 16 and 20 byte records in turn, some of them straddle the end of the ring */
+    console_text("wrap\n");
+    for(i = 0U; i < 200U; i++) {
+        test_dwt.CYCCNT = 1000U + i;
+        if(0U != (i & 1U)) {
+            DLOG("odd %u %u", i, i * 3U);
+        } else {
+            DLOG("even %u", i);
+        }
+        if(9U == (i % 10U)) {
+            (void)dlog_drain();
+        }
+    }
+}
+
+static void test_overflow(void)
+{
+    dlog_stat_struct stat;
+    uint32_t i;
+
+    /* 44 byte records without draining, the 1024 byte ring keeps 23 of them */
+    console_text("overflow\n");
+    for(i = 0U; i < 30U; i++) {
+        test_dwt.CYCCNT = 2000U + i;
+        DLOG("full %u %u %u %u %u %u %u %u", i, i, i, i, i, i, i, i);
+    }
+    dlog_stat_get(&stat);
+    TEST_CHECK(7U == stat.dropped);
+    (void)dlog_drain();
+
+    /* the sequence skips the dropped records, the decoder reports the gap */
+    test_dwt.CYCCNT = 3000U;
+    DLOG("after %u", 30U);
+    TEST_CHECK(16U == dlog_drain());
+}
+
+int main(int argc, char *argv[])
+{
+    char path[256];
+    FILE *f;
+
+    (void)argc;
+    dlog_init();
+    test_layout();
+    test_wrap();
+    test_overflow();
+
+    /* the decoder reads the formats from this binary and the stream from here */
+    snprintf(path, sizeof(path), "%s.bin", argv[0]);
+    f = fopen(path, "wb");
+    TEST_CHECK(NULL != f);
+    if(NULL != f) {
+        TEST_CHECK(captured == fwrite(capture, 1U, captured, f));
+        fclose(f);
+    }
+
+    return TEST_DONE("dlog");
+}
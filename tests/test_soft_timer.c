@@ -0,0 +1,215 @@
+/*!
+    \file    test_soft_timer.c
+    \brief   host test of the soft_timer wheel, make test
+*/
+
+#include "gd32f4xx.h"
+#include "soft_timer.h"
+#include "test.h"
+
+uint32_t test_primask = 0U;
+
+/* tick the wheel has been processed up to, a timeout of t fires on tick now + 1 + t */
+static uint64_t now = 0U;
+
+typedef struct {
+    uint32_t count;                                                    /*!< callbacks run */
+    uint64_t last;                                                     /*!< tick of the last callback */
+} fired_struct;
+
+static void on_fire(void *arg)
+{
+    fired_struct *fired = (fired_struct *)arg;
+
+    fired->count++;
+    fired->last = now;
+}
+
+/* process ticks one by one like SysTick_Handler */
+static void advance(uint32_t ticks)
+{
+    while(ticks--) {
+        now++;
+        soft_timer_process(now);
+    }
+}
+
+/* process ticks in one call like the first tick after a tickless sleep */
+static void jump(uint32_t ticks)
+{
+    now += ticks;
+    soft_timer_process(now);
+}
+
+static void test_one_shot(void)
+{
+    soft_timer_struct timer;
+    fired_struct fired = {0U, 0U};
+    uint64_t start = now;
+
+    soft_timer_init(&timer, on_fire, &fired, SOFT_TIMER_FLAG_ISR);
+    soft_timer_start(&timer, 10U, 0U);
+    TEST_CHECK(soft_timer_active(&timer));
+    advance(10U);
+    TEST_CHECK(0U == fired.count);
+    advance(1U);
+    TEST_CHECK(1U == fired.count);
+    TEST_CHECK(start + 11U == fired.last);
+    TEST_CHECK(!soft_timer_active(&timer));
+    advance(100U);
+    TEST_CHECK(1U == fired.count);
+}
+
+static void test_periodic(void)
+{
+    soft_timer_struct timer;
+    fired_struct fired = {0U, 0U};
+    uint64_t start = now;
+
+    soft_timer_init(&timer, on_fire, &fired, SOFT_TIMER_FLAG_ISR);
+    soft_timer_start(&timer, 5U, 7U);
+    advance(6U + 7U * 99U);
+    TEST_CHECK(100U == fired.count);
+    TEST_CHECK(start + 6U + 7U * 99U == fired.last);
+    soft_timer_stop(&timer);
+    advance(50U);
+    TEST_CHECK(100U == fired.count);
+    TEST_CHECK(!soft_timer_active(&timer));
+}
+
+static void test_long_timeouts(void)
+{
+    static const uint32_t timeouts[] = {63U, 64U, 65U, 4095U, 4096U, 4097U, 300000U, SOFT_TIMER_MAX_TIMEOUT,
+                                        SOFT_TIMER_MAX_TIMEOUT + 12345U};
+    soft_timer_struct timer[sizeof(timeouts) / sizeof(timeouts[0])];
+    fired_struct fired[sizeof(timeouts) / sizeof(timeouts[0])];
+    uint64_t start = now;
+    uint32_t i, n = sizeof(timeouts) / sizeof(timeouts[0]);
+
+    for(i = 0U; i < n; i++) {
+        fired[i].count = 0U;
+        soft_timer_init(&timer[i], on_fire, &fired[i], SOFT_TIMER_FLAG_ISR);
+        soft_timer_start(&timer[i], timeouts[i], 0U);
+    }
+    /* cascades through every level, each timer fires exactly on its tick */
+    advance(SOFT_TIMER_MAX_TIMEOUT + 12346U);
+    for(i = 0U; i < n; i++) {
+        TEST_CHECK(1U == fired[i].count);
+        TEST_CHECK(start + 1U + timeouts[i] == fired[i].last);
+    }
+}
+
+static void test_tickless_catch_up(void)
+{
+    soft_timer_struct timer;
+    fired_struct fired = {0U, 0U};
+
+    soft_timer_init(&timer, on_fire, &fired, SOFT_TIMER_FLAG_ISR);
+    soft_timer_start(&timer, 100U, 10U);
+    /* the wheel must be idle up to the next cascade point or the first expiry */
+    TEST_CHECK(soft_timer_idle_ticks() >= 1U);
+    TEST_CHECK(soft_timer_idle_ticks() <= 100U);
+    jump(1000U);
+    /* every missed expiry is run on catch up */
+    TEST_CHECK(90U == fired.count);
+    soft_timer_stop(&timer);
+}
+
+static void test_deferred(void)
+{
+    soft_timer_struct a, b;
+    fired_struct fired_a = {0U, 0U}, fired_b = {0U, 0U};
+
+    soft_timer_init(&a, on_fire, &fired_a, SOFT_TIMER_FLAG_DEFERRED);
+    soft_timer_init(&b, on_fire, &fired_b, SOFT_TIMER_FLAG_DEFERRED);
+    soft_timer_start(&a, 3U, 0U);
+    soft_timer_start(&b, 3U, 0U);
+    advance(4U);
+    TEST_CHECK(0U == fired_a.count);
+    TEST_CHECK(0U == soft_timer_idle_ticks());
+
+    /* a stopped timer leaves the deferred list and its storage can be reused */
+    soft_timer_stop(&a);
+    soft_timer_init(&a, on_fire, &fired_a, SOFT_TIMER_FLAG_DEFERRED);
+    test_primask = 1U;
+    TEST_CHECK(1U == soft_timer_dispatch());
+    /* a caller with interrupts masked keeps them masked */
+    TEST_CHECK(1U == test_primask);
+    test_primask = 0U;
+    TEST_CHECK(0U == fired_a.count);
+    TEST_CHECK(1U == fired_b.count);
+    TEST_CHECK(0U == soft_timer_dispatch());
+
+    /* stopping the tail of the list keeps the list usable */
+    soft_timer_start(&a, 2U, 0U);
+    soft_timer_start(&b, 2U, 0U);
+    advance(3U);
+    soft_timer_stop(&b);
+    soft_timer_start(&b, 1U, 0U);
+    advance(2U);
+    TEST_CHECK(2U == soft_timer_dispatch());
+    TEST_CHECK(1U == fired_a.count);
+    TEST_CHECK(2U == fired_b.count);
+}
+
+static void test_deferred_middle(void)
+{
+    soft_timer_struct t[3];
+    fired_struct fired[3] = {{0U, 0U}, {0U, 0U}, {0U, 0U}};
+    uint32_t i;
+
+    for(i = 0U; i < 3U; i++) {
+        soft_timer_init(&t[i], on_fire, &fired[i], SOFT_TIMER_FLAG_DEFERRED);
+        soft_timer_start(&t[i], 1U, 0U);
+    }
+    advance(2U);
+
+    /* the middle entry unlinks without walking the list, both neighbours still run */
+    soft_timer_stop(&t[1]);
+    TEST_CHECK(2U == soft_timer_dispatch());
+    TEST_CHECK(1U == fired[0].count);
+    TEST_CHECK(0U == fired[1].count);
+    TEST_CHECK(1U == fired[2].count);
+
+    /* head and tail out of a list of three leave a list of one */
+    for(i = 0U; i < 3U; i++) {
+        soft_timer_start(&t[i], 1U, 0U);
+    }
+    advance(2U);
+    soft_timer_stop(&t[0]);
+    soft_timer_stop(&t[2]);
+    TEST_CHECK(1U == soft_timer_dispatch());
+    TEST_CHECK(1U == fired[1].count);
+    TEST_CHECK(0U == soft_timer_dispatch());
+}
+
+static void test_restart(void)
+{
+    soft_timer_struct timer;
+    fired_struct fired = {0U, 0U};
+    uint64_t start;
+
+    soft_timer_init(&timer, on_fire, &fired, SOFT_TIMER_FLAG_ISR);
+    soft_timer_start(&timer, 10U, 0U);
+    advance(5U);
+    start = now;
+    soft_timer_start(&timer, 20U, 0U);
+    advance(21U);
+    TEST_CHECK(1U == fired.count);
+    TEST_CHECK(start + 21U == fired.last);
+}
+
+int main(void)
+{
+    /* the wheel starts running at tick 0 */
+    soft_timer_process(now);
+    test_one_shot();
+    test_periodic();
+    test_long_timeouts();
+    test_tickless_catch_up();
+    test_deferred();
+    test_deferred_middle();
+    test_restart();
+
+    return TEST_DONE("soft_timer");
+}
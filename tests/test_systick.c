@@ -0,0 +1,56 @@
+/*!
+    \file    test_systick.c
+    \brief   host test of the deadline arithmetic in systick.h, make test
+*/
+
+#include "systick.h"
+#include "test.h"
+
+int main(void)
+{
+    uint64_t now, deadline;
+
+    /* plain deadlines */
+    deadline = systick_deadline_get(100U, 50U);
+    TEST_CHECK(150U == deadline);
+    TEST_CHECK(!systick_deadline_reached(149U, deadline));
+    TEST_CHECK(systick_deadline_reached(150U, deadline));
+    TEST_CHECK(systick_deadline_reached(151U, deadline));
+    TEST_CHECK(50U == systick_deadline_remaining(100U, deadline));
+    TEST_CHECK(1U == systick_deadline_remaining(149U, deadline));
+    TEST_CHECK(0U == systick_deadline_remaining(150U, deadline));
+    /* already passed deadlines clamp to 0 */
+    TEST_CHECK(0U == systick_deadline_remaining(1000U, deadline));
+
+    /* a zero timeout is reached at once */
+    TEST_CHECK(systick_deadline_reached(7U, systick_deadline_get(7U, 0U)));
+
+    /* deadline across the 64-bit wrap */
+    now = 0xFFFFFFFFFFFFFFF0ULL;
+    deadline = systick_deadline_get(now, 0x20U);
+    TEST_CHECK(0x10U == deadline);
+    TEST_CHECK(!systick_deadline_reached(now, deadline));
+    TEST_CHECK(!systick_deadline_reached(0xFFFFFFFFFFFFFFFFULL, deadline));
+    TEST_CHECK(!systick_deadline_reached(0x0FU, deadline));
+    TEST_CHECK(systick_deadline_reached(0x10U, deadline));
+    TEST_CHECK(0x20U == systick_deadline_remaining(now, deadline));
+    TEST_CHECK(0x11U == systick_deadline_remaining(0xFFFFFFFFFFFFFFFFULL, deadline));
+    TEST_CHECK(0U == systick_deadline_remaining(0x11U, deadline));
+
+    /* the longest timeout still fits */
+    deadline = systick_deadline_get(now, 0xFFFFFFFFU);
+    TEST_CHECK(0xFFFFFFFFU == systick_deadline_remaining(now, deadline));
+    TEST_CHECK(!systick_deadline_reached(now + 0xFFFFFFFEU, deadline));
+    TEST_CHECK(systick_deadline_reached(now + 0xFFFFFFFFU, deadline));
+
+    /* remaining ticks saturate to 32 bits */
+    TEST_CHECK(0xFFFFFFFFU == systick_deadline_remaining(0U, 0x100000000ULL));
+    TEST_CHECK(0xFFFFFFFFU == systick_deadline_remaining(0U, 0x7FFFFFFFFFFFFFFFULL));
+    TEST_CHECK(0xFFFFFFFFU == systick_deadline_remaining(now, now + 0x123456789ULL));
+
+    /* cycle counter differences wrap at 32 bits */
+    TEST_CHECK(0x20U == systick_cycle_elapsed(0xFFFFFFF0U, 0x10U));
+    TEST_CHECK(0U == systick_cycle_elapsed(5U, 5U));
+
+    return TEST_DONE("systick");
+}